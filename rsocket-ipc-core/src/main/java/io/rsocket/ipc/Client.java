@@ -23,13 +23,11 @@ import io.rsocket.RSocket;
 import io.rsocket.ipc.encoders.CompositeMetadataEncoder;
 import io.rsocket.ipc.encoders.PlainMetadataEncoder;
 import io.rsocket.ipc.metrics.Metrics;
-import io.rsocket.ipc.tracing.SimpleSpanContext;
+import io.rsocket.ipc.tracing.BinaryTraceContext;
 import io.rsocket.ipc.tracing.Tag;
 import io.rsocket.ipc.tracing.Tracing;
 import io.rsocket.util.ByteBufPayload;
 import java.nio.charset.Charset;
-import java.util.HashMap;
-import java.util.Map;
 import java.util.Objects;
 import java.util.function.Function;
 import org.reactivestreams.Publisher;
@@ -103,11 +101,11 @@ public final class Client<I, O> {
   }
 
   private <O>
-      Function<Map<String, String>, Function<? super Publisher<O>, ? extends Publisher<O>>> tracing(
+      Function<BinaryTraceContext, Function<? super Publisher<O>, ? extends Publisher<O>>> tracing(
           String route) {
     return tracer == null
-        ? Tracing.trace()
-        : Tracing.trace(
+        ? Tracing.traceContext()
+        : Tracing.traceContext(
             tracer,
             route,
             Tag.of("rsocket.service", service),
@@ -140,7 +138,7 @@ public final class Client<I, O> {
     Objects.requireNonNull(marshaller);
     Objects.requireNonNull(unmarshaller);
     Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics = metrics(route);
-    Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
+    Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
         tracing(route);
     return (o, byteBuf) ->
         doRequestResponse(
@@ -169,7 +167,7 @@ public final class Client<I, O> {
       String route, Marshaller<X> marshaller, Unmarshaller<Y> unmarshaller) {
     Objects.requireNonNull(route);
     Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics = metrics(route);
-    Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
+    Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
         tracing(route);
     return (publisher, byteBuf) ->
         doRequestChannel(
@@ -206,7 +204,7 @@ public final class Client<I, O> {
       String route, Marshaller<X> marshaller, Unmarshaller<Y> unmarshaller) {
     Objects.requireNonNull(route);
     Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics = metrics(route);
-    Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
+    Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>> tracing =
         tracing(route);
     return (o, byteBuf) ->
         doRequestStream(
@@ -224,7 +222,7 @@ public final class Client<I, O> {
   <X> Functions.FireAndForget<X> genericFireAndForget(String route, Marshaller<X> marshaller) {
     Objects.requireNonNull(route);
     Function<? super Publisher<Void>, ? extends Publisher<Void>> metrics = metrics(route);
-    Function<Map<String, String>, Function<? super Publisher<Void>, ? extends Publisher<Void>>>
+    Function<BinaryTraceContext, Function<? super Publisher<Void>, ? extends Publisher<Void>>>
         tracing = tracing(route);
     return (o, byteBuf) ->
         doFireAndForget(service, route, rSocket, marshaller, o, byteBuf, metrics, tracing);
@@ -309,15 +307,14 @@ public final class Client<I, O> {
       final X o,
       final ByteBuf metadata,
       Function<? super Publisher<Void>, ? extends Publisher<Void>> metrics,
-      Function<Map<String, String>, Function<? super Publisher<Void>, ? extends Publisher<Void>>>
+      Function<BinaryTraceContext, Function<? super Publisher<Void>, ? extends Publisher<Void>>>
           tracing) {
-    final HashMap<String, String> map = new HashMap<>();
+    final BinaryTraceContext traceContext = new BinaryTraceContext();
     return Mono.defer(
             () -> {
               try {
                 ByteBuf d = marshaller.apply(o);
-                ByteBuf m =
-                    metadataEncoder.encode(metadata, new SimpleSpanContext(map), service, route);
+                ByteBuf m = metadataEncoder.encode(metadata, traceContext, service, route);
                 metadata.release();
                 Payload payload = ByteBufPayload.create(d, m);
                 return r.fireAndForget(payload);
@@ -327,7 +324,7 @@ public final class Client<I, O> {
               }
             })
         .transform(metrics)
-        .transform(tracing.apply(map));
+        .transform(tracing.apply(traceContext));
   }
 
   private <X, Y> Mono<Y> doRequestResponse(
@@ -339,15 +336,14 @@ public final class Client<I, O> {
       final X o,
       final ByteBuf metadata,
       Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics,
-      Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
+      Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
           tracing) {
-    final HashMap<String, String> map = new HashMap<>();
+    final BinaryTraceContext traceContext = new BinaryTraceContext();
     return Mono.defer(
             () -> {
               try {
                 ByteBuf d = marshaller.apply(o);
-                ByteBuf m =
-                    metadataEncoder.encode(metadata, new SimpleSpanContext(map), service, route);
+                ByteBuf m = metadataEncoder.encode(metadata, traceContext, service, route);
                 metadata.release();
                 Payload payload = ByteBufPayload.create(d, m);
                 return r.requestResponse(payload);
@@ -365,7 +361,7 @@ public final class Client<I, O> {
               }
             })
         .transform(metrics)
-        .transform(tracing.apply(map));
+        .transform(tracing.apply(traceContext));
   }
 
   private <X, Y> Flux<Y> doRequestStream(
@@ -377,15 +373,14 @@ public final class Client<I, O> {
       final X o,
       final ByteBuf metadata,
       Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics,
-      Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
+      Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
           tracing) {
-    final HashMap<String, String> map = new HashMap<>();
+    final BinaryTraceContext traceContext = new BinaryTraceContext();
     return Flux.defer(
             () -> {
               try {
                 ByteBuf d = marshaller.apply(o);
-                ByteBuf m =
-                    metadataEncoder.encode(metadata, new SimpleSpanContext(map), service, route);
+                ByteBuf m = metadataEncoder.encode(metadata, traceContext, service, route);
                 metadata.release();
                 Payload payload = ByteBufPayload.create(d, m);
                 return r.requestStream(payload);
@@ -403,7 +398,7 @@ public final class Client<I, O> {
               }
             })
         .transform(metrics)
-        .transform(tracing.apply(map));
+        .transform(tracing.apply(traceContext));
   }
 
   private <X, Y> Flux<Y> doRequestChannel(
@@ -415,11 +410,11 @@ public final class Client<I, O> {
       final Publisher<X> pub,
       final ByteBuf metadata,
       Function<? super Publisher<Y>, ? extends Publisher<Y>> metrics,
-      Function<Map<String, String>, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
+      Function<BinaryTraceContext, Function<? super Publisher<Y>, ? extends Publisher<Y>>>
           tracing) {
     try {
 
-      final HashMap<String, String> map = new HashMap<>();
+      final BinaryTraceContext traceContext = new BinaryTraceContext();
 
       Flux<Payload> input =
           Flux.from(pub)
@@ -432,9 +427,7 @@ public final class Client<I, O> {
                       ByteBuf d = marshaller.apply(o);
                       if (first) {
                         first = false;
-                        ByteBuf m =
-                            metadataEncoder.encode(
-                                metadata, new SimpleSpanContext(map), service, route);
+                        ByteBuf m = metadataEncoder.encode(metadata, traceContext, service, route);
                         metadata.release();
                         return ByteBufPayload.create(d, m);
                       }
@@ -453,7 +446,7 @@ public final class Client<I, O> {
                 }
               })
           .transform(metrics)
-          .transform(tracing.apply(map));
+          .transform(tracing.apply(traceContext));
 
     } catch (Throwable t) {
       return Flux.error(t);
@@ -17,6 +17,9 @@ package io.rsocket.ipc;
 
 import io.netty.buffer.ByteBuf;
 import io.opentracing.SpanContext;
+import io.rsocket.ipc.routing.Routes;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
 
 @FunctionalInterface
 public interface MetadataDecoder {
@@ -30,6 +33,35 @@ public interface MetadataDecoder {
 
     SpanContext spanContext();
 
+    /**
+     * Whether the request is to be traced. {@code false} only if the caller decided against it, in
+     * which case the server skips extracting the {@link #spanContext()} and creating a span.
+     */
+    default boolean isSampled() {
+      return true;
+    }
+
     boolean isComposite();
+
+    /**
+     * Hash of the UTF-8 encoded {@link #route()}, as computed by {@link Routes}. Decoders override
+     * it to hash the route bytes in place.
+     */
+    default int routeHash() {
+      String route = route();
+      return route == null ? Routes.EMPTY_HASH : Routes.hash(route);
+    }
+
+    /** Whether the UTF-8 encoded {@link #route()} equals the given bytes. */
+    default boolean routeEquals(byte[] route) {
+      String decoded = route();
+      return decoded != null && Arrays.equals(decoded.getBytes(StandardCharsets.UTF_8), route);
+    }
+
+    /**
+     * Returns this instance to the decoder that produced it. Decoded metadata is only valid until
+     * the handler the request was dispatched to returns, after which the server recycles it.
+     */
+    default void recycle() {}
   }
 }
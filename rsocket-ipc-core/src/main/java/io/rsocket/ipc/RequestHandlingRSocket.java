@@ -16,24 +16,28 @@
 package io.rsocket.ipc;
 
 import io.opentracing.Tracer;
-import io.rsocket.ipc.routing.SimpleRouter;
+import io.rsocket.ipc.routing.CopyOnWriteRouter;
 
 public class RequestHandlingRSocket extends RoutingServerRSocket {
 
   public RequestHandlingRSocket() {
-    super(new SimpleRouter());
+    super(new CopyOnWriteRouter());
   }
 
   public RequestHandlingRSocket(Tracer tracer) {
-    super(tracer, new SimpleRouter());
+    super(tracer, new CopyOnWriteRouter());
   }
 
   public RequestHandlingRSocket(MetadataDecoder decoder) {
-    super(decoder, new SimpleRouter());
+    super(decoder, new CopyOnWriteRouter());
   }
 
   public RequestHandlingRSocket withEndpoint(SelfRegistrable selfRegistrable) {
-    selfRegistrable.selfRegister((MutableRouter) router);
+    if (router instanceof CopyOnWriteRouter) {
+      ((CopyOnWriteRouter) router).withEndpoint(selfRegistrable);
+    } else {
+      selfRegistrable.selfRegister((MutableRouter) router);
+    }
     return this;
   }
 }
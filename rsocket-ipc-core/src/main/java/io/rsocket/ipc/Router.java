@@ -30,4 +30,24 @@ public interface Router {
   IPCFunction<Flux<Payload>> routeRequestStream(String route);
 
   IPCChannelFunction routeRequestChannel(String route);
+
+  /**
+   * Looks up the route of the decoded metadata. Routers able to match the encoded route bytes
+   * override these methods to avoid decoding the route to a {@link String}.
+   */
+  default IPCFunction<Mono<Void>> routeFireAndForget(MetadataDecoder.Metadata metadata) {
+    return routeFireAndForget(metadata.route());
+  }
+
+  default IPCFunction<Mono<Payload>> routeRequestResponse(MetadataDecoder.Metadata metadata) {
+    return routeRequestResponse(metadata.route());
+  }
+
+  default IPCFunction<Flux<Payload>> routeRequestStream(MetadataDecoder.Metadata metadata) {
+    return routeRequestStream(metadata.route());
+  }
+
+  default IPCChannelFunction routeRequestChannel(MetadataDecoder.Metadata metadata) {
+    return routeRequestChannel(metadata.route());
+  }
 }
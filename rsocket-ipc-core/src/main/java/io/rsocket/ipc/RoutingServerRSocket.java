@@ -46,14 +46,15 @@ public class RoutingServerRSocket implements RSocket {
 
   @Override
   public Mono<Void> fireAndForget(Payload payload) {
+    MetadataDecoder.Metadata decodedMetadata = null;
     try {
-      final MetadataDecoder.Metadata decodedMetadata = this.decoder.decode(payload.sliceMetadata());
+      decodedMetadata = this.decoder.decode(payload.sliceMetadata());
 
-      final String route = decodedMetadata.route();
-      final IPCFunction<Mono<Void>> monoIPCFunction = this.router.routeFireAndForget(route);
+      final IPCFunction<Mono<Void>> monoIPCFunction =
+          this.router.routeFireAndForget(decodedMetadata);
 
       if (monoIPCFunction == null) {
-        return Mono.error(new RouteNotFound("Nothing found for route " + route));
+        return Mono.error(new RouteNotFound("Nothing found for route " + decodedMetadata.route()));
       }
 
       final Mono<Void> response = monoIPCFunction.apply(payload, decodedMetadata);
@@ -64,19 +65,26 @@ public class RoutingServerRSocket implements RSocket {
     } catch (Throwable t) {
       payload.release();
       return Mono.error(t);
+    } finally {
+      // handlers read the metadata before they return, so it can be reused right away
+      if (decodedMetadata != null) {
+        decodedMetadata.recycle();
+      }
     }
   }
 
   @Override
   public Mono<Payload> requestResponse(Payload payload) {
+    MetadataDecoder.Metadata decodedMetadata = null;
     try {
-      final MetadataDecoder.Metadata decodedMetadata = this.decoder.decode(payload.sliceMetadata());
+      decodedMetadata = this.decoder.decode(payload.sliceMetadata());
 
-      final String route = decodedMetadata.route();
-      final IPCFunction<Mono<Payload>> monoIPCFunction = this.router.routeRequestResponse(route);
+      final IPCFunction<Mono<Payload>> monoIPCFunction =
+          this.router.routeRequestResponse(decodedMetadata);
 
       if (monoIPCFunction == null) {
-        return Mono.error(new NullPointerException("nothing found for route " + route));
+        return Mono.error(
+            new NullPointerException("nothing found for route " + decodedMetadata.route()));
       }
 
       final Mono<Payload> response = monoIPCFunction.apply(payload, decodedMetadata);
@@ -87,19 +95,24 @@ public class RoutingServerRSocket implements RSocket {
     } catch (Throwable t) {
       payload.release();
       return Mono.error(t);
+    } finally {
+      if (decodedMetadata != null) {
+        decodedMetadata.recycle();
+      }
     }
   }
 
   @Override
   public Flux<Payload> requestStream(Payload payload) {
+    MetadataDecoder.Metadata decodedMetadata = null;
     try {
-      final MetadataDecoder.Metadata decodedMetadata = this.decoder.decode(payload.sliceMetadata());
+      decodedMetadata = this.decoder.decode(payload.sliceMetadata());
 
-      final String route = decodedMetadata.route();
-      final IPCFunction<Flux<Payload>> ffContext = this.router.routeRequestStream(route);
+      final IPCFunction<Flux<Payload>> ffContext = this.router.routeRequestStream(decodedMetadata);
 
       if (ffContext == null) {
-        return Flux.error(new NullPointerException("nothing found for route " + route));
+        return Flux.error(
+            new NullPointerException("nothing found for route " + decodedMetadata.route()));
       }
 
       final Flux<Payload> response = ffContext.apply(payload, decodedMetadata);
@@ -110,6 +123,10 @@ public class RoutingServerRSocket implements RSocket {
     } catch (Throwable t) {
       payload.release();
       return Flux.error(t);
+    } finally {
+      if (decodedMetadata != null) {
+        decodedMetadata.recycle();
+      }
     }
   }
 
@@ -129,21 +146,26 @@ public class RoutingServerRSocket implements RSocket {
   }
 
   private Flux<Payload> doRequestChannel(Payload payload, Flux<Payload> payloadFlux) {
+    MetadataDecoder.Metadata decodedMetadata = null;
     try {
-      final MetadataDecoder.Metadata decodedMetadata = this.decoder.decode(payload.sliceMetadata());
+      decodedMetadata = this.decoder.decode(payload.sliceMetadata());
 
-      final String route = decodedMetadata.route();
-      final IPCChannelFunction ffContext = this.router.routeRequestChannel(route);
+      final IPCChannelFunction ffContext = this.router.routeRequestChannel(decodedMetadata);
 
       if (ffContext == null) {
         payload.release();
-        return Flux.error(new NullPointerException("nothing found for route " + route));
+        return Flux.error(
+            new NullPointerException("nothing found for route " + decodedMetadata.route()));
       }
 
       return ffContext.apply(payloadFlux, payload, decodedMetadata);
     } catch (Throwable t) {
       payload.release();
       return Flux.error(t);
+    } finally {
+      if (decodedMetadata != null) {
+        decodedMetadata.recycle();
+      }
     }
   }
 }
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.admission;
+
+import io.rsocket.Payload;
+import io.rsocket.exceptions.RejectedException;
+import java.time.Duration;
+import java.util.concurrent.Callable;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.atomic.AtomicLongFieldUpdater;
+import java.util.function.Function;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+import reactor.core.scheduler.Scheduler;
+
+/**
+ * Controlled delay admission for request-response and request-stream handlers. Handlers are
+ * subscribed on the given scheduler and the time a request waits there before its handler runs is
+ * its queue delay. While the smallest queue delay seen during an interval stays above the target,
+ * the queue is standing rather than absorbing a burst, and requests that waited more than twice the
+ * target are rejected without running. Rejections are {@link RejectedException}s carrying a
+ * retry-after hint, see {@link #retryAfterMillis(Throwable)}.
+ *
+ * <p>Requests admitted through {@link #mono(Payload, Callable)} and {@link #flux(Payload,
+ * Callable)} are parsed only once admitted, so a shed request costs neither its parse nor its
+ * handler.
+ *
+ * <p>Generated servers pick up the {@link #global() global} admission when they are constructed;
+ * without one every request is admitted on the calling thread.
+ */
+public final class CoDelAdmission {
+  public static final Duration DEFAULT_TARGET = Duration.ofMillis(5);
+  public static final Duration DEFAULT_INTERVAL = Duration.ofMillis(100);
+
+  private static final String RETRY_AFTER = "retry-after-ms=";
+
+  private static final AtomicLongFieldUpdater<CoDelAdmission> INTERVAL_END =
+      AtomicLongFieldUpdater.newUpdater(CoDelAdmission.class, "intervalEnd");
+
+  private static volatile CoDelAdmission global;
+
+  private final Scheduler scheduler;
+  private final long target;
+  private final long interval;
+
+  private volatile long intervalEnd;
+  // Updates of the minimum race, a lost one at worst delays the decision by an interval
+  private volatile long minDelay = Long.MAX_VALUE;
+  private volatile boolean overloaded;
+
+  public CoDelAdmission(Scheduler scheduler) {
+    this(scheduler, DEFAULT_TARGET, DEFAULT_INTERVAL);
+  }
+
+  public CoDelAdmission(Scheduler scheduler, Duration target, Duration interval) {
+    if (target.isNegative() || target.isZero() || interval.compareTo(target) < 0) {
+      throw new IllegalArgumentException(
+          "target must be positive and no longer than interval but was "
+              + target
+              + " and "
+              + interval);
+    }
+    this.scheduler = scheduler;
+    this.target = target.toNanos();
+    this.interval = interval.toNanos();
+    this.intervalEnd = System.nanoTime() + this.interval;
+  }
+
+  /** @return the installed admission, or {@code null} */
+  public static CoDelAdmission global() {
+    return global;
+  }
+
+  public static void setGlobal(CoDelAdmission admission) {
+    global = admission;
+  }
+
+  /**
+   * Subscribes to monos and fluxes through the admission.
+   *
+   * @param admission the admission, or {@code null} to admit everything as is
+   */
+  public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> admitted(
+      CoDelAdmission admission) {
+    if (admission == null) {
+      return Function.identity();
+    }
+    return admission::admit;
+  }
+
+  /**
+   * @return the delay the server asked for before new requests are sent, or -1 if the error is not
+   *     an admission rejection
+   */
+  public static long retryAfterMillis(Throwable t) {
+    if (!(t instanceof RejectedException)) {
+      return -1;
+    }
+    String message = t.getMessage();
+    int index = message == null ? -1 : message.lastIndexOf(RETRY_AFTER);
+    if (index < 0) {
+      return -1;
+    }
+    try {
+      return Long.parseLong(message.substring(index + RETRY_AFTER.length()));
+    } catch (NumberFormatException e) {
+      return -1;
+    }
+  }
+
+  /**
+   * Calls the handler of a request on the scheduler once the request is admitted. The payload is
+   * retained until the handler was called or the request was rejected or cancelled, so the caller
+   * may release it right away; the handler retains the payload itself if it needs it for longer.
+   */
+  public <R> Mono<R> mono(Payload payload, Callable<? extends Mono<? extends R>> handler) {
+    Runnable release = releaseOnce(payload);
+    return Mono.<R>defer(
+            () -> {
+              long enqueued = System.nanoTime();
+              return Mono.<R>defer(() -> Mono.from(handle(enqueued, handler, release)))
+                  .subscribeOn(scheduler);
+            })
+        .doFinally(signal -> release.run());
+  }
+
+  /** Like {@link #mono(Payload, Callable)} for handlers returning streams. */
+  public <R> Flux<R> flux(Payload payload, Callable<? extends Publisher<? extends R>> handler) {
+    Runnable release = releaseOnce(payload);
+    return Flux.<R>defer(
+            () -> {
+              long enqueued = System.nanoTime();
+              return Flux.<R>defer(() -> Flux.from(handle(enqueued, handler, release)))
+                  .subscribeOn(scheduler);
+            })
+        .doFinally(signal -> release.run());
+  }
+
+  private <R> Publisher<? extends R> handle(
+      long enqueued, Callable<? extends Publisher<? extends R>> handler, Runnable release) {
+    try {
+      if (!admit(enqueued)) {
+        return Mono.error(rejection());
+      }
+      return handler.call();
+    } catch (Exception e) {
+      return Mono.error(e);
+    } finally {
+      release.run();
+    }
+  }
+
+  private static Runnable releaseOnce(Payload payload) {
+    payload.retain();
+    AtomicBoolean released = new AtomicBoolean();
+    return () -> {
+      if (released.compareAndSet(false, true)) {
+        payload.release();
+      }
+    };
+  }
+
+  @SuppressWarnings("unchecked")
+  public <T> Publisher<T> admit(Publisher<T> source) {
+    if (source instanceof Mono) {
+      Mono<T> mono = (Mono<T>) source;
+      return Mono.defer(
+          () -> {
+            long enqueued = System.nanoTime();
+            return Mono.defer(() -> admit(enqueued) ? mono : Mono.<T>error(rejection()))
+                .subscribeOn(scheduler);
+          });
+    }
+    Flux<T> flux = Flux.from(source);
+    return Flux.defer(
+        () -> {
+          long enqueued = System.nanoTime();
+          return Flux.defer(() -> admit(enqueued) ? flux : Flux.<T>error(rejection()))
+              .subscribeOn(scheduler);
+        });
+  }
+
+  private boolean admit(long enqueued) {
+    long now = System.nanoTime();
+    return !isOverloaded(now - enqueued, now);
+  }
+
+  /** Records the queue delay of a request and decides whether it is shed. */
+  boolean isOverloaded(long delay, long now) {
+    long intervalEnd = this.intervalEnd;
+    if (now - intervalEnd > 0 && INTERVAL_END.compareAndSet(this, intervalEnd, now + interval)) {
+      long minDelay = this.minDelay;
+      // Nothing was recorded before the first interval ended
+      overloaded = minDelay > target && minDelay != Long.MAX_VALUE;
+      this.minDelay = delay;
+    } else if (delay < minDelay) {
+      minDelay = delay;
+    }
+    return overloaded && delay > 2 * target;
+  }
+
+  private RejectedException rejection() {
+    // The earliest the server can change its mind is at the end of the current interval
+    long remaining = Math.max(intervalEnd - System.nanoTime(), 0);
+    long millis = Math.max(TimeUnit.NANOSECONDS.toMillis(remaining + 999_999), 1);
+    return new RejectedException("server overloaded, " + RETRY_AFTER + millis);
+  }
+}
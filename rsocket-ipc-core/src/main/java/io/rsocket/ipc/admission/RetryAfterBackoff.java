@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.admission;
+
+import java.time.Duration;
+import java.util.concurrent.TimeUnit;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Holds back requests of a client after the server rejected one with a retry-after hint, see
+ * {@link CoDelAdmission}. The rejected request itself still fails, requests made until the hinted
+ * time are delayed rather than sent into an overloaded server.
+ */
+public final class RetryAfterBackoff {
+  private volatile long resumeAt = System.nanoTime();
+
+  @SuppressWarnings("unchecked")
+  public <T> Publisher<T> apply(Publisher<T> source) {
+    if (source instanceof Mono) {
+      Mono<T> mono = ((Mono<T>) source).doOnError(this::onError);
+      return Mono.defer(
+          () -> {
+            long wait = resumeAt - System.nanoTime();
+            return wait > 0 ? Mono.delay(Duration.ofNanos(wait)).then(mono) : mono;
+          });
+    }
+    Flux<T> flux = Flux.from(source).doOnError(this::onError);
+    return Flux.defer(
+        () -> {
+          long wait = resumeAt - System.nanoTime();
+          return wait > 0 ? Mono.delay(Duration.ofNanos(wait)).thenMany(flux) : flux;
+        });
+  }
+
+  void onError(Throwable t) {
+    long millis = CoDelAdmission.retryAfterMillis(t);
+    if (millis > 0) {
+      long resumeAt = System.nanoTime() + TimeUnit.MILLISECONDS.toNanos(millis);
+      // Concurrent rejections race, any of the hints is as good as the other
+      if (resumeAt - this.resumeAt > 0) {
+        this.resumeAt = resumeAt;
+      }
+    }
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.batch;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.rsocket.Payload;
+import io.rsocket.util.ByteBufPayload;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.function.Function;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Frames batches of request-response calls sent over a single channel. The requests carry no
+ * correlation: the first one carries the metadata of the whole batch and the server numbers them
+ * in the order they arrive. Every response carries the number of its request in its metadata, so
+ * the client can restore the request order or take responses as they complete.
+ */
+public final class Batches {
+  /** Requests of a batch the server handles at the same time. */
+  public static final int MAX_CONCURRENCY = 256;
+
+  private static final int INDEX_SIZE = Integer.BYTES;
+
+  private Batches() {}
+
+  /**
+   * Returns the request payloads of a batch, the first of which takes ownership of the metadata.
+   * Subscribe to them once.
+   */
+  public static <T> Flux<Payload> requests(
+      Publisher<T> messages, Function<? super T, ? extends ByteBuf> serializer, ByteBuf metadata) {
+    return Flux.defer(
+        () -> {
+          RequestEncoder<T> encoder = new RequestEncoder<>(serializer, metadata);
+          return Flux.from(messages).map(encoder).doFinally(signal -> encoder.release());
+        });
+  }
+
+  /**
+   * Calls the handler for every request of a batch, at most {@link #MAX_CONCURRENCY} at a time,
+   * and numbers the responses after their requests.
+   */
+  public static <T> Flux<Payload> serve(
+      Flux<T> requests, Function<? super T, ? extends Mono<Payload>> handler) {
+    return serve(requests, handler, MAX_CONCURRENCY);
+  }
+
+  public static <T> Flux<Payload> serve(
+      Flux<T> requests, Function<? super T, ? extends Mono<Payload>> handler, int concurrency) {
+    return Flux.defer(
+        () -> {
+          // flatMap calls the mapper one request at a time
+          int[] next = new int[1];
+          return requests.flatMap(
+              request -> {
+                int index = next[0]++;
+                return handler.apply(request).map(response -> numbered(response, index));
+              },
+              concurrency);
+        });
+  }
+
+  /**
+   * Decodes the responses of a batch with the given deserializer, which has to release them. With
+   * {@code ordered} responses are held back until those of all earlier requests were emitted.
+   */
+  public static <T> Flux<T> responses(
+      Flux<Payload> responses,
+      boolean ordered,
+      Function<? super Payload, ? extends T> deserializer) {
+    if (!ordered) {
+      return responses.map(deserializer);
+    }
+    return Flux.defer(
+        () -> {
+          Reorder<T> reorder = new Reorder<>(deserializer);
+          return responses.concatMapIterable(reorder);
+        });
+  }
+
+  /** @return the number of the request the response belongs to */
+  public static int index(Payload response) {
+    ByteBuf metadata = response.sliceMetadata();
+    return metadata.getInt(metadata.readerIndex());
+  }
+
+  static Payload numbered(Payload response, int index) {
+    try {
+      ByteBuf metadata = ByteBufAllocator.DEFAULT.buffer(INDEX_SIZE).writeInt(index);
+      return ByteBufPayload.create(response.sliceData().retain(), metadata);
+    } finally {
+      response.release();
+    }
+  }
+
+  private static final class RequestEncoder<T> implements Function<T, Payload> {
+    private final Function<? super T, ? extends ByteBuf> serializer;
+    private ByteBuf metadata;
+
+    RequestEncoder(Function<? super T, ? extends ByteBuf> serializer, ByteBuf metadata) {
+      this.serializer = serializer;
+      this.metadata = metadata;
+    }
+
+    @Override
+    public Payload apply(T message) {
+      ByteBuf data = serializer.apply(message);
+      ByteBuf metadata = this.metadata;
+      if (metadata == null) {
+        return ByteBufPayload.create(data);
+      }
+      this.metadata = null;
+      return ByteBufPayload.create(data, metadata);
+    }
+
+    // An empty or failed batch never sent its metadata
+    void release() {
+      ByteBuf metadata = this.metadata;
+      if (metadata != null) {
+        this.metadata = null;
+        metadata.release();
+      }
+    }
+  }
+
+  private static final class Reorder<T> implements Function<Payload, Iterable<T>> {
+    private final Function<? super Payload, ? extends T> deserializer;
+    private final Map<Integer, T> pending = new HashMap<>();
+    private int next;
+
+    Reorder(Function<? super Payload, ? extends T> deserializer) {
+      this.deserializer = deserializer;
+    }
+
+    @Override
+    public Iterable<T> apply(Payload payload) {
+      int index = index(payload);
+      T response = deserializer.apply(payload);
+      if (index != next) {
+        pending.put(index, response);
+        return Collections.emptyList();
+      }
+      next++;
+      if (pending.isEmpty()) {
+        return Collections.singletonList(response);
+      }
+      List<T> ready = new ArrayList<>();
+      ready.add(response);
+      for (T earlier; (earlier = pending.remove(next)) != null; next++) {
+        ready.add(earlier);
+      }
+      return ready;
+    }
+  }
+}
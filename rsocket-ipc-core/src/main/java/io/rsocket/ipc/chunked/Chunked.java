@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.chunked;
+
+import io.netty.buffer.ByteBuf;
+import java.util.Objects;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+
+/**
+ * A message whose chunked bytes field travels as a stream of buffers after it instead of inside
+ * it, see the {@code chunked_field} method option. The header is the message with that field left
+ * empty.
+ *
+ * <p>The buffers are handed over: whoever subscribes to {@link #data()} owns and releases them. On
+ * the receiving side the data can be subscribed to once and must be, or cancelled, so that the
+ * interaction completes.
+ */
+public final class Chunked<T> {
+  private final T header;
+  private final Flux<ByteBuf> data;
+
+  private Chunked(T header, Flux<ByteBuf> data) {
+    this.header = header;
+    this.data = data;
+  }
+
+  public static <T> Chunked<T> of(T header, Publisher<ByteBuf> data) {
+    return new Chunked<>(
+        Objects.requireNonNull(header, "header"), Flux.from(Objects.requireNonNull(data, "data")));
+  }
+
+  public T header() {
+    return header;
+  }
+
+  public Flux<ByteBuf> data() {
+    return data;
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.chunked;
+
+import io.netty.buffer.ByteBuf;
+import io.rsocket.Payload;
+import io.rsocket.util.ByteBufPayload;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.function.Function;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Frames a {@link Chunked} message: the first payload carries the serialized header and the
+ * metadata, every following payload at most {@link #MAX_CHUNK_SIZE} bytes of the data. Neither
+ * side ever holds more of the data than the chunks requested so far.
+ */
+public final class Chunks {
+  /** Data buffers larger than this are sent as several frames. */
+  public static final int MAX_CHUNK_SIZE = 64 * 1024;
+
+  private Chunks() {}
+
+  /** Returns the header payload followed by the data cut into chunks. */
+  public static Flux<Payload> encode(Payload header, Publisher<ByteBuf> data) {
+    return Flux.concat(
+        Mono.just(header),
+        Flux.from(data).concatMapIterable(Chunks::slice).map(ByteBufPayload::create));
+  }
+
+  /** Returns a function encoding the chunked messages of a response with the given serializer. */
+  public static <T> Function<Chunked<T>, Flux<Payload>> encoder(
+      Function<? super T, ? extends Payload> serializer) {
+    return chunked -> encode(serializer.apply(chunked.header()), chunked.data());
+  }
+
+  /**
+   * Decodes the first payload with the given deserializer, which has to release it, and hands the
+   * data of the following payloads on as they arrive.
+   */
+  public static <T> Mono<Chunked<T>> decode(
+      Publisher<Payload> payloads, Function<? super Payload, ? extends T> deserializer) {
+    return Flux.from(payloads)
+        .<Chunked<T>>switchOnFirst(
+            (signal, flux) -> {
+              Payload first = signal.get();
+              if (first == null) {
+                return flux.then(Mono.<Chunked<T>>empty());
+              }
+              T header = deserializer.apply(first);
+              return Mono.just(Chunked.of(header, data(flux.skip(1))));
+            },
+            // The data is subscribed to after the decoded message completed
+            false)
+        .singleOrEmpty();
+  }
+
+  /** Returns the data of the given payloads, which are released. */
+  public static Flux<ByteBuf> data(Flux<Payload> payloads) {
+    return payloads.map(
+        payload -> {
+          ByteBuf data = payload.data().retain();
+          payload.release();
+          return data;
+        });
+  }
+
+  static List<ByteBuf> slice(ByteBuf byteBuf) {
+    int readable = byteBuf.readableBytes();
+    if (readable == 0) {
+      byteBuf.release();
+      return Collections.emptyList();
+    }
+    if (readable <= MAX_CHUNK_SIZE) {
+      return Collections.singletonList(byteBuf);
+    }
+    List<ByteBuf> chunks = new ArrayList<>((readable + MAX_CHUNK_SIZE - 1) / MAX_CHUNK_SIZE);
+    try {
+      while (byteBuf.isReadable()) {
+        chunks.add(byteBuf.readRetainedSlice(Math.min(MAX_CHUNK_SIZE, byteBuf.readableBytes())));
+      }
+    } finally {
+      byteBuf.release();
+    }
+    return chunks;
+  }
+}
@@ -15,21 +15,17 @@
  */
 package io.rsocket.ipc.decoders;
 
-import static io.rsocket.ipc.frames.Metadata.canDecode;
-import static io.rsocket.ipc.frames.Metadata.getMetadata;
-import static io.rsocket.ipc.frames.Metadata.getMethod;
-import static io.rsocket.ipc.frames.Metadata.getService;
-import static io.rsocket.metadata.CompositeMetadataCodec.hasEntry;
-
 import io.netty.buffer.ByteBuf;
-import io.netty.buffer.Unpooled;
-import io.netty.util.CharsetUtil;
-import io.opentracing.SpanContext;
 import io.opentracing.Tracer;
 import io.rsocket.ipc.MetadataDecoder;
-import io.rsocket.ipc.tracing.Tracing;
 import io.rsocket.metadata.WellKnownMimeType;
 
+/**
+ * Decodes composite metadata, the legacy RSocket RPC metadata frame, or a plain route. The buffer
+ * is walked once with absolute indexes, its reader index is never touched, and the result is a
+ * pooled flyweight that has to be {@link Metadata#recycle() recycled} once the request has been
+ * dispatched.
+ */
 public class CompositeMetadataDecoder implements MetadataDecoder {
 
   static final int STREAM_METADATA_KNOWN_MASK = 0x80; // 1000 0000
@@ -52,187 +48,104 @@ public class CompositeMetadataDecoder implements MetadataDecoder {
   public Metadata decode(ByteBuf metadataByteBuf) {
 
     // TODO: fix that once Backward compatibility expire
-    Metadata compositeMetadata;
-    if ((compositeMetadata = resolveCompositeMetadata(metadataByteBuf)) != null) {
-      return compositeMetadata;
-    } else if (canDecode(metadataByteBuf)) {
-      return new DefaultMetadata(metadataByteBuf, tracer);
+    Metadata metadata;
+    if ((metadata = resolveCompositeMetadata(metadataByteBuf)) != null) {
+      return metadata;
+    } else if ((metadata = resolveDefaultMetadata(metadataByteBuf, tracer)) != null) {
+      return metadata;
     } else {
       // Here we probably got something from Spring-Messaging :D
-      return new PlainMetadata(metadataByteBuf);
-    }
-  }
-
-  private static final class PlainMetadata implements Metadata {
-    private final ByteBuf metadata;
-
-    private PlainMetadata(ByteBuf metadata) {
-      this.metadata = metadata;
-    }
-
-    @Override
-    public ByteBuf metadata() {
-      return Unpooled.EMPTY_BUFFER;
-    }
-
-    @Override
-    public String route() {
-      return metadata.toString(CharsetUtil.UTF_8);
-    }
-
-    @Override
-    public SpanContext spanContext() {
-      return null;
-    }
-
-    @Override
-    public boolean isComposite() {
-      return false;
+      return RecyclableMetadata.plain(metadataByteBuf);
     }
   }
 
-  private static final class DefaultMetadata implements Metadata {
-
-    private final ByteBuf metadata;
-    private final Tracer tracer;
-
-    private DefaultMetadata(ByteBuf metadata, Tracer tracer) {
-      this.metadata = metadata;
-      this.tracer = tracer;
-    }
+  /**
+   * @param compositeMetadata
+   * @return null or the composite {@link Metadata}
+   */
+  public static Metadata resolveCompositeMetadata(ByteBuf compositeMetadata) {
+    int index = 0;
+    int end = compositeMetadata.writerIndex();
 
-    @Override
-    public ByteBuf metadata() {
-      return getMetadata(metadata);
-    }
+    int firstRouteIndex = -1;
+    int firstRouteLength = -1;
+    while (index < end) {
+      byte mimeIdOrLength = compositeMetadata.getByte(index++);
+      if ((mimeIdOrLength & STREAM_METADATA_KNOWN_MASK) != STREAM_METADATA_KNOWN_MASK) {
+        // M flag unset, remaining 7 bits are the length of the mime
+        int mimeLength = Byte.toUnsignedInt(mimeIdOrLength) + 1;
+        if (end - index < mimeLength) {
+          return null;
+        }
+        index += mimeLength;
+      }
 
-    @Override
-    public String route() {
-      ByteBuf m = this.metadata;
-      String service = getService(m);
-      String method = getMethod(m);
+      // ensures the length medium can be read
+      if (end - index < 3) {
+        return null;
+      }
+      int metadataLength = compositeMetadata.getUnsignedMedium(index);
+      index += 3;
+      if (end - index < metadataLength) {
+        return null;
+      }
 
-      return service.isEmpty() ? method : (service + (method.isEmpty() ? "" : ("." + method)));
-    }
+      if (mimeIdOrLength < 0
+          && WellKnownMimeType.MESSAGE_RSOCKET_ROUTING.getIdentifier()
+              == (mimeIdOrLength & STREAM_METADATA_LENGTH_MASK)) {
+        firstRouteIndex = index + 1;
+        firstRouteLength = resolveFirstRouteLength(compositeMetadata, index, metadataLength);
 
-    @Override
-    public SpanContext spanContext() {
-      return Tracing.deserializeTracingMetadata(tracer, metadata);
+        // FIXME: so far there is no reason to iterate further. Need to be changed once
+        // Tracing Metadata appeared
+        break;
+      }
+      index += metadataLength;
     }
 
-    @Override
-    public boolean isComposite() {
-      return false;
-    }
+    return RecyclableMetadata.composite(compositeMetadata, firstRouteIndex, firstRouteLength);
   }
 
-  private static final class CompositeMetadata implements Metadata {
-
-    private final ByteBuf metadata;
-    private final int firstRouteIndex;
-    private final int firstRouteLength;
-
-    private CompositeMetadata(ByteBuf metadata, int firstRouteIndex, int firstRouteLength) {
-      this.metadata = metadata;
-      this.firstRouteIndex = firstRouteIndex;
-      this.firstRouteLength = firstRouteLength;
-    }
-
-    @Override
-    public final ByteBuf metadata() {
-      return metadata;
-    }
-
-    @Override
-    public final String route() {
-      int firstRouteIndex = this.firstRouteIndex;
-      int firstRouteLength = this.firstRouteLength;
+  /**
+   * Parses the offsets of the legacy metadata frame written by {@link
+   * io.rsocket.ipc.frames.Metadata#encode}, see {@link io.rsocket.ipc.frames.Metadata#canDecode}.
+   *
+   * @return null if the buffer does not hold a complete frame
+   */
+  static Metadata resolveDefaultMetadata(ByteBuf metadata, Tracer tracer) {
+    int readable = metadata.readableBytes();
+    int offset = Short.BYTES;
 
-      if (firstRouteIndex < 0 || firstRouteLength < 1) {
-        return null;
-      }
-      return metadata.toString(firstRouteIndex, firstRouteLength, CharsetUtil.UTF_8);
+    if (readable < offset + Short.BYTES) {
+      return null;
     }
+    int serviceLength = metadata.getShort(offset);
+    offset += Short.BYTES + serviceLength;
 
-    @Override
-    public final SpanContext spanContext() {
-      // FIXME: Figure out how to work with tracing metadata
+    if (readable < offset + Short.BYTES) {
       return null;
     }
+    int methodLength = metadata.getShort(offset);
+    offset += Short.BYTES + methodLength;
 
-    @Override
-    public final boolean isComposite() {
-      return true;
+    if (readable < offset + Short.BYTES) {
+      return null;
     }
-  }
-
-  /**
-   * @param compositeMetadata
-   * @return null or {@link CompositeMetadata}
-   */
-  public static Metadata resolveCompositeMetadata(ByteBuf compositeMetadata) {
-    compositeMetadata.markReaderIndex();
-    compositeMetadata.readerIndex(0);
-
-    int firstRouteIndex = -1;
-    int firstRouteLength = -1;
-    int ridx = 0;
-    while (hasEntry(compositeMetadata, ridx)) {
-      if (compositeMetadata.isReadable()) {
-        byte mimeIdOrLength = compositeMetadata.readByte();
-        if ((mimeIdOrLength & STREAM_METADATA_KNOWN_MASK) == STREAM_METADATA_KNOWN_MASK) {
-          // noop
-        } else {
-          // M flag unset, remaining 7 bits are the length of the mime
-          int mimeLength = Byte.toUnsignedInt(mimeIdOrLength) + 1;
-
-          if (compositeMetadata.isReadable(
-              mimeLength)) { // need to be able to read an extra mimeLength bytes
-            // here we need a way for the returned ByteBuf to differentiate between a
-            // 1-byte length mime type and a 1 byte encoded mime id, preferably without
-            // re-applying the byte mask. The easiest way is to include the initial byte
-            // and have further decoding ignore the first byte. 1 byte buffer == id, 2+ byte
-            // buffer == full mime string.
-            compositeMetadata.skipBytes(mimeLength);
-          } else {
-            compositeMetadata.resetReaderIndex();
-            return null;
-          }
-        }
+    int tracingLength = metadata.getShort(offset);
+    offset += Short.BYTES + tracingLength;
 
-        if (compositeMetadata.isReadable(3)) {
-          // ensures the length medium can be read
-          final int metadataLength = compositeMetadata.readUnsignedMedium();
-          if (compositeMetadata.isReadable(metadataLength)) {
-            if (mimeIdOrLength < 0
-                && WellKnownMimeType.MESSAGE_RSOCKET_ROUTING.getIdentifier()
-                    == (mimeIdOrLength & STREAM_METADATA_LENGTH_MASK)) {
-              int readerIndex = compositeMetadata.readerIndex();
-              int routeLength =
-                  resolveFirstRouteLength(compositeMetadata, readerIndex, metadataLength);
-              firstRouteIndex = readerIndex + 1;
-              firstRouteLength = routeLength;
-
-              // FIXME: so far there is no reason to iterate further. Need to be changed once
-              // Tracing Metadata appeared
-              break;
-            }
-
-            compositeMetadata.skipBytes(metadataLength);
-          } else {
-            compositeMetadata.resetReaderIndex();
-            return null;
-          }
-        } else {
-          compositeMetadata.resetReaderIndex();
-          return null;
-        }
-      }
-      ridx = compositeMetadata.readerIndex();
+    if (readable < offset) {
+      return null;
     }
-
-    compositeMetadata.resetReaderIndex();
-    return new CompositeMetadata(compositeMetadata, firstRouteIndex, firstRouteLength);
+    return RecyclableMetadata.defaultMetadata(
+        metadata,
+        tracer,
+        io.rsocket.ipc.frames.Metadata.hasBinaryTracing(metadata),
+        io.rsocket.ipc.frames.Metadata.isSampled(metadata),
+        serviceLength,
+        methodLength,
+        tracingLength,
+        offset);
   }
 
   public static int resolveFirstRouteLength(ByteBuf metadata, int readerIndex, int metadataLength) {
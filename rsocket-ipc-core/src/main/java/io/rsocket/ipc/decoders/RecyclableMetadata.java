@@ -0,0 +1,252 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.decoders;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.Unpooled;
+import io.netty.util.CharsetUtil;
+import io.netty.util.Recycler;
+import io.opentracing.SpanContext;
+import io.opentracing.Tracer;
+import io.rsocket.ipc.MetadataDecoder;
+import io.rsocket.ipc.routing.Routes;
+import io.rsocket.ipc.tracing.BinaryTraceContext;
+import io.rsocket.ipc.tracing.Tracing;
+
+/**
+ * Flyweight over the metadata of a single request. The offsets of every section are parsed once by
+ * {@link CompositeMetadataDecoder}, and instances are pooled per thread, so decoding a request
+ * allocates nothing. An instance is only valid until {@link #recycle()} is called, which the
+ * server does as soon as the handler the request was dispatched to returns.
+ */
+final class RecyclableMetadata implements MetadataDecoder.Metadata {
+  static final int PLAIN = 0;
+  static final int DEFAULT = 1;
+  static final int COMPOSITE = 2;
+
+  private static final Recycler<RecyclableMetadata> RECYCLER =
+      new Recycler<RecyclableMetadata>() {
+        @Override
+        protected RecyclableMetadata newObject(Handle<RecyclableMetadata> handle) {
+          return new RecyclableMetadata(handle);
+        }
+      };
+
+  private final Recycler.Handle<RecyclableMetadata> handle;
+
+  private int kind;
+  private ByteBuf buffer;
+  private Tracer tracer;
+  private boolean binaryTracing;
+  private boolean sampled = true;
+  // Carrier the binary tracing section is read into, pooled along with the flyweight
+  private BinaryTraceContext traceContext;
+
+  // DEFAULT: offsets of the service and method names, the tracing and the user metadata.
+  // COMPOSITE: the first route is stored in the service fields.
+  private int serviceOffset;
+  private int serviceLength;
+  private int methodOffset;
+  private int methodLength;
+  private int tracingOffset;
+  private int tracingLength;
+  private int metadataOffset;
+  private int metadataLength;
+
+  private String route;
+
+  private RecyclableMetadata(Recycler.Handle<RecyclableMetadata> handle) {
+    this.handle = handle;
+  }
+
+  static RecyclableMetadata plain(ByteBuf buffer) {
+    RecyclableMetadata metadata = RECYCLER.get();
+    metadata.kind = PLAIN;
+    metadata.buffer = buffer;
+    return metadata;
+  }
+
+  static RecyclableMetadata composite(ByteBuf buffer, int routeOffset, int routeLength) {
+    RecyclableMetadata metadata = RECYCLER.get();
+    metadata.kind = COMPOSITE;
+    metadata.buffer = buffer;
+    metadata.serviceOffset = routeOffset;
+    metadata.serviceLength = routeLength;
+    return metadata;
+  }
+
+  static RecyclableMetadata defaultMetadata(
+      ByteBuf buffer,
+      Tracer tracer,
+      boolean binaryTracing,
+      boolean sampled,
+      int serviceLength,
+      int methodLength,
+      int tracingLength,
+      int metadataOffset) {
+    RecyclableMetadata metadata = RECYCLER.get();
+    metadata.kind = DEFAULT;
+    metadata.buffer = buffer;
+    metadata.tracer = tracer;
+    metadata.binaryTracing = binaryTracing;
+    metadata.sampled = sampled;
+    metadata.serviceOffset = Short.BYTES * 2;
+    metadata.serviceLength = serviceLength;
+    metadata.methodOffset = metadata.serviceOffset + serviceLength + Short.BYTES;
+    metadata.methodLength = methodLength;
+    metadata.tracingOffset = metadata.methodOffset + methodLength + Short.BYTES;
+    metadata.tracingLength = tracingLength;
+    metadata.metadataOffset = metadataOffset;
+    metadata.metadataLength = buffer.readableBytes() - metadataOffset;
+    return metadata;
+  }
+
+  @Override
+  public ByteBuf metadata() {
+    switch (kind) {
+      case DEFAULT:
+        return metadataLength > 0
+            ? buffer.slice(metadataOffset, metadataLength)
+            : Unpooled.EMPTY_BUFFER;
+      case COMPOSITE:
+        return buffer;
+      default:
+        return Unpooled.EMPTY_BUFFER;
+    }
+  }
+
+  @Override
+  public String route() {
+    String route = this.route;
+    if (route == null) {
+      route = decodeRoute();
+      this.route = route;
+    }
+    return route;
+  }
+
+  private String decodeRoute() {
+    switch (kind) {
+      case DEFAULT:
+        {
+          String service = buffer.toString(serviceOffset, serviceLength, CharsetUtil.UTF_8);
+          String method = buffer.toString(methodOffset, methodLength, CharsetUtil.UTF_8);
+          return service.isEmpty()
+              ? method
+              : (service + (method.isEmpty() ? "" : ("." + method)));
+        }
+      case COMPOSITE:
+        if (serviceOffset < 0 || serviceLength < 1) {
+          return null;
+        }
+        return buffer.toString(serviceOffset, serviceLength, CharsetUtil.UTF_8);
+      default:
+        return buffer.toString(CharsetUtil.UTF_8);
+    }
+  }
+
+  @Override
+  public int routeHash() {
+    switch (kind) {
+      case DEFAULT:
+        {
+          int hash = Routes.hash(buffer, serviceOffset, serviceLength);
+          if (serviceLength > 0 && methodLength > 0) {
+            hash = Routes.hash(hash, (byte) '.');
+          }
+          return Routes.hash(hash, buffer, methodOffset, methodLength);
+        }
+      case COMPOSITE:
+        if (serviceOffset < 0 || serviceLength < 1) {
+          return Routes.EMPTY_HASH;
+        }
+        return Routes.hash(buffer, serviceOffset, serviceLength);
+      default:
+        return Routes.hash(buffer, buffer.readerIndex(), buffer.readableBytes());
+    }
+  }
+
+  @Override
+  public boolean routeEquals(byte[] route) {
+    switch (kind) {
+      case DEFAULT:
+        // The route is "service.method", "service" or "method" depending on which of the two
+        // are empty, see decodeRoute()
+        if (serviceLength == 0 || methodLength == 0) {
+          return route.length == serviceLength + methodLength
+              && Routes.regionMatches(route, 0, buffer, serviceOffset, serviceLength)
+              && Routes.regionMatches(route, serviceLength, buffer, methodOffset, methodLength);
+        }
+        return route.length == serviceLength + 1 + methodLength
+            && route[serviceLength] == '.'
+            && Routes.regionMatches(route, 0, buffer, serviceOffset, serviceLength)
+            && Routes.regionMatches(route, serviceLength + 1, buffer, methodOffset, methodLength);
+      case COMPOSITE:
+        if (serviceOffset < 0 || serviceLength < 1) {
+          return false;
+        }
+        return route.length == serviceLength
+            && Routes.regionMatches(route, 0, buffer, serviceOffset, serviceLength);
+      default:
+        return route.length == buffer.readableBytes()
+            && Routes.regionMatches(
+                route, 0, buffer, buffer.readerIndex(), buffer.readableBytes());
+    }
+  }
+
+  @Override
+  public SpanContext spanContext() {
+    if (kind != DEFAULT || tracer == null) {
+      // FIXME: Figure out how to work with tracing metadata of composite metadata
+      return null;
+    }
+    if (binaryTracing) {
+      BinaryTraceContext traceContext = this.traceContext;
+      if (traceContext == null) {
+        traceContext = new BinaryTraceContext();
+        this.traceContext = traceContext;
+      }
+      return Tracing.deserializeBinaryTracing(
+          tracer, traceContext, buffer, tracingOffset, tracingLength);
+    }
+    return Tracing.deserializeTracing(
+        tracer,
+        tracingLength > 0 ? buffer.slice(tracingOffset, tracingLength) : Unpooled.EMPTY_BUFFER);
+  }
+
+  @Override
+  public boolean isSampled() {
+    return sampled;
+  }
+
+  @Override
+  public boolean isComposite() {
+    return kind == COMPOSITE;
+  }
+
+  @Override
+  public void recycle() {
+    buffer = null;
+    tracer = null;
+    binaryTracing = false;
+    sampled = true;
+    route = null;
+    if (traceContext != null) {
+      traceContext.reset();
+    }
+    handle.recycle(this);
+  }
+}
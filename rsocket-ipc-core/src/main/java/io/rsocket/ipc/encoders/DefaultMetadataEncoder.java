@@ -20,16 +20,36 @@ import io.netty.buffer.ByteBufAllocator;
 import io.opentracing.SpanContext;
 import io.rsocket.ipc.MetadataEncoder;
 import io.rsocket.ipc.frames.Metadata;
+import io.rsocket.ipc.tracing.BinaryTraceContext;
 import io.rsocket.ipc.tracing.Tracing;
-import java.util.HashMap;
-import java.util.Map;
 
+/**
+ * Encodes the routing metadata frame. Trace contexts are written as a text map by default, which
+ * every decoder reads. The binary layout of {@link BinaryTraceContext} is smaller and cheaper to
+ * write and read, but decoders that predate it misread it, so it has to be enabled explicitly once
+ * every receiving peer decodes it.
+ */
 public class DefaultMetadataEncoder implements MetadataEncoder {
 
   final ByteBufAllocator allocator;
+  final boolean binaryTracing;
+  final boolean propagateBaggage;
 
   public DefaultMetadataEncoder(ByteBufAllocator allocator) {
+    this(allocator, false, false);
+  }
+
+  /**
+   * @param binaryTracing whether a valid {@link BinaryTraceContext} is written in its binary
+   *     layout rather than as a text map
+   * @param propagateBaggage whether the baggage of a context written in the binary layout is sent
+   *     along with its ids. The text map always carries the baggage.
+   */
+  public DefaultMetadataEncoder(
+      ByteBufAllocator allocator, boolean binaryTracing, boolean propagateBaggage) {
     this.allocator = allocator;
+    this.binaryTracing = binaryTracing;
+    this.propagateBaggage = propagateBaggage;
   }
 
   @Override
@@ -40,16 +60,36 @@ public class DefaultMetadataEncoder implements MetadataEncoder {
           "Number of parts should be strictly equal to 1 but given [" + parts.length + "]");
     }
 
-    if (context != null) {
-      final HashMap<String, String> spanMap = new HashMap<>();
-      for (Map.Entry<String, String> item : context.baggageItems()) {
-        spanMap.put(item.getKey(), item.getValue());
+    if (context instanceof BinaryTraceContext) {
+      BinaryTraceContext traceContext = (BinaryTraceContext) context;
+      if (traceContext.isValid()) {
+        if (binaryTracing) {
+          return Metadata.encode(
+              allocator, baseRoute, parts[0], traceContext, propagateBaggage, metadata);
+        }
+        // The trace headers the context was parsed from, followed by the baggage
+        ByteBuf tracing = Tracing.textMapToByteBuf(allocator, traceContext);
+        return encode(baseRoute, parts[0], tracing, metadata);
+      }
+      if (traceContext.isNotSampled()) {
+        return Metadata.encodeNotSampled(allocator, baseRoute, parts[0], metadata);
       }
+    }
 
-      ByteBuf tracingMetadata = Tracing.mapToByteBuf(allocator, spanMap);
-      return Metadata.encode(allocator, baseRoute, parts[0], tracingMetadata, metadata);
+    // Either the tracer uses a propagation format BinaryTraceContext does not know, in which case
+    // everything it injected is in the baggage, or the context came from somewhere else
+    if (context != null) {
+      return encode(baseRoute, parts[0], Tracing.mapToByteBuf(allocator, context), metadata);
     }
 
     return Metadata.encode(allocator, baseRoute, parts[0], metadata);
   }
+
+  private ByteBuf encode(String service, String method, ByteBuf tracing, ByteBuf metadata) {
+    try {
+      return Metadata.encode(allocator, service, method, tracing, metadata);
+    } finally {
+      tracing.release();
+    }
+  }
 }
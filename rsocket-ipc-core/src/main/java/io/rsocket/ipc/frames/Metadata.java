@@ -19,25 +19,48 @@ import io.netty.buffer.ByteBuf;
 import io.netty.buffer.ByteBufAllocator;
 import io.netty.buffer.ByteBufUtil;
 import io.netty.buffer.Unpooled;
+import io.rsocket.ipc.tracing.BinaryTraceContext;
 import io.rsocket.util.NumberUtils;
 import java.nio.charset.StandardCharsets;
 
 public class Metadata {
   // Version
   public static final short VERSION = 1;
+  // Set in the version when the tracing section holds a BinaryTraceContext
+  public static final int BINARY_TRACING_FLAG = 0x8000;
+  // Set in the version when the caller decided not to sample the request, the tracing section is
+  // empty then
+  public static final int NOT_SAMPLED_FLAG = 0x4000;
 
   public static ByteBuf encode(
       ByteBufAllocator allocator, String service, String method, ByteBuf metadata) {
     return encode(allocator, service, method, Unpooled.EMPTY_BUFFER, metadata);
   }
 
+  /** Encodes the frame of a request the caller decided not to sample. */
+  public static ByteBuf encodeNotSampled(
+      ByteBufAllocator allocator, String service, String method, ByteBuf metadata) {
+    return encode(
+        allocator, VERSION | NOT_SAMPLED_FLAG, service, method, Unpooled.EMPTY_BUFFER, metadata);
+  }
+
   public static ByteBuf encode(
       ByteBufAllocator allocator,
       String service,
       String method,
       ByteBuf tracing,
       ByteBuf metadata) {
-    ByteBuf byteBuf = allocator.buffer().writeShort(VERSION);
+    return encode(allocator, VERSION, service, method, tracing, metadata);
+  }
+
+  private static ByteBuf encode(
+      ByteBufAllocator allocator,
+      int version,
+      String service,
+      String method,
+      ByteBuf tracing,
+      ByteBuf metadata) {
+    ByteBuf byteBuf = allocator.buffer().writeShort(version);
 
     int serviceLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(service));
     byteBuf.writeShort(serviceLength);
@@ -55,6 +78,37 @@ public class Metadata {
     return byteBuf;
   }
 
+  /**
+   * Encodes the frame with the trace context in its binary form, see {@link BinaryTraceContext}.
+   * The baggage is only written if asked for.
+   */
+  public static ByteBuf encode(
+      ByteBufAllocator allocator,
+      String service,
+      String method,
+      BinaryTraceContext tracing,
+      boolean includeBaggage,
+      ByteBuf metadata) {
+    ByteBuf byteBuf = allocator.buffer().writeShort(VERSION | BINARY_TRACING_FLAG);
+
+    int serviceLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(service));
+    byteBuf.writeShort(serviceLength);
+    ByteBufUtil.reserveAndWriteUtf8(byteBuf, service, serviceLength);
+
+    int methodLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(method));
+    byteBuf.writeShort(methodLength);
+    ByteBufUtil.reserveAndWriteUtf8(byteBuf, method, methodLength);
+
+    int tracingLengthIndex = byteBuf.writerIndex();
+    byteBuf.writeShort(0);
+    int tracingLength = tracing.writeTo(byteBuf, includeBaggage);
+    byteBuf.setShort(tracingLengthIndex, NumberUtils.requireUnsignedShort(tracingLength));
+
+    byteBuf.writeBytes(metadata, metadata.readerIndex(), metadata.readableBytes());
+
+    return byteBuf;
+  }
+
   public static boolean canDecode(ByteBuf byteBuf) {
     int offset = Short.BYTES;
 
@@ -80,7 +134,20 @@ public class Metadata {
   }
 
   public static int getVersion(ByteBuf byteBuf) {
-    return byteBuf.getShort(0) & 0x7FFF;
+    return byteBuf.getShort(0) & 0x3FFF;
+  }
+
+  /** Whether the tracing section holds a {@link BinaryTraceContext}. */
+  public static boolean hasBinaryTracing(ByteBuf byteBuf) {
+    return (byteBuf.getShort(0) & BINARY_TRACING_FLAG) != 0;
+  }
+
+  /**
+   * Whether the request is to be traced. Only a caller that decided against it clears this, so
+   * frames without any tracing section still count as sampled.
+   */
+  public static boolean isSampled(ByteBuf byteBuf) {
+    return (byteBuf.getShort(0) & NOT_SAMPLED_FLAG) == 0;
   }
 
   public static String getService(ByteBuf byteBuf) {
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.metrics;
+
+import java.util.concurrent.atomic.AtomicLongArray;
+
+/**
+ * Latency histogram of a single method. Buckets are laid out like in HdrHistogram: values below
+ * 32 get a bucket each, and every further power of two is split into 32 linear sub-buckets, which
+ * bounds the relative error to about 3%. Samples of 2^38 nanoseconds, about four and a half
+ * minutes, or more all land in the last bucket.
+ *
+ * <p>All buckets are allocated up front. Recording picks a stripe by thread id and only updates
+ * atomic longs, so it never allocates and threads rarely contend on the same cache lines.
+ */
+public final class LatencyHistogram {
+  static final int SUB_BUCKET_BITS = 5;
+  static final int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static final int MAX_EXPONENT = 38;
+  static final int BUCKETS = SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 1);
+
+  // Slots following the buckets in every stripe
+  private static final int SUM = BUCKETS;
+  private static final int MAX = BUCKETS + 1;
+  private static final int SLOTS = BUCKETS + 2;
+
+  private final String service;
+  private final String method;
+  private final String role;
+  private final AtomicLongArray[] stripes;
+  private final int mask;
+
+  LatencyHistogram(String service, String method, String role, int stripes) {
+    if (stripes < 1 || Integer.bitCount(stripes) != 1) {
+      throw new IllegalArgumentException("stripes must be a power of two, got " + stripes);
+    }
+    this.service = service;
+    this.method = method;
+    this.role = role;
+    this.stripes = new AtomicLongArray[stripes];
+    for (int i = 0; i < stripes; i++) {
+      this.stripes[i] = new AtomicLongArray(SLOTS);
+    }
+    this.mask = stripes - 1;
+  }
+
+  public String service() {
+    return service;
+  }
+
+  public String method() {
+    return method;
+  }
+
+  /** Either "client" or "server". */
+  public String role() {
+    return role;
+  }
+
+  public void recordNanos(long nanos) {
+    if (nanos < 0) {
+      nanos = 0;
+    }
+    AtomicLongArray stripe = stripes[(int) Thread.currentThread().getId() & mask];
+    stripe.getAndIncrement(index(nanos));
+    stripe.getAndAdd(SUM, nanos);
+    long max;
+    while (nanos > (max = stripe.get(MAX)) && !stripe.compareAndSet(MAX, max, nanos)) {}
+  }
+
+  /** Merges the stripes into a snapshot of everything recorded so far. */
+  public Snapshot snapshot() {
+    return snapshot(false);
+  }
+
+  /**
+   * Merges the stripes into a snapshot and clears them, so the next snapshot only covers what is
+   * recorded from now on. Samples recorded concurrently end up in exactly one of the two.
+   */
+  public Snapshot snapshotAndReset() {
+    return snapshot(true);
+  }
+
+  private Snapshot snapshot(boolean reset) {
+    long[] counts = new long[BUCKETS];
+    long count = 0;
+    long sum = 0;
+    long max = 0;
+    for (AtomicLongArray stripe : stripes) {
+      for (int i = 0; i < BUCKETS; i++) {
+        long c = reset ? stripe.getAndSet(i, 0) : stripe.get(i);
+        counts[i] += c;
+        count += c;
+      }
+      sum += reset ? stripe.getAndSet(SUM, 0) : stripe.get(SUM);
+      max = Math.max(max, reset ? stripe.getAndSet(MAX, 0) : stripe.get(MAX));
+    }
+    return new Snapshot(counts, count, sum, max);
+  }
+
+  static int index(long value) {
+    if (value < SUB_BUCKETS) {
+      return (int) value;
+    }
+    int shift = 63 - Long.numberOfLeadingZeros(value) - SUB_BUCKET_BITS;
+    if (shift > MAX_EXPONENT - SUB_BUCKET_BITS - 1) {
+      return BUCKETS - 1;
+    }
+    return SUB_BUCKETS + shift * SUB_BUCKETS + ((int) (value >>> shift) & (SUB_BUCKETS - 1));
+  }
+
+  /** The largest value that falls into the bucket. */
+  static long highestValue(int index) {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    long lowest = (long) (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lowest + (1L << shift) - 1;
+  }
+
+  @Override
+  public String toString() {
+    return "LatencyHistogram{" + role + ' ' + service + '.' + method + '}';
+  }
+
+  /** Merged, immutable view of a histogram. All values are in nanoseconds. */
+  public static final class Snapshot {
+    private final long[] counts;
+    private final long count;
+    private final long total;
+    private final long max;
+
+    Snapshot(long[] counts, long count, long total, long max) {
+      this.counts = counts;
+      this.count = count;
+      this.total = total;
+      this.max = max;
+    }
+
+    public long count() {
+      return count;
+    }
+
+    public long totalNanos() {
+      return total;
+    }
+
+    public long maxNanos() {
+      return max;
+    }
+
+    public double meanNanos() {
+      return count == 0 ? 0 : (double) total / count;
+    }
+
+    /**
+     * @param percentile between 0 and 1, e.g. 0.99
+     * @return the upper bound of the bucket holding the percentile, never more than the maximum
+     */
+    public long valueAtPercentile(double percentile) {
+      if (count == 0) {
+        return 0;
+      }
+      long rank = Math.max(1, (long) Math.ceil(percentile * count));
+      long seen = 0;
+      for (int i = 0; i < counts.length; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+          return Math.min(highestValue(i), max);
+        }
+      }
+      return max;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.metrics;
+
+import java.util.Collection;
+import java.util.Collections;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentMap;
+
+/**
+ * Holds one {@link LatencyHistogram} per method and role. Generated clients and servers look up
+ * their histograms from the {@link #global() global} recorder when they are constructed, so it has
+ * to be installed before; without one nothing is recorded.
+ */
+public final class LatencyRecorder {
+  private static volatile LatencyRecorder global;
+
+  private final ConcurrentMap<String, LatencyHistogram> histograms = new ConcurrentHashMap<>();
+  private final int stripes;
+
+  public LatencyRecorder() {
+    this(defaultStripes());
+  }
+
+  /** @param stripes number of stripes per histogram, a power of two */
+  public LatencyRecorder(int stripes) {
+    this.stripes = stripes;
+  }
+
+  /** @return the installed recorder, or {@code null} */
+  public static LatencyRecorder global() {
+    return global;
+  }
+
+  public static void setGlobal(LatencyRecorder recorder) {
+    global = recorder;
+  }
+
+  public LatencyHistogram histogram(String service, String method, String role) {
+    return histograms.computeIfAbsent(
+        role + ' ' + service + '.' + method,
+        key -> new LatencyHistogram(service, method, role, stripes));
+  }
+
+  public Collection<LatencyHistogram> histograms() {
+    return Collections.unmodifiableCollection(histograms.values());
+  }
+
+  // One stripe per core up to 8, more rarely pays off for the memory: each stripe is about 8KB
+  private static int defaultStripes() {
+    int processors = Math.min(8, Runtime.getRuntime().availableProcessors());
+    return Integer.highestOneBit(processors * 2 - 1);
+  }
+}
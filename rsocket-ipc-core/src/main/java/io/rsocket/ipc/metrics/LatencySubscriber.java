@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.metrics;
+
+import java.util.concurrent.atomic.AtomicBoolean;
+import org.reactivestreams.Subscription;
+import reactor.core.CoreSubscriber;
+import reactor.core.publisher.Operators;
+import reactor.util.context.Context;
+
+/** Records the time from subscription to termination or cancellation into a histogram. */
+class LatencySubscriber<T> extends AtomicBoolean implements Subscription, CoreSubscriber<T> {
+  private final CoreSubscriber<? super T> actual;
+  private final LatencyHistogram histogram;
+
+  private Subscription s;
+  private long start;
+
+  LatencySubscriber(CoreSubscriber<? super T> actual, LatencyHistogram histogram) {
+    this.actual = actual;
+    this.histogram = histogram;
+  }
+
+  @Override
+  public void onSubscribe(Subscription s) {
+    if (Operators.validate(this.s, s)) {
+      this.s = s;
+      this.start = System.nanoTime();
+
+      actual.onSubscribe(this);
+    }
+  }
+
+  @Override
+  public void onNext(T t) {
+    actual.onNext(t);
+  }
+
+  @Override
+  public void onError(Throwable t) {
+    record();
+    actual.onError(t);
+  }
+
+  @Override
+  public void onComplete() {
+    record();
+    actual.onComplete();
+  }
+
+  @Override
+  public void request(long n) {
+    s.request(n);
+  }
+
+  @Override
+  public void cancel() {
+    record();
+    s.cancel();
+  }
+
+  @Override
+  public Context currentContext() {
+    return actual.currentContext();
+  }
+
+  private void record() {
+    if (compareAndSet(false, true)) {
+      histogram.recordNanos(System.nanoTime() - start);
+    }
+  }
+}
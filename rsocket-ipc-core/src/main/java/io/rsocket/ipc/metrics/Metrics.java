@@ -20,6 +20,7 @@ import io.micrometer.core.instrument.MeterRegistry;
 import io.micrometer.core.instrument.Tag;
 import io.micrometer.core.instrument.Tags;
 import io.micrometer.core.instrument.Timer;
+import io.rsocket.ipc.util.SharedFunctions;
 import java.util.function.Function;
 import org.reactivestreams.Publisher;
 import reactor.core.Fuseable;
@@ -33,6 +34,53 @@ public class Metrics {
     return timed(registry, name, Tags.of(keyValues));
   }
 
+  /**
+   * Like {@link #timed(MeterRegistry, String, String...)}, but the meters are registered when the
+   * first request goes through, and every caller with the same registry, name and tags gets the
+   * same function. Generated stubs use it so that instances constructed per connection add nothing
+   * per method.
+   */
+  public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> sharedTimed(
+      MeterRegistry registry, String name, String... keyValues) {
+    return SharedFunctions.lazy(
+        registry,
+        "timed " + name + ' ' + String.join(",", keyValues),
+        () -> timed(registry, name, keyValues));
+  }
+
+  /**
+   * Records the latency of every subscription into the recorder's histogram of the method.
+   *
+   * @param recorder the recorder, or {@code null} to record nothing
+   * @param role either "client" or "server"
+   */
+  public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> recorded(
+      LatencyRecorder recorder, String service, String method, String role) {
+    if (recorder == null) {
+      return Function.identity();
+    }
+    LatencyHistogram histogram = recorder.histogram(service, method, role);
+    return Operators.lift(
+        (scannable, subscriber) -> new LatencySubscriber<T>(subscriber, histogram));
+  }
+
+  /**
+   * Like {@link #recorded(LatencyRecorder, String, String, String)}, but built on first use and
+   * shared by every caller with the same recorder, service, method and role.
+   *
+   * @param recorder the recorder, or {@code null} to record nothing
+   */
+  public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> sharedRecorded(
+      LatencyRecorder recorder, String service, String method, String role) {
+    if (recorder == null) {
+      return Function.identity();
+    }
+    return SharedFunctions.lazy(
+        recorder,
+        "recorded " + role + ' ' + service + '.' + method,
+        () -> recorded(recorder, service, method, role));
+  }
+
   @SuppressWarnings("unchecked")
   public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> timed(
       MeterRegistry registry, String name, Iterable<Tag> tags) {
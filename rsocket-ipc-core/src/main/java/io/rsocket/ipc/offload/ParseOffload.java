@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.offload;
+
+import io.micrometer.core.instrument.FunctionCounter;
+import io.micrometer.core.instrument.MeterRegistry;
+import io.micrometer.core.instrument.binder.MeterBinder;
+import io.rsocket.Payload;
+import java.util.concurrent.Callable;
+import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.LongAdder;
+import java.util.function.Consumer;
+import java.util.function.Function;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+import reactor.core.publisher.SignalType;
+import reactor.core.scheduler.Scheduler;
+
+/**
+ * Moves the parsing of large requests off the thread that received them, usually a Netty event
+ * loop. Requests whose data is at least the threshold are parsed, and their handler called, on the
+ * given scheduler; responses the handler produces right away are serialized there as well. Smaller
+ * requests stay on the calling thread, where a hop would cost more than the parse.
+ *
+ * <p>Generated servers pick up the {@link #global() global} offload when they are constructed;
+ * without one every request is parsed inline. Bind the offload to a {@link MeterRegistry} to
+ * report how many requests took either path.
+ */
+public final class ParseOffload implements MeterBinder {
+  public static final int DEFAULT_THRESHOLD = 64 * 1024;
+
+  private static volatile ParseOffload global;
+
+  private final Scheduler scheduler;
+  private final int threshold;
+  private final LongAdder inline = new LongAdder();
+  private final LongAdder offloaded = new LongAdder();
+
+  public ParseOffload(Scheduler scheduler) {
+    this(scheduler, DEFAULT_THRESHOLD);
+  }
+
+  /** @param threshold size in bytes of the smallest request data that is offloaded */
+  public ParseOffload(Scheduler scheduler, int threshold) {
+    if (threshold < 0) {
+      throw new IllegalArgumentException("threshold must not be negative but was " + threshold);
+    }
+    this.scheduler = scheduler;
+    this.threshold = threshold;
+  }
+
+  /** @return the installed offload, or {@code null} */
+  public static ParseOffload global() {
+    return global;
+  }
+
+  public static void setGlobal(ParseOffload offload) {
+    global = offload;
+  }
+
+  /** Decides whether the payload is parsed on the scheduler and counts the decision. */
+  public boolean offloads(Payload payload) {
+    if (payload.data().readableBytes() >= threshold) {
+      offloaded.increment();
+      return true;
+    }
+    inline.increment();
+    return false;
+  }
+
+  /**
+   * Parses the payload on the scheduler and passes the message to the handler there. The payload
+   * is retained until the returned mono terminates or is cancelled, so the caller may release it
+   * right away and the handler may still read the payload's metadata.
+   */
+  public <T, R> Mono<R> mono(
+      Payload payload,
+      Callable<? extends T> parser,
+      Function<? super T, ? extends Mono<? extends R>> handler) {
+    Ownership ownership = new Ownership(payload);
+    return Mono.<T>fromCallable(() -> ownership.parse(parser))
+        .subscribeOn(scheduler)
+        .<R>flatMap(handler)
+        .doFinally(ownership);
+  }
+
+  /** Like {@link #mono(Payload, Callable, Function)} for handlers returning streams. */
+  public <T, R> Flux<R> flux(
+      Payload payload,
+      Callable<? extends T> parser,
+      Function<? super T, ? extends Publisher<? extends R>> handler) {
+    Ownership ownership = new Ownership(payload);
+    return Mono.<T>fromCallable(() -> ownership.parse(parser))
+        .subscribeOn(scheduler)
+        .<R>flatMapMany(handler)
+        .doFinally(ownership);
+  }
+
+  public long inlineCount() {
+    return inline.sum();
+  }
+
+  public long offloadedCount() {
+    return offloaded.sum();
+  }
+
+  /** @return the share of the requests seen so far that were offloaded, 0 before the first */
+  public double offloadedRatio() {
+    long offloaded = this.offloaded.sum();
+    long total = offloaded + inline.sum();
+    return total == 0 ? 0 : (double) offloaded / total;
+  }
+
+  @Override
+  public void bindTo(MeterRegistry registry) {
+    FunctionCounter.builder("rsocket.server.parse", inline, LongAdder::sum)
+        .description("Requests parsed on the thread that received them")
+        .tag("path", "inline")
+        .register(registry);
+    FunctionCounter.builder("rsocket.server.parse", offloaded, LongAdder::sum)
+        .description("Requests parsed on the offload scheduler")
+        .tag("path", "offloaded")
+        .register(registry);
+  }
+
+  /**
+   * Counts the references held on the payload, one for the returned publisher until it
+   * terminates and one for a parse in progress, and releases the payload when both are gone. A
+   * parse that starts after a cancellation is skipped.
+   */
+  private static final class Ownership extends AtomicInteger implements Consumer<SignalType> {
+    private final Payload payload;
+    private final AtomicBoolean terminated = new AtomicBoolean();
+
+    Ownership(Payload payload) {
+      super(1);
+      this.payload = payload;
+      payload.retain();
+    }
+
+    <T> T parse(Callable<? extends T> parser) throws Exception {
+      for (; ; ) {
+        int references = get();
+        if (references == 0) {
+          return null;
+        }
+        if (compareAndSet(references, references + 1)) {
+          break;
+        }
+      }
+      try {
+        return parser.call();
+      } finally {
+        release();
+      }
+    }
+
+    @Override
+    public void accept(SignalType signal) {
+      if (terminated.compareAndSet(false, true)) {
+        release();
+      }
+    }
+
+    private void release() {
+      if (decrementAndGet() == 0) {
+        payload.release();
+      }
+    }
+  }
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.percore;
+
+import java.util.Collection;
+import java.util.Collections;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.function.Supplier;
+
+/**
+ * One instance of a stateful helper, such as a cache or a counter, per {@link ThreadPerCore core}.
+ * Threads that are not cores get an instance each as well, so an instance is only ever updated by
+ * one thread and needs no synchronization for it. Aggregating over {@link #all()} from another
+ * thread reads instances while their cores update them.
+ */
+public final class PerCore<T> {
+  private final Collection<T> all = new ConcurrentLinkedQueue<>();
+  private final ThreadLocal<T> instances;
+
+  public PerCore(Supplier<? extends T> supplier) {
+    this.instances =
+        ThreadLocal.withInitial(
+            () -> {
+              T instance = supplier.get();
+              all.add(instance);
+              return instance;
+            });
+  }
+
+  /** @return the instance of the calling thread */
+  public T get() {
+    return instances.get();
+  }
+
+  /** @return every instance created so far */
+  public Collection<T> all() {
+    return Collections.unmodifiableCollection(all);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.percore;
+
+import java.util.concurrent.Executor;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.function.Function;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+import reactor.core.scheduler.Scheduler;
+import reactor.core.scheduler.Schedulers;
+
+/**
+ * Thread-per-core execution. Every event loop serving connections registers itself as a core from
+ * its own thread, e.g. when it accepts a connection. Requests arrive on the loop of their
+ * connection and generated servers call the handler there; with cores registered they also
+ * publish what the handler returns on that core, so responses are serialized and written by the
+ * loop that received the request even if the handler completes on another thread.
+ *
+ * <p>Nothing hops off the core on its own, leave the {@link
+ * io.rsocket.ipc.admission.CoDelAdmission admission} and {@link
+ * io.rsocket.ipc.offload.ParseOffload parse offload} uninstalled in this mode. State the handlers
+ * update on every request is best kept {@link PerCore per core}.
+ */
+public final class ThreadPerCore {
+  private static final ThreadLocal<Core> CURRENT = new ThreadLocal<>();
+  private static final AtomicInteger CORES = new AtomicInteger();
+
+  // Spares the thread local lookup until the first core registered
+  private static volatile boolean enabled;
+
+  private ThreadPerCore() {}
+
+  /**
+   * Registers the calling thread as a core whose tasks run on the given executor, usually the
+   * event loop the thread belongs to. Registering a thread again returns its core.
+   */
+  public static Core register(Executor executor) {
+    Core core = CURRENT.get();
+    if (core == null) {
+      core = new Core(CORES.getAndIncrement(), Thread.currentThread(), executor);
+      CURRENT.set(core);
+      enabled = true;
+    }
+    return core;
+  }
+
+  /** @return the core of the calling thread, or {@code null} */
+  public static Core current() {
+    return enabled ? CURRENT.get() : null;
+  }
+
+  /**
+   * Returns a function that publishes the signals of monos and fluxes on the core of the calling
+   * thread, or the identity if the thread is not a core.
+   */
+  @SuppressWarnings({"unchecked", "rawtypes"})
+  public static <T> Function<? super Publisher<T>, ? extends Publisher<T>> pinned() {
+    Core core = current();
+    if (core == null) {
+      return Function.identity();
+    }
+    return (Function) core.pin;
+  }
+
+  public static final class Core {
+    private final int index;
+    private final Thread thread;
+    private final Scheduler scheduler;
+    private final Function<Publisher<Object>, Publisher<Object>> pin;
+
+    private Core(int index, Thread thread, Executor executor) {
+      this.index = index;
+      this.thread = thread;
+      // Signals that already are on the core are passed on right away instead of queued behind
+      // the loop's other tasks
+      this.scheduler =
+          Schedulers.fromExecutor(
+              task -> {
+                if (Thread.currentThread() == thread) {
+                  task.run();
+                } else {
+                  executor.execute(task);
+                }
+              });
+      this.pin = this::pin;
+    }
+
+    /** @return the number of the core, counting registrations from 0 */
+    public int index() {
+      return index;
+    }
+
+    public Thread thread() {
+      return thread;
+    }
+
+    /** @return a scheduler running tasks on the core, inline when already called from it */
+    public Scheduler scheduler() {
+      return scheduler;
+    }
+
+    @SuppressWarnings("unchecked")
+    private <T> Publisher<T> pin(Publisher<T> source) {
+      if (source instanceof Mono) {
+        return ((Mono<T>) source).publishOn(scheduler);
+      }
+      return Flux.from(source).publishOn(scheduler);
+    }
+  }
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.routing;
+
+import io.rsocket.Payload;
+import io.rsocket.ipc.MetadataDecoder;
+import io.rsocket.ipc.MutableRouter;
+import io.rsocket.ipc.SelfRegistrable;
+import io.rsocket.ipc.util.IPCChannelFunction;
+import io.rsocket.ipc.util.IPCFunction;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.function.BiConsumer;
+import java.util.function.Predicate;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Router safe for adding and removing routes while requests are served. Every update publishes a
+ * new immutable snapshot of the routing tables, so lookups never lock, and routes are matched
+ * against the UTF-8 bytes of the request metadata without decoding them to a {@link String}.
+ */
+public class CopyOnWriteRouter implements MutableRouter<CopyOnWriteRouter> {
+
+  private volatile Snapshot snapshot = Snapshot.EMPTY;
+
+  @Override
+  public IPCFunction<Mono<Void>> routeFireAndForget(String route) {
+    return snapshot.fireAndForget.get(route);
+  }
+
+  @Override
+  public IPCFunction<Mono<Payload>> routeRequestResponse(String route) {
+    return snapshot.requestResponse.get(route);
+  }
+
+  @Override
+  public IPCFunction<Flux<Payload>> routeRequestStream(String route) {
+    return snapshot.requestStream.get(route);
+  }
+
+  @Override
+  public IPCChannelFunction routeRequestChannel(String route) {
+    return snapshot.requestChannel.get(route);
+  }
+
+  @Override
+  public IPCFunction<Mono<Void>> routeFireAndForget(MetadataDecoder.Metadata metadata) {
+    return snapshot.fireAndForget.get(metadata);
+  }
+
+  @Override
+  public IPCFunction<Mono<Payload>> routeRequestResponse(MetadataDecoder.Metadata metadata) {
+    return snapshot.requestResponse.get(metadata);
+  }
+
+  @Override
+  public IPCFunction<Flux<Payload>> routeRequestStream(MetadataDecoder.Metadata metadata) {
+    return snapshot.requestStream.get(metadata);
+  }
+
+  @Override
+  public IPCChannelFunction routeRequestChannel(MetadataDecoder.Metadata metadata) {
+    return snapshot.requestChannel.get(metadata);
+  }
+
+  @Override
+  public synchronized CopyOnWriteRouter withFireAndForgetRoute(
+      String route, IPCFunction<Mono<Void>> function) {
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget.with(route, function),
+            s.requestResponse,
+            s.requestStream,
+            s.requestChannel);
+    return this;
+  }
+
+  @Override
+  public synchronized CopyOnWriteRouter withRequestResponseRoute(
+      String route, IPCFunction<Mono<Payload>> function) {
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget,
+            s.requestResponse.with(route, function),
+            s.requestStream,
+            s.requestChannel);
+    return this;
+  }
+
+  @Override
+  public synchronized CopyOnWriteRouter withRequestStreamRoute(
+      String route, IPCFunction<Flux<Payload>> function) {
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget,
+            s.requestResponse,
+            s.requestStream.with(route, function),
+            s.requestChannel);
+    return this;
+  }
+
+  @Override
+  public synchronized CopyOnWriteRouter withRequestChannelRoute(
+      String route, IPCChannelFunction function) {
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget,
+            s.requestResponse,
+            s.requestStream,
+            s.requestChannel.with(route, function));
+    return this;
+  }
+
+  /**
+   * Registers all routes of the endpoint and publishes them as one update, rather than copying the
+   * routing tables once per route.
+   */
+  public synchronized CopyOnWriteRouter withEndpoint(SelfRegistrable endpoint) {
+    Registration registration = new Registration();
+    endpoint.selfRegister(registration);
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget.with(registration.fireAndForget),
+            s.requestResponse.with(registration.requestResponse),
+            s.requestStream.with(registration.requestStream),
+            s.requestChannel.with(registration.requestChannel));
+    return this;
+  }
+
+  /** Removes the route from every interaction model. */
+  public CopyOnWriteRouter withoutRoute(String route) {
+    return without(route::equals);
+  }
+
+  /** Removes all routes of the service, i.e. the service name itself and {@code service.*}. */
+  public CopyOnWriteRouter withoutService(String service) {
+    String prefix = service + ".";
+    return without(route -> route.equals(service) || route.startsWith(prefix));
+  }
+
+  private synchronized CopyOnWriteRouter without(Predicate<String> removed) {
+    Snapshot s = snapshot;
+    snapshot =
+        new Snapshot(
+            s.fireAndForget.without(removed),
+            s.requestResponse.without(removed),
+            s.requestStream.without(removed),
+            s.requestChannel.without(removed));
+    return this;
+  }
+
+  public void forEachFireAndForgetRoute(BiConsumer<String, IPCFunction<Mono<Void>>> consumer) {
+    snapshot.fireAndForget.forEach(consumer);
+  }
+
+  public void forEachRequestResponseRoute(
+      BiConsumer<String, IPCFunction<Mono<Payload>>> consumer) {
+    snapshot.requestResponse.forEach(consumer);
+  }
+
+  public void forEachRequestStreamRoute(BiConsumer<String, IPCFunction<Flux<Payload>>> consumer) {
+    snapshot.requestStream.forEach(consumer);
+  }
+
+  public void forEachRequestChannelRoute(BiConsumer<String, IPCChannelFunction> consumer) {
+    snapshot.requestChannel.forEach(consumer);
+  }
+
+  /** Collects the routes of an endpoint, lookups see them on top of the published ones. */
+  private final class Registration implements MutableRouter<Registration> {
+    final Map<String, IPCFunction<Mono<Void>>> fireAndForget = new LinkedHashMap<>();
+    final Map<String, IPCFunction<Mono<Payload>>> requestResponse = new LinkedHashMap<>();
+    final Map<String, IPCFunction<Flux<Payload>>> requestStream = new LinkedHashMap<>();
+    final Map<String, IPCChannelFunction> requestChannel = new LinkedHashMap<>();
+
+    @Override
+    public IPCFunction<Mono<Void>> routeFireAndForget(String route) {
+      IPCFunction<Mono<Void>> function = fireAndForget.get(route);
+      return function != null ? function : CopyOnWriteRouter.this.routeFireAndForget(route);
+    }
+
+    @Override
+    public IPCFunction<Mono<Payload>> routeRequestResponse(String route) {
+      IPCFunction<Mono<Payload>> function = requestResponse.get(route);
+      return function != null ? function : CopyOnWriteRouter.this.routeRequestResponse(route);
+    }
+
+    @Override
+    public IPCFunction<Flux<Payload>> routeRequestStream(String route) {
+      IPCFunction<Flux<Payload>> function = requestStream.get(route);
+      return function != null ? function : CopyOnWriteRouter.this.routeRequestStream(route);
+    }
+
+    @Override
+    public IPCChannelFunction routeRequestChannel(String route) {
+      IPCChannelFunction function = requestChannel.get(route);
+      return function != null ? function : CopyOnWriteRouter.this.routeRequestChannel(route);
+    }
+
+    @Override
+    public Registration withFireAndForgetRoute(String route, IPCFunction<Mono<Void>> function) {
+      fireAndForget.put(route, function);
+      return this;
+    }
+
+    @Override
+    public Registration withRequestResponseRoute(
+        String route, IPCFunction<Mono<Payload>> function) {
+      requestResponse.put(route, function);
+      return this;
+    }
+
+    @Override
+    public Registration withRequestStreamRoute(String route, IPCFunction<Flux<Payload>> function) {
+      requestStream.put(route, function);
+      return this;
+    }
+
+    @Override
+    public Registration withRequestChannelRoute(String route, IPCChannelFunction function) {
+      requestChannel.put(route, function);
+      return this;
+    }
+  }
+
+  private static final class Snapshot {
+    static final Snapshot EMPTY =
+        new Snapshot(
+            RouteTable.empty(), RouteTable.empty(), RouteTable.empty(), RouteTable.empty());
+
+    final RouteTable<IPCFunction<Mono<Void>>> fireAndForget;
+    final RouteTable<IPCFunction<Mono<Payload>>> requestResponse;
+    final RouteTable<IPCFunction<Flux<Payload>>> requestStream;
+    final RouteTable<IPCChannelFunction> requestChannel;
+
+    Snapshot(
+        RouteTable<IPCFunction<Mono<Void>>> fireAndForget,
+        RouteTable<IPCFunction<Mono<Payload>>> requestResponse,
+        RouteTable<IPCFunction<Flux<Payload>>> requestStream,
+        RouteTable<IPCChannelFunction> requestChannel) {
+      this.fireAndForget = fireAndForget;
+      this.requestResponse = requestResponse;
+      this.requestStream = requestStream;
+      this.requestChannel = requestChannel;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.routing;
+
+import io.rsocket.ipc.MetadataDecoder;
+import java.util.LinkedHashMap;
+import java.util.Map;
+
+/**
+ * Numbers a fixed set of routes in the order they are given. Generated servers switch on the index
+ * of the route of a request, which is found by its hash and bytes straight from the metadata, so
+ * dispatching a request decodes no route.
+ */
+public final class RouteIndex {
+  private final RouteTable<Object> table;
+
+  public RouteIndex(String... routes) {
+    Map<String, Object> indexed = new LinkedHashMap<>();
+    for (String route : routes) {
+      if (indexed.put(route, route) != null) {
+        throw new IllegalArgumentException("duplicate route " + route);
+      }
+    }
+    this.table = RouteTable.empty().with(indexed);
+  }
+
+  /** @return the position of the route of the request among the routes, or -1 */
+  public int indexOf(MetadataDecoder.Metadata metadata) {
+    return table.indexOf(metadata);
+  }
+}
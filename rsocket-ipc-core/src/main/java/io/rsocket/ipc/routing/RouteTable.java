@@ -0,0 +1,217 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.routing;
+
+import io.rsocket.ipc.MetadataDecoder;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+import java.util.Map;
+import java.util.function.BiConsumer;
+import java.util.function.Predicate;
+
+/**
+ * Immutable open-addressing table from routes to handlers. Keys are kept both as {@link String}
+ * and as UTF-8 bytes, so a route can be looked up either by name or straight from the decoded
+ * metadata. Updates return a new table that reuses the encoded keys and hashes of this one, so
+ * every route is encoded once; {@link #with(Map)} adds many routes with a single copy.
+ */
+final class RouteTable<T> {
+  private static final RouteTable<?> EMPTY =
+      new RouteTable<>(new String[0], new byte[0][], new int[0], new Object[0]);
+
+  // Registration order, used to copy the table on updates
+  private final String[] routes;
+  private final byte[][] keys;
+  private final int[] hashes;
+  private final Object[] values;
+
+  private final int mask;
+  private final int[] slotHashes;
+  private final String[] slotRoutes;
+  private final byte[][] slotKeys;
+  private final Object[] slotValues;
+  private final int[] slotIndexes;
+
+  private RouteTable(String[] routes, byte[][] keys, int[] hashes, Object[] values) {
+    this.routes = routes;
+    this.keys = keys;
+    this.hashes = hashes;
+    this.values = values;
+
+    // keep the load factor at or below 0.5, so probing always reaches an empty slot
+    int capacity = Integer.highestOneBit(Math.max(routes.length, 1) * 2 - 1) << 1;
+    this.mask = capacity - 1;
+    this.slotHashes = new int[capacity];
+    this.slotRoutes = new String[capacity];
+    this.slotKeys = new byte[capacity][];
+    this.slotValues = new Object[capacity];
+    this.slotIndexes = new int[capacity];
+
+    for (int i = 0; i < routes.length; i++) {
+      int slot = index(hashes[i]);
+      while (slotKeys[slot] != null) {
+        slot = (slot + 1) & mask;
+      }
+      slotHashes[slot] = hashes[i];
+      slotRoutes[slot] = routes[i];
+      slotKeys[slot] = keys[i];
+      slotValues[slot] = values[i];
+      slotIndexes[slot] = i;
+    }
+  }
+
+  @SuppressWarnings("unchecked")
+  static <T> RouteTable<T> empty() {
+    return (RouteTable<T>) EMPTY;
+  }
+
+  @SuppressWarnings("unchecked")
+  T get(String route) {
+    if (route == null) {
+      return null;
+    }
+    int hash = Routes.hash(route);
+    for (int slot = index(hash); slotKeys[slot] != null; slot = (slot + 1) & mask) {
+      if (slotHashes[slot] == hash && slotRoutes[slot].equals(route)) {
+        return (T) slotValues[slot];
+      }
+    }
+    return null;
+  }
+
+  @SuppressWarnings("unchecked")
+  T get(MetadataDecoder.Metadata metadata) {
+    int hash = metadata.routeHash();
+    for (int slot = index(hash); slotKeys[slot] != null; slot = (slot + 1) & mask) {
+      if (slotHashes[slot] == hash && metadata.routeEquals(slotKeys[slot])) {
+        return (T) slotValues[slot];
+      }
+    }
+    return null;
+  }
+
+  /** @return the registration index of the route of the request, or -1 */
+  int indexOf(MetadataDecoder.Metadata metadata) {
+    int hash = metadata.routeHash();
+    for (int slot = index(hash); slotKeys[slot] != null; slot = (slot + 1) & mask) {
+      if (slotHashes[slot] == hash && metadata.routeEquals(slotKeys[slot])) {
+        return slotIndexes[slot];
+      }
+    }
+    return -1;
+  }
+
+  RouteTable<T> with(String route, T value) {
+    int i = indexOf(route);
+    if (i >= 0) {
+      Object[] newValues = values.clone();
+      newValues[i] = value;
+      return new RouteTable<>(routes, keys, hashes, newValues);
+    }
+    int size = routes.length;
+    String[] newRoutes = Arrays.copyOf(routes, size + 1);
+    byte[][] newKeys = Arrays.copyOf(keys, size + 1);
+    int[] newHashes = Arrays.copyOf(hashes, size + 1);
+    Object[] newValues = Arrays.copyOf(values, size + 1);
+    byte[] key = route.getBytes(StandardCharsets.UTF_8);
+    newRoutes[size] = route;
+    newKeys[size] = key;
+    newHashes[size] = Routes.hash(key);
+    newValues[size] = value;
+    return new RouteTable<>(newRoutes, newKeys, newHashes, newValues);
+  }
+
+  /** Adds or replaces all the given routes at once. */
+  RouteTable<T> with(Map<String, ? extends T> added) {
+    if (added.isEmpty()) {
+      return this;
+    }
+    int capacity = routes.length + added.size();
+    String[] newRoutes = Arrays.copyOf(routes, capacity);
+    byte[][] newKeys = Arrays.copyOf(keys, capacity);
+    int[] newHashes = Arrays.copyOf(hashes, capacity);
+    Object[] newValues = Arrays.copyOf(values, capacity);
+    int size = routes.length;
+    for (Map.Entry<String, ? extends T> entry : added.entrySet()) {
+      String route = entry.getKey();
+      int i = indexOf(route);
+      if (i >= 0) {
+        newValues[i] = entry.getValue();
+        continue;
+      }
+      byte[] key = route.getBytes(StandardCharsets.UTF_8);
+      newRoutes[size] = route;
+      newKeys[size] = key;
+      newHashes[size] = Routes.hash(key);
+      newValues[size] = entry.getValue();
+      size++;
+    }
+    if (size < capacity) {
+      newRoutes = Arrays.copyOf(newRoutes, size);
+      newKeys = Arrays.copyOf(newKeys, size);
+      newHashes = Arrays.copyOf(newHashes, size);
+      newValues = Arrays.copyOf(newValues, size);
+    }
+    return new RouteTable<>(newRoutes, newKeys, newHashes, newValues);
+  }
+
+  RouteTable<T> without(Predicate<String> removed) {
+    String[] newRoutes = new String[routes.length];
+    byte[][] newKeys = new byte[keys.length][];
+    int[] newHashes = new int[hashes.length];
+    Object[] newValues = new Object[values.length];
+    int size = 0;
+    for (int i = 0; i < routes.length; i++) {
+      if (!removed.test(routes[i])) {
+        newRoutes[size] = routes[i];
+        newKeys[size] = keys[i];
+        newHashes[size] = hashes[i];
+        newValues[size] = values[i];
+        size++;
+      }
+    }
+    if (size == routes.length) {
+      return this;
+    }
+    return new RouteTable<>(
+        Arrays.copyOf(newRoutes, size),
+        Arrays.copyOf(newKeys, size),
+        Arrays.copyOf(newHashes, size),
+        Arrays.copyOf(newValues, size));
+  }
+
+  @SuppressWarnings("unchecked")
+  void forEach(BiConsumer<String, T> consumer) {
+    for (int i = 0; i < routes.length; i++) {
+      consumer.accept(routes[i], (T) values[i]);
+    }
+  }
+
+  // Registration index of the route, or -1
+  private int indexOf(String route) {
+    int hash = Routes.hash(route);
+    for (int slot = index(hash); slotKeys[slot] != null; slot = (slot + 1) & mask) {
+      if (slotHashes[slot] == hash && slotRoutes[slot].equals(route)) {
+        return slotIndexes[slot];
+      }
+    }
+    return -1;
+  }
+
+  private int index(int hash) {
+    return (hash ^ (hash >>> 16)) & mask;
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.routing;
+
+import io.netty.buffer.ByteBuf;
+
+/**
+ * Hashing and comparison of routes by their UTF-8 bytes, so that a route can be looked up straight
+ * from the metadata buffer without decoding it to a {@link String}. Hashes are 32-bit FNV-1a over
+ * the UTF-8 encoding, and can be computed incrementally over several segments of a route.
+ */
+public final class Routes {
+  /** Hash of the empty route, the seed of incremental hashing. */
+  public static final int EMPTY_HASH = 0x811C9DC5;
+
+  private static final int PRIME = 0x01000193;
+
+  private Routes() {}
+
+  public static int hash(byte[] route) {
+    int hash = EMPTY_HASH;
+    for (byte b : route) {
+      hash = (hash ^ (b & 0xFF)) * PRIME;
+    }
+    return hash;
+  }
+
+  public static int hash(ByteBuf buffer, int index, int length) {
+    return hash(EMPTY_HASH, buffer, index, length);
+  }
+
+  /** Continues the hash of a route with the given bytes. */
+  public static int hash(int hash, ByteBuf buffer, int index, int length) {
+    for (int i = index, end = index + length; i < end; i++) {
+      hash = (hash ^ (buffer.getByte(i) & 0xFF)) * PRIME;
+    }
+    return hash;
+  }
+
+  /** Continues the hash of a route with a single byte. */
+  public static int hash(int hash, byte b) {
+    return (hash ^ (b & 0xFF)) * PRIME;
+  }
+
+  /** Hashes the UTF-8 encoding of the route without encoding it into a new array. */
+  public static int hash(CharSequence route) {
+    int hash = EMPTY_HASH;
+    for (int i = 0, length = route.length(); i < length; i++) {
+      char c = route.charAt(i);
+      if (c < 0x80) {
+        hash = hash(hash, (byte) c);
+      } else if (c < 0x800) {
+        hash = hash(hash, (byte) (0xC0 | (c >> 6)));
+        hash = hash(hash, (byte) (0x80 | (c & 0x3F)));
+      } else if (Character.isHighSurrogate(c)
+          && i + 1 < length
+          && Character.isLowSurrogate(route.charAt(i + 1))) {
+        int codePoint = Character.toCodePoint(c, route.charAt(++i));
+        hash = hash(hash, (byte) (0xF0 | (codePoint >> 18)));
+        hash = hash(hash, (byte) (0x80 | ((codePoint >> 12) & 0x3F)));
+        hash = hash(hash, (byte) (0x80 | ((codePoint >> 6) & 0x3F)));
+        hash = hash(hash, (byte) (0x80 | (codePoint & 0x3F)));
+      } else if (Character.isSurrogate(c)) {
+        // unpaired surrogates are encoded as '?', like String.getBytes does
+        hash = hash(hash, (byte) '?');
+      } else {
+        hash = hash(hash, (byte) (0xE0 | (c >> 12)));
+        hash = hash(hash, (byte) (0x80 | ((c >> 6) & 0x3F)));
+        hash = hash(hash, (byte) (0x80 | (c & 0x3F)));
+      }
+    }
+    return hash;
+  }
+
+  /**
+   * Compares a part of an encoded route with the bytes of the given buffer.
+   *
+   * @return true if {@code route[offset, offset + length)} equals {@code buffer[index, index +
+   *     length)}
+   */
+  public static boolean regionMatches(
+      byte[] route, int offset, ByteBuf buffer, int index, int length) {
+    if (offset + length > route.length) {
+      return false;
+    }
+    for (int i = 0; i < length; i++) {
+      if (route[offset + i] != buffer.getByte(index + i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
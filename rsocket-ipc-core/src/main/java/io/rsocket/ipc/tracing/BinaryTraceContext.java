@@ -0,0 +1,471 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.tracing;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufUtil;
+import io.netty.util.CharsetUtil;
+import io.opentracing.SpanContext;
+import io.opentracing.propagation.TextMap;
+import io.rsocket.util.NumberUtils;
+import java.util.AbstractMap;
+import java.util.Arrays;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.NoSuchElementException;
+
+/**
+ * A trace context in the binary layout of the W3C trace context: a version byte followed by the
+ * 16 byte trace id, the 8 byte span id and the trace flags, each prefixed with its field id, 29
+ * bytes in total. If asked for, the baggage follows as a compact section of length prefixed UTF-8
+ * keys and values.
+ *
+ * <p>The context doubles as the carrier tracers inject into. It understands the W3C {@code
+ * traceparent}, the B3 and the Jaeger headers and keeps every other entry as baggage; extracting
+ * from it yields the same headers again. Writing and reading the ids never allocates. An instance
+ * is mutable and belongs to a single request.
+ */
+public final class BinaryTraceContext implements SpanContext, TextMap {
+  public static final byte VERSION = 0;
+  /** Length of an encoded context without baggage. */
+  public static final int ENCODED_LENGTH = 29;
+  /** Trace flag set when the trace is sampled. */
+  public static final byte SAMPLED = 0x01;
+
+  static final byte TRACE_ID_FIELD = 0;
+  static final byte SPAN_ID_FIELD = 1;
+  static final byte TRACE_FLAGS_FIELD = 2;
+  static final byte BAGGAGE_FIELD = 3;
+
+  static final String TRACEPARENT = "traceparent";
+  static final String B3 = "b3";
+  static final String B3_TRACE_ID = "X-B3-TraceId";
+  static final String B3_SPAN_ID = "X-B3-SpanId";
+  static final String B3_PARENT_SPAN_ID = "X-B3-ParentSpanId";
+  static final String B3_SAMPLED = "X-B3-Sampled";
+  static final String B3_FLAGS = "X-B3-Flags";
+  static final String JAEGER = "uber-trace-id";
+
+  // Entries produced for the tracer ahead of the baggage, see entry(int)
+  private static final int TRACE_HEADERS = 5;
+  private static final String[] NO_BAGGAGE = new String[0];
+  private static final char[] HEX = "0123456789abcdef".toCharArray();
+
+  private long traceIdHigh;
+  private long traceIdLow;
+  private long spanId;
+  private byte flags;
+  // Set when the request was decided against sampling before any span was created
+  private boolean notSampled;
+
+  // Keys and values, interleaved
+  private String[] baggage = NO_BAGGAGE;
+  private int baggageSize;
+
+  public BinaryTraceContext set(long traceIdHigh, long traceIdLow, long spanId, byte flags) {
+    this.traceIdHigh = traceIdHigh;
+    this.traceIdLow = traceIdLow;
+    this.spanId = spanId;
+    this.flags = flags;
+    return this;
+  }
+
+  public long traceIdHigh() {
+    return traceIdHigh;
+  }
+
+  public long traceIdLow() {
+    return traceIdLow;
+  }
+
+  public long spanId() {
+    return spanId;
+  }
+
+  public byte flags() {
+    return flags;
+  }
+
+  public boolean isSampled() {
+    return (flags & SAMPLED) != 0;
+  }
+
+  /**
+   * Records that the request is not to be traced. The context then holds no ids, and the encoder
+   * only tells the server to skip tracing as well.
+   */
+  public BinaryTraceContext markNotSampled() {
+    this.notSampled = true;
+    return this;
+  }
+
+  public boolean isNotSampled() {
+    return notSampled;
+  }
+
+  /** Whether a trace and a span id are known, all zero ids are invalid. */
+  public boolean isValid() {
+    return (traceIdHigh != 0 || traceIdLow != 0) && spanId != 0;
+  }
+
+  public boolean hasBaggage() {
+    return baggageSize > 0;
+  }
+
+  /** Clears the ids and the baggage so the instance can be injected into or read again. */
+  public void reset() {
+    traceIdHigh = 0;
+    traceIdLow = 0;
+    spanId = 0;
+    flags = 0;
+    notSampled = false;
+    Arrays.fill(baggage, 0, baggageSize, null);
+    baggageSize = 0;
+  }
+
+  /**
+   * Writes the context at the writer index of the buffer.
+   *
+   * @return the number of bytes written
+   */
+  public int writeTo(ByteBuf byteBuf, boolean includeBaggage) {
+    int start = byteBuf.writerIndex();
+    byteBuf
+        .writeByte(VERSION)
+        .writeByte(TRACE_ID_FIELD)
+        .writeLong(traceIdHigh)
+        .writeLong(traceIdLow)
+        .writeByte(SPAN_ID_FIELD)
+        .writeLong(spanId)
+        .writeByte(TRACE_FLAGS_FIELD)
+        .writeByte(flags);
+
+    if (includeBaggage && baggageSize > 0) {
+      byteBuf.writeByte(BAGGAGE_FIELD);
+      for (int i = 0; i < baggageSize; i += 2) {
+        String key = baggage[i];
+        int keyLength = NumberUtils.requireUnsignedByte(ByteBufUtil.utf8Bytes(key));
+        byteBuf.writeByte(keyLength);
+        ByteBufUtil.reserveAndWriteUtf8(byteBuf, key, keyLength);
+
+        String value = baggage[i + 1];
+        int valueLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(value));
+        byteBuf.writeShort(valueLength);
+        ByteBufUtil.reserveAndWriteUtf8(byteBuf, value, valueLength);
+      }
+    }
+
+    return byteBuf.writerIndex() - start;
+  }
+
+  /**
+   * Reads a context written by {@link #writeTo} from the given region, replacing the current
+   * state. Fields following the trace flags other than the baggage are ignored.
+   *
+   * @return whether the region held a valid context
+   */
+  public boolean readFrom(ByteBuf byteBuf, int offset, int length) {
+    reset();
+    if (length < ENCODED_LENGTH
+        || byteBuf.getByte(offset) != VERSION
+        || byteBuf.getByte(offset + 1) != TRACE_ID_FIELD
+        || byteBuf.getByte(offset + 18) != SPAN_ID_FIELD
+        || byteBuf.getByte(offset + 27) != TRACE_FLAGS_FIELD) {
+      return false;
+    }
+    traceIdHigh = byteBuf.getLong(offset + 2);
+    traceIdLow = byteBuf.getLong(offset + 10);
+    spanId = byteBuf.getLong(offset + 19);
+    flags = byteBuf.getByte(offset + 28);
+
+    int index = offset + ENCODED_LENGTH;
+    int end = offset + length;
+    if (index < end && byteBuf.getByte(index) == BAGGAGE_FIELD) {
+      index++;
+      while (index < end) {
+        int keyLength = byteBuf.getUnsignedByte(index++);
+        if (end - index < keyLength + Short.BYTES) {
+          break;
+        }
+        String key = byteBuf.toString(index, keyLength, CharsetUtil.UTF_8);
+        index += keyLength;
+
+        int valueLength = byteBuf.getUnsignedShort(index);
+        index += Short.BYTES;
+        if (end - index < valueLength) {
+          break;
+        }
+        String value = byteBuf.toString(index, valueLength, CharsetUtil.UTF_8);
+        index += valueLength;
+
+        addBaggage(key, value);
+      }
+    }
+
+    return isValid();
+  }
+
+  @Override
+  public void put(String key, String value) {
+    boolean parsed;
+    if (TRACEPARENT.equalsIgnoreCase(key)) {
+      parsed = parseTraceparent(value);
+    } else if (B3_TRACE_ID.equalsIgnoreCase(key)) {
+      parsed = parseTraceId(value, 0, value.length());
+    } else if (B3_SPAN_ID.equalsIgnoreCase(key)) {
+      parsed = parseSpanId(value, 0, value.length());
+    } else if (B3_SAMPLED.equalsIgnoreCase(key) || B3_FLAGS.equalsIgnoreCase(key)) {
+      parsed = parseSampled(value, 0, value.length());
+    } else if (B3_PARENT_SPAN_ID.equalsIgnoreCase(key)) {
+      // Only the span being injected is needed to continue the trace
+      parsed = true;
+    } else if (B3.equalsIgnoreCase(key)) {
+      parsed = parseB3(value);
+    } else if (JAEGER.equalsIgnoreCase(key)) {
+      parsed = parseJaeger(value);
+    } else {
+      parsed = false;
+    }
+
+    if (!parsed) {
+      addBaggage(key, value);
+    }
+  }
+
+  /** Returns the trace headers followed by the baggage, for the tracer to extract from. */
+  @Override
+  public Iterator<Map.Entry<String, String>> iterator() {
+    return new EntryIterator(isValid() ? 0 : TRACE_HEADERS);
+  }
+
+  @Override
+  public Iterable<Map.Entry<String, String>> baggageItems() {
+    return () -> new EntryIterator(TRACE_HEADERS);
+  }
+
+  @Override
+  public String toString() {
+    return TRACEPARENT + ": " + traceparent();
+  }
+
+  private void addBaggage(String key, String value) {
+    if (baggageSize == baggage.length) {
+      baggage = Arrays.copyOf(baggage, Math.max(8, baggageSize * 2));
+    }
+    baggage[baggageSize++] = key;
+    baggage[baggageSize++] = value;
+  }
+
+  private Map.Entry<String, String> entry(int index) {
+    switch (index) {
+      case 0:
+        return new AbstractMap.SimpleImmutableEntry<>(TRACEPARENT, traceparent());
+      case 1:
+        return new AbstractMap.SimpleImmutableEntry<>(B3_TRACE_ID, traceIdHex());
+      case 2:
+        return new AbstractMap.SimpleImmutableEntry<>(B3_SPAN_ID, spanIdHex());
+      case 3:
+        return new AbstractMap.SimpleImmutableEntry<>(B3_SAMPLED, isSampled() ? "1" : "0");
+      case 4:
+        return new AbstractMap.SimpleImmutableEntry<>(
+            JAEGER, traceIdHex() + ':' + spanIdHex() + ":0:" + (isSampled() ? '1' : '0'));
+      default:
+        int i = (index - TRACE_HEADERS) * 2;
+        return new AbstractMap.SimpleImmutableEntry<>(baggage[i], baggage[i + 1]);
+    }
+  }
+
+  private String traceparent() {
+    char[] chars = new char[55];
+    chars[0] = '0';
+    chars[1] = '0';
+    chars[2] = '-';
+    writeHex(chars, 3, traceIdHigh, 16);
+    writeHex(chars, 19, traceIdLow, 16);
+    chars[35] = '-';
+    writeHex(chars, 36, spanId, 16);
+    chars[52] = '-';
+    writeHex(chars, 53, flags, 2);
+    return new String(chars);
+  }
+
+  // 64 bit trace ids are written as such for the tracers that do not support longer ones
+  private String traceIdHex() {
+    if (traceIdHigh == 0) {
+      char[] chars = new char[16];
+      writeHex(chars, 0, traceIdLow, 16);
+      return new String(chars);
+    }
+    char[] chars = new char[32];
+    writeHex(chars, 0, traceIdHigh, 16);
+    writeHex(chars, 16, traceIdLow, 16);
+    return new String(chars);
+  }
+
+  private String spanIdHex() {
+    char[] chars = new char[16];
+    writeHex(chars, 0, spanId, 16);
+    return new String(chars);
+  }
+
+  // 00-<trace id>-<span id>-<flags>
+  private boolean parseTraceparent(String value) {
+    if (value.length() < 55
+        || value.charAt(2) != '-'
+        || value.charAt(35) != '-'
+        || value.charAt(52) != '-'
+        || !isHex(value, 53, 55)
+        || !parseTraceId(value, 3, 35)
+        || !parseSpanId(value, 36, 52)) {
+      return false;
+    }
+    flags = (byte) parseHex(value, 53, 55);
+    return true;
+  }
+
+  // <trace id>-<span id>[-<sampling>[-<parent span id>]], or the sampling decision alone
+  private boolean parseB3(String value) {
+    int traceIdEnd = value.indexOf('-');
+    if (traceIdEnd < 0) {
+      return parseSampled(value, 0, value.length());
+    }
+    int spanIdEnd = value.indexOf('-', traceIdEnd + 1);
+    if (spanIdEnd < 0) {
+      spanIdEnd = value.length();
+    }
+    if (!parseTraceId(value, 0, traceIdEnd) || !parseSpanId(value, traceIdEnd + 1, spanIdEnd)) {
+      return false;
+    }
+    if (spanIdEnd == value.length()) {
+      return true;
+    }
+    int samplingEnd = value.indexOf('-', spanIdEnd + 1);
+    return parseSampled(value, spanIdEnd + 1, samplingEnd < 0 ? value.length() : samplingEnd);
+  }
+
+  // <trace id>:<span id>:<parent span id>:<flags>
+  private boolean parseJaeger(String value) {
+    int traceIdEnd = value.indexOf(':');
+    int spanIdEnd = traceIdEnd < 0 ? -1 : value.indexOf(':', traceIdEnd + 1);
+    int parentEnd = spanIdEnd < 0 ? -1 : value.indexOf(':', spanIdEnd + 1);
+    if (parentEnd < 0
+        || value.length() - parentEnd - 1 > 2
+        || !isHex(value, parentEnd + 1, value.length())
+        || !parseTraceId(value, 0, traceIdEnd)
+        || !parseSpanId(value, traceIdEnd + 1, spanIdEnd)) {
+      return false;
+    }
+    setSampled((parseHex(value, parentEnd + 1, value.length()) & 1) != 0);
+    return true;
+  }
+
+  private boolean parseTraceId(String value, int from, int to) {
+    int length = to - from;
+    if (length > 32 || !isHex(value, from, to)) {
+      return false;
+    }
+    if (length > 16) {
+      traceIdHigh = parseHex(value, from, to - 16);
+      traceIdLow = parseHex(value, to - 16, to);
+    } else {
+      traceIdHigh = 0;
+      traceIdLow = parseHex(value, from, to);
+    }
+    return true;
+  }
+
+  private boolean parseSpanId(String value, int from, int to) {
+    if (to - from > 16 || !isHex(value, from, to)) {
+      return false;
+    }
+    spanId = parseHex(value, from, to);
+    return true;
+  }
+
+  // "1", "d" (debug) and "true" mean sampled, "0" and "false" do not
+  private boolean parseSampled(String value, int from, int to) {
+    if (to - from == 1) {
+      char c = value.charAt(from);
+      if (c == '1' || c == 'd') {
+        setSampled(true);
+        return true;
+      } else if (c == '0') {
+        setSampled(false);
+        return true;
+      }
+      return false;
+    } else if (to - from == 4 && value.regionMatches(true, from, "true", 0, 4)) {
+      setSampled(true);
+      return true;
+    } else if (to - from == 5 && value.regionMatches(true, from, "false", 0, 5)) {
+      setSampled(false);
+      return true;
+    }
+    return false;
+  }
+
+  private void setSampled(boolean sampled) {
+    flags = (byte) (sampled ? flags | SAMPLED : flags & ~SAMPLED);
+  }
+
+  private static boolean isHex(String value, int from, int to) {
+    if (from >= to) {
+      return false;
+    }
+    for (int i = from; i < to; i++) {
+      if (Character.digit(value.charAt(i), 16) < 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  private static long parseHex(String value, int from, int to) {
+    long result = 0;
+    for (int i = from; i < to; i++) {
+      result = (result << 4) | Character.digit(value.charAt(i), 16);
+    }
+    return result;
+  }
+
+  private static void writeHex(char[] chars, int offset, long value, int digits) {
+    for (int i = offset + digits - 1; i >= offset; i--) {
+      chars[i] = HEX[(int) (value & 0xF)];
+      value >>>= 4;
+    }
+  }
+
+  private final class EntryIterator implements Iterator<Map.Entry<String, String>> {
+    private int index;
+
+    EntryIterator(int index) {
+      this.index = index;
+    }
+
+    @Override
+    public boolean hasNext() {
+      return index < TRACE_HEADERS + baggageSize / 2;
+    }
+
+    @Override
+    public Map.Entry<String, String> next() {
+      if (!hasNext()) {
+        throw new NoSuchElementException();
+      }
+      return entry(index++);
+    }
+  }
+}
@@ -21,8 +21,7 @@ import io.opentracing.Span;
 import io.opentracing.SpanContext;
 import io.opentracing.Tracer;
 import io.opentracing.propagation.Format;
-import io.opentracing.propagation.TextMapInjectAdapter;
-import java.util.Map;
+import io.opentracing.propagation.TextMap;
 import java.util.concurrent.TimeUnit;
 import java.util.concurrent.atomic.AtomicBoolean;
 import org.reactivestreams.Subscriber;
@@ -53,7 +52,7 @@ final class SpanSubscriber<T> extends AtomicBoolean implements SpanSubscription<
       Subscriber<? super T> subscriber,
       Context ctx,
       Tracer tracer,
-      Map<String, String> tracingMetadata,
+      TextMap carrier,
       SpanContext spanContext,
       String name,
       Tag... tags) {
@@ -70,9 +69,8 @@ final class SpanSubscriber<T> extends AtomicBoolean implements SpanSubscription<
 
     this.span = spanBuilder.start();
 
-    if (tracingMetadata != null) {
-      TextMapInjectAdapter adapter = new TextMapInjectAdapter(tracingMetadata);
-      tracer.inject(span.context(), Format.Builtin.TEXT_MAP, adapter);
+    if (carrier != null) {
+      tracer.inject(span.context(), Format.Builtin.TEXT_MAP, carrier);
     }
 
     if (log.isTraceEnabled()) {
@@ -90,7 +88,7 @@ final class SpanSubscriber<T> extends AtomicBoolean implements SpanSubscription<
       Subscriber<? super T> subscriber,
       Context ctx,
       Tracer tracer,
-      Map<String, String> tracingMetadata,
+      TextMap carrier,
       String name,
       Tag... tags) {
     this.subscriber = subscriber;
@@ -117,9 +115,8 @@ final class SpanSubscriber<T> extends AtomicBoolean implements SpanSubscription<
 
     this.span = spanBuilder.start();
 
-    if (tracingMetadata != null) {
-      TextMapInjectAdapter adapter = new TextMapInjectAdapter(tracingMetadata);
-      tracer.inject(span.context(), Format.Builtin.TEXT_MAP, adapter);
+    if (carrier != null) {
+      tracer.inject(span.context(), Format.Builtin.TEXT_MAP, carrier);
     }
 
     if (log.isTraceEnabled()) {
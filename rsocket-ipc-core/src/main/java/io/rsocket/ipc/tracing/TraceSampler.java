@@ -0,0 +1,46 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.tracing;
+
+import java.util.concurrent.ThreadLocalRandom;
+
+/**
+ * Decides whether a request that starts a trace is sampled, before any span work is done.
+ * Requests made while a span is active are always traced, since their parent was sampled, and
+ * servers follow the decision of their caller. Generated clients consult the sampler installed with
+ * {@link Tracing#setSampler(TraceSampler)}, by default every request is passed on to the tracer.
+ */
+@FunctionalInterface
+public interface TraceSampler {
+  TraceSampler ALWAYS = () -> true;
+  TraceSampler NEVER = () -> false;
+
+  boolean isSampled();
+
+  /** Samples the given fraction of requests, between 0 and 1. */
+  static TraceSampler probability(double rate) {
+    if (rate < 0.0 || rate > 1.0) {
+      throw new IllegalArgumentException("rate must be between 0 and 1 but was " + rate);
+    }
+    if (rate == 0.0) {
+      return NEVER;
+    }
+    if (rate == 1.0) {
+      return ALWAYS;
+    }
+    return () -> ThreadLocalRandom.current().nextDouble() < rate;
+  }
+}
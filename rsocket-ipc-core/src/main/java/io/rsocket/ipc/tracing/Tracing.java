@@ -19,11 +19,15 @@ import io.netty.buffer.ByteBuf;
 import io.netty.buffer.ByteBufAllocator;
 import io.netty.buffer.ByteBufUtil;
 import io.netty.buffer.Unpooled;
+import io.opentracing.Span;
 import io.opentracing.SpanContext;
 import io.opentracing.Tracer;
 import io.opentracing.propagation.Format;
 import io.opentracing.propagation.TextMapExtractAdapter;
+import io.opentracing.propagation.TextMapInjectAdapter;
+import io.rsocket.ipc.MetadataDecoder;
 import io.rsocket.ipc.frames.Metadata;
+import io.rsocket.ipc.util.SharedFunctions;
 import io.rsocket.util.NumberUtils;
 import java.nio.charset.StandardCharsets;
 import java.util.HashMap;
@@ -32,18 +36,38 @@ import java.util.Map;
 import java.util.function.Function;
 import org.reactivestreams.Publisher;
 import reactor.core.publisher.Operators;
+import reactor.util.context.Context;
 
 public class Tracing {
+  private static volatile TraceSampler sampler = TraceSampler.ALWAYS;
+
   private Tracing() {}
 
+  /** @return the sampler generated clients decide with, see {@link TraceSampler} */
+  public static TraceSampler sampler() {
+    return sampler;
+  }
+
+  public static void setSampler(TraceSampler sampler) {
+    Tracing.sampler = sampler == null ? TraceSampler.ALWAYS : sampler;
+  }
+
   public static SpanContext deserializeTracingMetadata(Tracer tracer, ByteBuf metadata) {
     if (tracer == null) {
       return null;
     }
 
     ByteBuf tracing = Metadata.getTracing(metadata);
+    if (Metadata.hasBinaryTracing(metadata)) {
+      return deserializeBinaryTracing(
+          tracer, new BinaryTraceContext(), tracing, tracing.readerIndex(), tracing.readableBytes());
+    }
+    return deserializeTracing(tracer, tracing);
+  }
 
-    if (tracing.readableBytes() < 0) {
+  /** Extracts the span context from the tracing section of the metadata. */
+  public static SpanContext deserializeTracing(Tracer tracer, ByteBuf tracing) {
+    if (tracer == null || tracing.readableBytes() <= 0) {
       return null;
     }
 
@@ -55,6 +79,18 @@ public class Tracing {
     return deserializeTracingMetadata(tracer, metadataMap);
   }
 
+  /**
+   * Extracts the span context from a tracing section holding a {@link BinaryTraceContext}. The
+   * carrier is reused, so only the tracer allocates.
+   */
+  public static SpanContext deserializeBinaryTracing(
+      Tracer tracer, BinaryTraceContext carrier, ByteBuf tracing, int offset, int length) {
+    if (tracer == null || !carrier.readFrom(tracing, offset, length)) {
+      return null;
+    }
+    return tracer.extract(Format.Builtin.TEXT_MAP, carrier);
+  }
+
   public static SpanContext deserializeTracingMetadata(
       Tracer tracer, Map<String, String> metadata) {
     TextMapExtractAdapter adapter = new TextMapExtractAdapter(metadata);
@@ -77,7 +113,7 @@ public class Tracing {
       String value = entry.getValue();
       int valueLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(value));
       byteBuf.writeShort(valueLength);
-      ByteBufUtil.reserveAndWriteUtf8(byteBuf, value, keyLength);
+      ByteBufUtil.reserveAndWriteUtf8(byteBuf, value, valueLength);
     }
 
     return byteBuf;
@@ -87,7 +123,13 @@ public class Tracing {
     if (spanContext == null) {
       return Unpooled.EMPTY_BUFFER;
     }
-    Iterator<Map.Entry<String, String>> iterator = spanContext.baggageItems().iterator();
+    return textMapToByteBuf(allocator, spanContext.baggageItems());
+  }
+
+  /** Writes the entries in the text map layout {@link #byteBufToMap} reads. */
+  public static ByteBuf textMapToByteBuf(
+      ByteBufAllocator allocator, Iterable<Map.Entry<String, String>> entries) {
+    Iterator<Map.Entry<String, String>> iterator = entries.iterator();
 
     if (!iterator.hasNext()) {
       return Unpooled.EMPTY_BUFFER;
@@ -105,7 +147,7 @@ public class Tracing {
       String value = entry.getValue();
       int valueLength = NumberUtils.requireUnsignedShort(ByteBufUtil.utf8Bytes(value));
       byteBuf.writeShort(valueLength);
-      ByteBufUtil.reserveAndWriteUtf8(byteBuf, value, keyLength);
+      ByteBufUtil.reserveAndWriteUtf8(byteBuf, value, valueLength);
     } while (iterator.hasNext());
 
     return byteBuf;
@@ -134,7 +176,12 @@ public class Tracing {
         Operators.lift(
             (scannable, subscriber) ->
                 new SpanSubscriber<T>(
-                    subscriber, subscriber.currentContext(), tracer, map, name, tags));
+                    subscriber,
+                    subscriber.currentContext(),
+                    tracer,
+                    map == null ? null : new TextMapInjectAdapter(map),
+                    name,
+                    tags));
   }
 
   public static <T>
@@ -143,6 +190,88 @@ public class Tracing {
     return map -> publisher -> publisher;
   }
 
+  /**
+   * Like {@link #trace(Tracer, String, Tag...)}, but injects into a {@link BinaryTraceContext} that
+   * can be handed to the {@link io.rsocket.ipc.MetadataEncoder} as is. Requests without a parent
+   * span are first put to the {@link #sampler()}; for those it turns down no span is created and
+   * the context is only {@link BinaryTraceContext#markNotSampled() marked}, so the server skips
+   * tracing as well.
+   */
+  public static <T>
+      Function<BinaryTraceContext, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          traceContext(Tracer tracer, String name, Tag... tags) {
+    return context ->
+        Operators.lift(
+            (scannable, subscriber) -> {
+              context.reset();
+              Context ctx = subscriber.currentContext();
+              if (!ctx.hasKey(Span.class) && tracer.activeSpan() == null && !sampler.isSampled()) {
+                context.markNotSampled();
+                return subscriber;
+              }
+              return new SpanSubscriber<T>(subscriber, ctx, tracer, context, name, tags);
+            });
+  }
+
+  /**
+   * Like {@link #traceContext(Tracer, String, Tag...)}, but built on first use and shared by every
+   * caller with the same tracer, name and tags.
+   *
+   * @param tagKeyValues keys and values of the tags, alternating
+   */
+  public static <T>
+      Function<BinaryTraceContext, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          sharedTraceContext(Tracer tracer, String name, String... tagKeyValues) {
+    return SharedFunctions.lazy(
+        tracer,
+        "traceContext " + name + ' ' + String.join(",", tagKeyValues),
+        () -> traceContext(tracer, name, tags(tagKeyValues)));
+  }
+
+  public static <T>
+      Function<BinaryTraceContext, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          traceContext() {
+    return context -> publisher -> publisher;
+  }
+
+  /**
+   * Like {@link #traceAsChild(Tracer, String, Tag...)}, but only extracts the span context of
+   * requests the caller sampled, others are passed through as is.
+   */
+  public static <T>
+      Function<MetadataDecoder.Metadata, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          traceRequest(Tracer tracer, String name, Tag... tags) {
+    Function<SpanContext, Function<? super Publisher<T>, ? extends Publisher<T>>> traceAsChild =
+        traceAsChild(tracer, name, tags);
+    return metadata -> {
+      if (!metadata.isSampled()) {
+        return Function.identity();
+      }
+      return traceAsChild.apply(metadata.spanContext());
+    };
+  }
+
+  /**
+   * Like {@link #traceRequest(Tracer, String, Tag...)}, but built on first use and shared by every
+   * caller with the same tracer, name and tags.
+   *
+   * @param tagKeyValues keys and values of the tags, alternating
+   */
+  public static <T>
+      Function<MetadataDecoder.Metadata, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          sharedTraceRequest(Tracer tracer, String name, String... tagKeyValues) {
+    return SharedFunctions.lazy(
+        tracer,
+        "traceRequest " + name + ' ' + String.join(",", tagKeyValues),
+        () -> traceRequest(tracer, name, tags(tagKeyValues)));
+  }
+
+  public static <T>
+      Function<MetadataDecoder.Metadata, Function<? super Publisher<T>, ? extends Publisher<T>>>
+          traceRequest() {
+    return metadata -> publisher -> publisher;
+  }
+
   public static <T>
       Function<SpanContext, Function<? super Publisher<T>, ? extends Publisher<T>>> traceAsChild() {
     return (spanContext) -> publisher -> publisher;
@@ -171,4 +300,15 @@ public class Tracing {
       }
     };
   }
+
+  private static Tag[] tags(String... keyValues) {
+    if (keyValues.length % 2 != 0) {
+      throw new IllegalArgumentException("tags must be given as key and value pairs");
+    }
+    Tag[] tags = new Tag[keyValues.length / 2];
+    for (int i = 0; i < tags.length; i++) {
+      tags[i] = Tag.of(keyValues[2 * i], keyValues[2 * i + 1]);
+    }
+    return tags;
+  }
 }
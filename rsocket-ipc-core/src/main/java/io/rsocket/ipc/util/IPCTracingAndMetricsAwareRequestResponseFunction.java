@@ -61,13 +61,13 @@ public class IPCTracingAndMetricsAwareRequestResponseFunction
     return rr.apply(input, metadata.metadata())
         .map(o -> ByteBufPayload.create(marshaller.apply(o)))
         .transform(
-            Tracing.traceAsChild(
+            Tracing.traceRequest(
                     tracer,
                     route,
                     Tag.of("rsocket.route", route),
                     Tag.of("rsocket.ipc.role", "server"),
                     Tag.of("rsocket.ipc.version", "ipc"))
-                .apply(metadata.spanContext()))
+                .apply(metadata))
         .transform(Metrics.timed(meterRegistry, "rsocket.server", "route", route));
   }
 }
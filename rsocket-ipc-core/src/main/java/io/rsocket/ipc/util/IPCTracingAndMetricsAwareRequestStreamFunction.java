@@ -60,13 +60,13 @@ public class IPCTracingAndMetricsAwareRequestStreamFunction implements IPCFuncti
     return rs.apply(input, metadata.metadata())
         .map(o -> ByteBufPayload.create(marshaller.apply(o)))
         .transform(
-            Tracing.traceAsChild(
+            Tracing.traceRequest(
                     tracer,
                     route,
                     Tag.of("rsocket.route", route),
                     Tag.of("rsocket.ipc.role", "server"),
                     Tag.of("rsocket.ipc.version", "ipc"))
-                .apply(metadata.spanContext()))
+                .apply(metadata))
         .transform(Metrics.timed(meterRegistry, "rsocket.server", "route", route));
   }
 }
@@ -53,12 +53,12 @@ public class IPCTracingAwareFireAndForgetFunction implements IPCFunction<Mono<Vo
     Object input = unmarshaller.apply(payload.sliceData());
     return fnf.apply(input, metadata.metadata())
         .transform(
-            Tracing.traceAsChild(
+            Tracing.traceRequest(
                     tracer,
                     route,
                     Tag.of("rsocket.route", route),
                     Tag.of("rsocket.ipc.role", "server"),
                     Tag.of("rsocket.ipc.version", "ipc"))
-                .apply(metadata.spanContext()));
+                .apply(metadata));
   }
 }
@@ -55,12 +55,12 @@ public class IPCTracingAwareRequestStreamFunction implements IPCFunction<Flux<Pa
     return rs.apply(input, metadata.metadata())
         .map(o -> ByteBufPayload.create(marshaller.apply(o)))
         .transform(
-            Tracing.traceAsChild(
+            Tracing.traceRequest(
                     tracer,
                     route,
                     Tag.of("rsocket.route", route),
                     Tag.of("rsocket.ipc.role", "server"),
                     Tag.of("rsocket.ipc.version", "ipc"))
-                .apply(metadata.spanContext()));
+                .apply(metadata));
   }
 }
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.util;
+
+import java.lang.ref.WeakReference;
+import java.util.Collections;
+import java.util.Map;
+import java.util.WeakHashMap;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentMap;
+import java.util.function.Function;
+import java.util.function.Supplier;
+
+/**
+ * Functions shared by every generated stub that instruments the same method with the same meter
+ * registry or tracer. A function is only built when the first request goes through it, so stubs
+ * constructed per connection cost a lookup per method rather than a set of meters and lambdas.
+ *
+ * <p>The functions usually hold on to their registry or tracer, so the cache references them
+ * weakly, like their owners: a function is shared for as long as a stub uses it, and neither it
+ * nor its owner is kept alive by the cache alone.
+ */
+public final class SharedFunctions {
+  private static final Map<Object, ConcurrentMap<String, WeakReference<Function<?, ?>>>>
+      FUNCTIONS = Collections.synchronizedMap(new WeakHashMap<>());
+
+  private SharedFunctions() {}
+
+  /**
+   * @param owner the registry or tracer the function records into
+   * @param key identifies the function among the ones of the owner
+   * @param factory builds the function on its first application
+   */
+  @SuppressWarnings("unchecked")
+  public static <A, B> Function<A, B> lazy(
+      Object owner, String key, Supplier<? extends Function<? super A, ? extends B>> factory) {
+    ConcurrentMap<String, WeakReference<Function<?, ?>>> functions =
+        FUNCTIONS.computeIfAbsent(owner, o -> new ConcurrentHashMap<>());
+    // Holds the function strongly until it is returned, the cache itself only references it weakly
+    Function<?, ?>[] function = new Function<?, ?>[1];
+    functions.compute(
+        key,
+        (k, reference) -> {
+          function[0] = reference == null ? null : reference.get();
+          if (function[0] != null) {
+            return reference;
+          }
+          function[0] = new LazyFunction<>(factory);
+          return new WeakReference<>(function[0]);
+        });
+    return (Function<A, B>) function[0];
+  }
+
+  private static final class LazyFunction<A, B> implements Function<A, B> {
+    private Supplier<? extends Function<? super A, ? extends B>> factory;
+    private volatile Function<? super A, ? extends B> delegate;
+
+    LazyFunction(Supplier<? extends Function<? super A, ? extends B>> factory) {
+      this.factory = factory;
+    }
+
+    @Override
+    public B apply(A a) {
+      Function<? super A, ? extends B> delegate = this.delegate;
+      if (delegate == null) {
+        delegate = initialize();
+      }
+      return delegate.apply(a);
+    }
+
+    private synchronized Function<? super A, ? extends B> initialize() {
+      Function<? super A, ? extends B> delegate = this.delegate;
+      if (delegate == null) {
+        delegate = factory.get();
+        this.delegate = delegate;
+        factory = null;
+      }
+      return delegate;
+    }
+  }
+}
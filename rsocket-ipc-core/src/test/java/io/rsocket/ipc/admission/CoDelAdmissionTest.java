@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.admission;
+
+import io.rsocket.Payload;
+import io.rsocket.exceptions.RejectedException;
+import io.rsocket.ipc.offload.ParseOffload;
+import io.rsocket.util.ByteBufPayload;
+import java.time.Duration;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Mono;
+import reactor.core.scheduler.Scheduler;
+import reactor.core.scheduler.Schedulers;
+import reactor.test.StepVerifier;
+
+public class CoDelAdmissionTest {
+  private static final long MS = TimeUnit.MILLISECONDS.toNanos(1);
+
+  @Test
+  public void testShouldShedOnlyWhileTheQueueStands() {
+    CoDelAdmission admission =
+        new CoDelAdmission(Schedulers.immediate(), Duration.ofMillis(5), Duration.ofMillis(100));
+    long now = System.nanoTime();
+
+    // A burst within the first interval is absorbed
+    Assert.assertFalse(admission.isOverloaded(50 * MS, now));
+    Assert.assertFalse(admission.isOverloaded(20 * MS, now + 50 * MS));
+
+    // The minimum stayed above the target for the whole interval
+    now += 200 * MS;
+    Assert.assertTrue(admission.isOverloaded(20 * MS, now));
+    Assert.assertFalse("short waits still pass", admission.isOverloaded(8 * MS, now));
+    Assert.assertFalse(admission.isOverloaded(1 * MS, now));
+
+    // The queue drained once, so the next interval admits everything again
+    now += 200 * MS;
+    Assert.assertFalse(admission.isOverloaded(20 * MS, now));
+  }
+
+  @Test
+  public void testShouldCallTheHandlerOnceAdmitted() {
+    CoDelAdmission admission = new CoDelAdmission(Schedulers.immediate());
+    Payload payload = ByteBufPayload.create("request");
+
+    Mono<String> response = admission.mono(payload, () -> Mono.just(payload.getDataUtf8()));
+    payload.release();
+    Assert.assertEquals(1, payload.refCnt());
+
+    Assert.assertEquals("request", response.block());
+    Assert.assertEquals(0, payload.refCnt());
+  }
+
+  @Test
+  public void testShouldNotCallTheHandlerOfARejectedRequest() {
+    Scheduler scheduler = Schedulers.newSingle("admission");
+    try {
+      CoDelAdmission admission =
+          new CoDelAdmission(scheduler, Duration.ofMillis(1), Duration.ofSeconds(10));
+      overload(admission);
+      Payload payload = ByteBufPayload.create("request");
+      AtomicBoolean handled = new AtomicBoolean();
+
+      Mono<String> response =
+          admission.mono(
+              payload,
+              () -> {
+                handled.set(true);
+                return Mono.just(payload.getDataUtf8());
+              });
+      payload.release();
+      // Keeps the request queued for longer than twice the target
+      scheduler.schedule(CoDelAdmissionTest::sleep);
+
+      StepVerifier.create(response).expectError(RejectedException.class).verify();
+      Assert.assertFalse(handled.get());
+      Assert.assertEquals(0, payload.refCnt());
+    } finally {
+      scheduler.dispose();
+    }
+  }
+
+  @Test
+  public void testShouldReleaseARejectedOffloadedRequest() {
+    Scheduler scheduler = Schedulers.newSingle("admission");
+    try {
+      CoDelAdmission admission =
+          new CoDelAdmission(scheduler, Duration.ofMillis(1), Duration.ofSeconds(10));
+      ParseOffload offload = new ParseOffload(Schedulers.immediate(), 0);
+      overload(admission);
+      Payload payload = ByteBufPayload.create("request");
+      AtomicBoolean parsed = new AtomicBoolean();
+
+      Mono<String> response =
+          admission.mono(
+              payload,
+              () ->
+                  offload.<String, String>mono(
+                      payload,
+                      () -> {
+                        parsed.set(true);
+                        return payload.getDataUtf8();
+                      },
+                      Mono::just));
+      payload.release();
+      scheduler.schedule(CoDelAdmissionTest::sleep);
+
+      StepVerifier.create(response).expectError(RejectedException.class).verify();
+      Assert.assertFalse(parsed.get());
+      Assert.assertEquals(0, payload.refCnt());
+    } finally {
+      scheduler.dispose();
+    }
+  }
+
+  @Test
+  public void testRejectionShouldCarryRetryAfter() {
+    Assert.assertEquals(
+        120,
+        CoDelAdmission.retryAfterMillis(
+            new RejectedException("server overloaded, retry-after-ms=120")));
+    Assert.assertEquals(-1, CoDelAdmission.retryAfterMillis(new RejectedException("busy")));
+    Assert.assertEquals(-1, CoDelAdmission.retryAfterMillis(new IllegalStateException()));
+  }
+
+  @Test
+  public void testBackoffShouldDelayRequestsAfterRejection() {
+    RetryAfterBackoff backoff = new RetryAfterBackoff();
+    backoff.onError(new RejectedException("server overloaded, retry-after-ms=200"));
+
+    StepVerifier.withVirtualTime(() -> Mono.from(backoff.apply(Mono.just(1))))
+        .expectSubscription()
+        .expectNoEvent(Duration.ofMillis(150))
+        .thenAwait(Duration.ofMillis(100))
+        .expectNext(1)
+        .verifyComplete();
+  }
+
+  private static void overload(CoDelAdmission admission) {
+    long now = System.nanoTime();
+    admission.isOverloaded(50 * MS, now);
+    // Ends the first interval with a standing queue, the next one ends after the test
+    Assert.assertTrue(admission.isOverloaded(50 * MS, now + TimeUnit.SECONDS.toNanos(11)));
+  }
+
+  private static void sleep() {
+    try {
+      Thread.sleep(20);
+    } catch (InterruptedException e) {
+      Thread.currentThread().interrupt();
+    }
+  }
+}
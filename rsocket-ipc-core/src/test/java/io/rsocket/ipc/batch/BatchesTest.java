@@ -0,0 +1,108 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.batch;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufUtil;
+import io.netty.buffer.Unpooled;
+import io.rsocket.Payload;
+import io.rsocket.util.ByteBufPayload;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+import java.util.List;
+import java.util.function.Function;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+public class BatchesTest {
+  private static final Function<Payload, String> DESERIALIZER =
+      payload -> {
+        try {
+          return payload.getDataUtf8();
+        } finally {
+          payload.release();
+        }
+      };
+
+  @Test
+  public void testShouldSendTheMetadataWithTheFirstRequestOnly() {
+    ByteBuf metadata = Unpooled.copiedBuffer("metadata", StandardCharsets.UTF_8);
+    List<Payload> requests =
+        Batches.requests(
+                Flux.just("a", "b"),
+                message -> ByteBufUtil.writeUtf8(Unpooled.buffer(), message),
+                metadata)
+            .collectList()
+            .block();
+
+    Assert.assertEquals("a", requests.get(0).getDataUtf8());
+    Assert.assertEquals("metadata", requests.get(0).getMetadataUtf8());
+    Assert.assertEquals("b", requests.get(1).getDataUtf8());
+    Assert.assertFalse(requests.get(1).hasMetadata());
+    requests.forEach(Payload::release);
+    Assert.assertEquals(0, metadata.refCnt());
+  }
+
+  @Test
+  public void testShouldReleaseTheMetadataOfAnEmptyBatch() {
+    ByteBuf metadata = Unpooled.copiedBuffer("metadata", StandardCharsets.UTF_8);
+    Batches.requests(Flux.<String>empty(), message -> Unpooled.EMPTY_BUFFER, metadata)
+        .blockLast();
+    Assert.assertEquals(0, metadata.refCnt());
+  }
+
+  @Test
+  public void testShouldNumberResponsesAfterTheirRequests() {
+    List<Payload> responses =
+        Batches.serve(
+                Flux.just("a", "b", "c"), message -> Mono.just(ByteBufPayload.create(message)))
+            .collectList()
+            .block();
+
+    for (int i = 0; i < responses.size(); i++) {
+      Assert.assertEquals(i, Batches.index(responses.get(i)));
+      responses.get(i).release();
+    }
+  }
+
+  @Test
+  public void testShouldRestoreTheRequestOrder() {
+    Flux<Payload> responses =
+        Flux.just(
+            Batches.numbered(ByteBufPayload.create("c"), 2),
+            Batches.numbered(ByteBufPayload.create("a"), 0),
+            Batches.numbered(ByteBufPayload.create("d"), 3),
+            Batches.numbered(ByteBufPayload.create("b"), 1));
+
+    Assert.assertEquals(
+        Arrays.asList("a", "b", "c", "d"),
+        Batches.responses(responses, true, DESERIALIZER).collectList().block());
+  }
+
+  @Test
+  public void testShouldEmitResponsesInCompletionOrderByDefault() {
+    Flux<Payload> responses =
+        Flux.just(
+            Batches.numbered(ByteBufPayload.create("b"), 1),
+            Batches.numbered(ByteBufPayload.create("a"), 0));
+
+    Assert.assertEquals(
+        Arrays.asList("b", "a"),
+        Batches.responses(responses, false, DESERIALIZER).collectList().block());
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.chunked;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufUtil;
+import io.netty.buffer.Unpooled;
+import io.rsocket.Payload;
+import io.rsocket.util.ByteBufPayload;
+import java.util.List;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Flux;
+
+public class ChunksTest {
+  @Test
+  public void testShouldCutLargeBuffersIntoBoundedChunks() {
+    ByteBuf byteBuf = Unpooled.buffer().writeZero(2 * Chunks.MAX_CHUNK_SIZE + 1);
+
+    List<ByteBuf> chunks = Chunks.slice(byteBuf);
+
+    Assert.assertEquals(3, chunks.size());
+    Assert.assertEquals(Chunks.MAX_CHUNK_SIZE, chunks.get(0).readableBytes());
+    Assert.assertEquals(1, chunks.get(2).readableBytes());
+    chunks.forEach(ByteBuf::release);
+    Assert.assertEquals(0, byteBuf.refCnt());
+  }
+
+  @Test
+  public void testShouldDecodeWhatWasEncoded() {
+    byte[] bytes = new byte[3 * Chunks.MAX_CHUNK_SIZE];
+    for (int i = 0; i < bytes.length; i++) {
+      bytes[i] = (byte) i;
+    }
+    Flux<Payload> payloads =
+        Chunks.encode(
+            ByteBufPayload.create("header"),
+            Flux.just(
+                Unpooled.wrappedBuffer(bytes, 0, 10),
+                Unpooled.wrappedBuffer(bytes, 10, bytes.length - 10)));
+
+    Chunked<String> chunked =
+        Chunks.decode(
+                payloads,
+                payload -> {
+                  String header = payload.getDataUtf8();
+                  payload.release();
+                  return header;
+                })
+            .block();
+
+    Assert.assertEquals("header", chunked.header());
+    ByteBuf data = Unpooled.buffer();
+    chunked
+        .data()
+        .doOnNext(
+            chunk -> {
+              Assert.assertTrue(chunk.readableBytes() <= Chunks.MAX_CHUNK_SIZE);
+              data.writeBytes(chunk);
+              chunk.release();
+            })
+        .blockLast();
+    Assert.assertArrayEquals(bytes, ByteBufUtil.getBytes(data));
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.decoders;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.netty.buffer.Unpooled;
+import io.netty.util.CharsetUtil;
+import io.rsocket.ipc.MetadataDecoder;
+import io.rsocket.ipc.encoders.DefaultMetadataEncoder;
+import io.rsocket.ipc.frames.Metadata;
+import io.rsocket.ipc.tracing.BinaryTraceContext;
+import org.junit.Assert;
+import org.junit.Test;
+
+public class CompositeMetadataDecoderTest {
+
+  @Test
+  public void testShouldDecodeRecycledMetadata() {
+    MetadataDecoder decoder = new CompositeMetadataDecoder();
+    ByteBuf first = encode("HelloService", "hello", "first");
+    ByteBuf second = encode("", "goodbye", "");
+    try {
+      MetadataDecoder.Metadata metadata = decoder.decode(first);
+      Assert.assertFalse(metadata.isComposite());
+      Assert.assertEquals("HelloService.hello", metadata.route());
+      Assert.assertEquals("first", metadata.metadata().toString(CharsetUtil.UTF_8));
+      metadata.recycle();
+
+      metadata = decoder.decode(second);
+      Assert.assertEquals("goodbye", metadata.route());
+      Assert.assertEquals(0, metadata.metadata().readableBytes());
+      metadata.recycle();
+
+      Assert.assertEquals(0, first.readerIndex());
+      Assert.assertEquals(0, second.readerIndex());
+    } finally {
+      first.release();
+      second.release();
+    }
+  }
+
+  @Test
+  public void testShouldDecodePlainRoute() {
+    ByteBuf route = Unpooled.copiedBuffer("HelloService.hello", CharsetUtil.UTF_8);
+    MetadataDecoder.Metadata metadata = new CompositeMetadataDecoder().decode(route);
+    Assert.assertEquals("HelloService.hello", metadata.route());
+    metadata.recycle();
+  }
+
+  @Test
+  public void testShouldDecodeSamplingDecision() {
+    MetadataDecoder decoder = new CompositeMetadataDecoder();
+    DefaultMetadataEncoder encoder = new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT);
+    ByteBuf sampled = encode("HelloService", "hello", "");
+    ByteBuf notSampled =
+        encoder.encode(
+            Unpooled.EMPTY_BUFFER,
+            new BinaryTraceContext().markNotSampled(),
+            "HelloService",
+            "hello");
+    try {
+      MetadataDecoder.Metadata metadata = decoder.decode(sampled);
+      Assert.assertTrue(metadata.isSampled());
+      metadata.recycle();
+
+      metadata = decoder.decode(notSampled);
+      Assert.assertFalse(metadata.isSampled());
+      Assert.assertEquals("HelloService.hello", metadata.route());
+      Assert.assertEquals(Metadata.VERSION, Metadata.getVersion(notSampled));
+      metadata.recycle();
+    } finally {
+      sampled.release();
+      notSampled.release();
+    }
+  }
+
+  private static ByteBuf encode(String service, String method, String metadata) {
+    return Metadata.encode(
+        ByteBufAllocator.DEFAULT,
+        service,
+        method,
+        Unpooled.copiedBuffer(metadata, CharsetUtil.UTF_8));
+  }
+}
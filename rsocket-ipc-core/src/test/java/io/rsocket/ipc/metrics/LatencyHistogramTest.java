@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.metrics;
+
+import java.util.function.Function;
+import org.junit.Assert;
+import org.junit.Test;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Mono;
+
+public class LatencyHistogramTest {
+
+  @Test
+  public void testBucketsShouldCoverTheirValues() {
+    long[] values = {0, 1, 31, 32, 33, 63, 64, 1_000, 123_456, 1L << 37, (1L << 38) - 1};
+    for (long value : values) {
+      int index = LatencyHistogram.index(value);
+      Assert.assertTrue(value + " above its bucket", value <= LatencyHistogram.highestValue(index));
+      if (index > 0) {
+        Assert.assertTrue(
+            value + " below its bucket", value > LatencyHistogram.highestValue(index - 1));
+      }
+      Assert.assertTrue(
+          "relative error for " + value,
+          LatencyHistogram.highestValue(index) - value <= Math.max(1, value / 32));
+    }
+    Assert.assertEquals(LatencyHistogram.BUCKETS - 1, LatencyHistogram.index(Long.MAX_VALUE));
+  }
+
+  @Test
+  public void testShouldComputePercentiles() {
+    LatencyHistogram histogram = new LatencyRecorder(4).histogram("svc", "method", "server");
+    for (int i = 1; i <= 1000; i++) {
+      histogram.recordNanos(i * 1_000L);
+    }
+
+    LatencyHistogram.Snapshot snapshot = histogram.snapshotAndReset();
+    Assert.assertEquals(1000, snapshot.count());
+    Assert.assertEquals(1_000_000L, snapshot.maxNanos());
+    Assert.assertEquals(500_500_000L, snapshot.totalNanos());
+    assertWithin(500_000, snapshot.valueAtPercentile(0.5));
+    assertWithin(990_000, snapshot.valueAtPercentile(0.99));
+    assertWithin(999_000, snapshot.valueAtPercentile(0.999));
+
+    Assert.assertEquals(0, histogram.snapshot().count());
+    Assert.assertEquals(0, histogram.snapshot().valueAtPercentile(0.99));
+  }
+
+  @Test
+  public void testShouldShareRecordingFunctions() {
+    LatencyRecorder recorder = new LatencyRecorder(1);
+    Function<? super Publisher<Integer>, ? extends Publisher<Integer>> recorded =
+        Metrics.sharedRecorded(recorder, "svc", "method", "client");
+
+    Assert.assertSame(recorded, Metrics.sharedRecorded(recorder, "svc", "method", "client"));
+    Assert.assertNotSame(recorded, Metrics.sharedRecorded(recorder, "svc", "method", "server"));
+
+    Assert.assertEquals(1, Mono.just(1).transform(recorded).block().intValue());
+    Assert.assertEquals(1, recorder.histogram("svc", "method", "client").snapshot().count());
+  }
+
+  private static void assertWithin(long expected, long actual) {
+    Assert.assertTrue(
+        "expected about " + expected + " but was " + actual,
+        actual >= expected && actual - expected <= expected / 32);
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.offload;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.Unpooled;
+import io.rsocket.Payload;
+import io.rsocket.util.ByteBufPayload;
+import java.nio.charset.StandardCharsets;
+import java.time.Duration;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.atomic.AtomicBoolean;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.Disposable;
+import reactor.core.publisher.Mono;
+import reactor.core.scheduler.Scheduler;
+import reactor.core.scheduler.Schedulers;
+
+public class ParseOffloadTest {
+  @Test
+  public void testShouldOffloadOnlyPayloadsReachingTheThreshold() {
+    ParseOffload offload = new ParseOffload(Schedulers.immediate(), 16);
+    Payload small = ByteBufPayload.create(Unpooled.wrappedBuffer(new byte[15]));
+    Payload large = ByteBufPayload.create(Unpooled.wrappedBuffer(new byte[16]));
+
+    Assert.assertFalse(offload.offloads(small));
+    Assert.assertTrue(offload.offloads(large));
+    Assert.assertFalse(offload.offloads(small));
+
+    Assert.assertEquals(2, offload.inlineCount());
+    Assert.assertEquals(1, offload.offloadedCount());
+    Assert.assertEquals(1.0 / 3, offload.offloadedRatio(), 0.0001);
+    small.release();
+    large.release();
+  }
+
+  @Test
+  public void testShouldParseOnTheSchedulerAndReleaseThePayloadAfterwards() {
+    Scheduler scheduler = Schedulers.newSingle("parse");
+    try {
+      ParseOffload offload = new ParseOffload(scheduler, 0);
+      Payload payload = ByteBufPayload.create("request");
+
+      Mono<String> response =
+          offload.mono(
+              payload,
+              payload::getDataUtf8,
+              message -> Mono.just(message + " on " + Thread.currentThread().getName()));
+      // The caller releases its reference as soon as the handler was set up
+      payload.release();
+      Assert.assertEquals(1, payload.refCnt());
+
+      Assert.assertTrue(response.block().startsWith("request on parse"));
+      Assert.assertEquals(0, payload.refCnt());
+    } finally {
+      scheduler.dispose();
+    }
+  }
+
+  @Test
+  public void testShouldKeepTheMetadataReadableUntilTheHandlerTerminates() {
+    Scheduler scheduler = Schedulers.newSingle("parse");
+    try {
+      ParseOffload offload = new ParseOffload(scheduler, 0);
+      Payload payload = ByteBufPayload.create("request", "metadata");
+      // Like generated servers, the handler reads a slice of the payload's metadata
+      ByteBuf metadata = payload.sliceMetadata();
+
+      Mono<String> response =
+          offload.mono(
+              payload,
+              payload::getDataUtf8,
+              message ->
+                  Mono.delay(Duration.ofMillis(1))
+                      .map(tick -> message + " with " + metadata.toString(StandardCharsets.UTF_8)));
+      payload.release();
+
+      Assert.assertEquals("request with metadata", response.block());
+      Assert.assertEquals(0, payload.refCnt());
+    } finally {
+      scheduler.dispose();
+    }
+  }
+
+  @Test
+  public void testShouldReleaseThePayloadOfARequestCancelledBeforeItsParse() {
+    Scheduler scheduler = Schedulers.newSingle("parse");
+    CountDownLatch latch = new CountDownLatch(1);
+    try {
+      ParseOffload offload = new ParseOffload(scheduler, 0);
+      Payload payload = ByteBufPayload.create("request");
+      AtomicBoolean parsed = new AtomicBoolean();
+      // Keeps the parse queued behind a blocked task
+      scheduler.schedule(
+          () -> {
+            try {
+              latch.await();
+            } catch (InterruptedException e) {
+              Thread.currentThread().interrupt();
+            }
+          });
+
+      Disposable response =
+          offload
+              .<String, String>mono(
+                  payload,
+                  () -> {
+                    parsed.set(true);
+                    return payload.getDataUtf8();
+                  },
+                  Mono::just)
+              .subscribe();
+      payload.release();
+      response.dispose();
+      Assert.assertEquals(0, payload.refCnt());
+
+      latch.countDown();
+      Assert.assertFalse(Mono.fromCallable(parsed::get).subscribeOn(scheduler).block());
+    } finally {
+      latch.countDown();
+      scheduler.dispose();
+    }
+  }
+}
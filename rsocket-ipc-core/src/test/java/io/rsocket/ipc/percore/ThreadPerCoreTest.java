@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.percore;
+
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.atomic.AtomicInteger;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Mono;
+import reactor.core.scheduler.Schedulers;
+
+public class ThreadPerCoreTest {
+  @Test
+  public void testShouldPublishResponsesOnTheCoreThatReceivedTheRequest() throws Exception {
+    ExecutorService loop = Executors.newSingleThreadExecutor(r -> new Thread(r, "core"));
+    try {
+      Mono<String> response =
+          loop.submit(
+                  () -> {
+                    ThreadPerCore.register(loop);
+                    // The handler completes on another thread
+                    return Mono.just("response")
+                        .publishOn(Schedulers.parallel())
+                        .transform(ThreadPerCore.<String>pinned());
+                  })
+              .get();
+
+      String thread = response.map(r -> Thread.currentThread().getName()).block();
+      Assert.assertEquals("core", thread);
+    } finally {
+      loop.shutdown();
+    }
+  }
+
+  @Test
+  public void testShouldCreateOneInstancePerThread() throws Exception {
+    PerCore<AtomicInteger> counters = new PerCore<>(AtomicInteger::new);
+    counters.get().incrementAndGet();
+    counters.get().incrementAndGet();
+
+    Thread other = new Thread(() -> counters.get().incrementAndGet());
+    other.start();
+    other.join();
+
+    Assert.assertEquals(2, counters.get().get());
+    Assert.assertEquals(2, counters.all().size());
+    Assert.assertEquals(3, counters.all().stream().mapToInt(AtomicInteger::get).sum());
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.routing;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.netty.buffer.Unpooled;
+import io.rsocket.Payload;
+import io.rsocket.ipc.MetadataDecoder;
+import io.rsocket.ipc.SelfRegistrable;
+import io.rsocket.ipc.decoders.CompositeMetadataDecoder;
+import io.rsocket.ipc.frames.Metadata;
+import io.rsocket.ipc.util.IPCFunction;
+import java.nio.charset.StandardCharsets;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Mono;
+
+public class CopyOnWriteRouterTest {
+
+  @Test
+  public void testStringHashMatchesUtf8BytesHash() {
+    String[] routes = {"", "a", "Service.method", "d\u00e9j\u00e0.vu", "\uD83D\uDE80.x"};
+    for (String route : routes) {
+      Assert.assertEquals(
+          route, Routes.hash(route.getBytes(StandardCharsets.UTF_8)), Routes.hash(route));
+    }
+  }
+
+  @Test
+  public void testShouldRouteFromEncodedMetadata() throws Exception {
+    IPCFunction<Mono<Payload>> hello = (payload, metadata) -> Mono.empty();
+    IPCFunction<Mono<Payload>> goodbye = (payload, metadata) -> Mono.empty();
+    CopyOnWriteRouter router =
+        new CopyOnWriteRouter()
+            .withRequestResponseRoute("HelloService.hello", hello)
+            .withRequestResponseRoute("HelloService.goodbye", goodbye);
+
+    MetadataDecoder decoder = new CompositeMetadataDecoder();
+    ByteBuf encoded =
+        Metadata.encode(
+            ByteBufAllocator.DEFAULT, "HelloService", "goodbye", Unpooled.EMPTY_BUFFER);
+    try {
+      MetadataDecoder.Metadata metadata = decoder.decode(encoded);
+      Assert.assertSame(goodbye, router.routeRequestResponse(metadata));
+      Assert.assertNull(router.routeRequestStream(metadata));
+    } finally {
+      encoded.release();
+    }
+  }
+
+  @Test
+  public void testRouteIndexShouldNumberRoutesInOrder() throws Exception {
+    RouteIndex index =
+        new RouteIndex("HelloService.hello", "HelloService.goodbye", "HelloService.hello/batch");
+
+    MetadataDecoder decoder = new CompositeMetadataDecoder();
+    ByteBuf goodbye =
+        Metadata.encode(
+            ByteBufAllocator.DEFAULT, "HelloService", "goodbye", Unpooled.EMPTY_BUFFER);
+    ByteBuf unknown =
+        Metadata.encode(ByteBufAllocator.DEFAULT, "HelloService", "hey", Unpooled.EMPTY_BUFFER);
+    try {
+      Assert.assertEquals(1, index.indexOf(decoder.decode(goodbye)));
+      Assert.assertEquals(-1, index.indexOf(decoder.decode(unknown)));
+    } finally {
+      goodbye.release();
+      unknown.release();
+    }
+  }
+
+  @Test
+  public void testShouldRemoveService() {
+    IPCFunction<Mono<Void>> function = (payload, metadata) -> Mono.empty();
+    CopyOnWriteRouter router =
+        new CopyOnWriteRouter()
+            .withFireAndForgetRoute("HelloService.hello", function)
+            .withFireAndForgetRoute("HelloServiceV2.hello", function);
+
+    router.withoutService("HelloService");
+
+    Assert.assertNull(router.routeFireAndForget("HelloService.hello"));
+    Assert.assertSame(function, router.routeFireAndForget("HelloServiceV2.hello"));
+  }
+
+  @Test
+  @SuppressWarnings("unchecked")
+  public void testShouldRegisterEndpointInOneUpdate() {
+    IPCFunction<Mono<Payload>> hello = (payload, metadata) -> Mono.empty();
+    IPCFunction<Mono<Payload>> replaced = (payload, metadata) -> Mono.empty();
+    IPCFunction<Mono<Void>> fireAndForget = (payload, metadata) -> Mono.empty();
+    CopyOnWriteRouter router =
+        new CopyOnWriteRouter().withRequestResponseRoute("HelloService.goodbye", hello);
+    SelfRegistrable endpoint =
+        registration -> {
+          registration.withRequestResponseRoute("HelloService.hello", hello);
+          registration.withRequestResponseRoute("HelloService.goodbye", replaced);
+          registration.withFireAndForgetRoute("HelloService.ping", fireAndForget);
+          // Routes registered so far are visible during the registration
+          Assert.assertSame(hello, registration.routeRequestResponse("HelloService.hello"));
+        };
+
+    router.withEndpoint(endpoint);
+
+    Assert.assertSame(hello, router.routeRequestResponse("HelloService.hello"));
+    Assert.assertSame(replaced, router.routeRequestResponse("HelloService.goodbye"));
+    Assert.assertSame(fireAndForget, router.routeFireAndForget("HelloService.ping"));
+    Assert.assertNull(router.routeRequestStream("HelloService.hello"));
+  }
+}
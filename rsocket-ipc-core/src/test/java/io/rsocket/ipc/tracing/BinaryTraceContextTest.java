@@ -0,0 +1,154 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.tracing;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.netty.buffer.Unpooled;
+import io.rsocket.ipc.encoders.DefaultMetadataEncoder;
+import io.rsocket.ipc.frames.Metadata;
+import java.util.HashMap;
+import java.util.Map;
+import org.junit.Assert;
+import org.junit.Test;
+
+public class BinaryTraceContextTest {
+  private static final String TRACEPARENT =
+      "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+
+  @Test
+  public void testShouldRoundTripTraceparent() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("traceparent", TRACEPARENT);
+    Assert.assertTrue(context.isValid());
+    Assert.assertTrue(context.isSampled());
+    Assert.assertFalse(context.hasBaggage());
+
+    ByteBuf byteBuf = Unpooled.buffer();
+    Assert.assertEquals(BinaryTraceContext.ENCODED_LENGTH, context.writeTo(byteBuf, true));
+
+    BinaryTraceContext decoded = new BinaryTraceContext();
+    Assert.assertTrue(decoded.readFrom(byteBuf, 0, byteBuf.readableBytes()));
+    Assert.assertEquals(0x4bf92f3577b34da6L, decoded.traceIdHigh());
+    Assert.assertEquals(0xa3ce929d0e0e4736L, decoded.traceIdLow());
+    Assert.assertEquals(0x00f067aa0ba902b7L, decoded.spanId());
+    Assert.assertEquals(TRACEPARENT, toMap(decoded).get("traceparent"));
+  }
+
+  @Test
+  public void testShouldParseB3AndJaegerHeaders() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("X-B3-TraceId", "463ac35c9f6413ad");
+    context.put("X-B3-SpanId", "a2fb4a1d1a96d312");
+    context.put("X-B3-Sampled", "1");
+    Assert.assertTrue(context.isValid());
+    Assert.assertEquals(0, context.traceIdHigh());
+    Assert.assertEquals(
+        "463ac35c9f6413ad:a2fb4a1d1a96d312:0:1", toMap(context).get("uber-trace-id"));
+
+    context.reset();
+    context.put("uber-trace-id", "463ac35c9f6413ad:a2fb4a1d1a96d312:0:0");
+    Assert.assertTrue(context.isValid());
+    Assert.assertFalse(context.isSampled());
+    Assert.assertEquals("a2fb4a1d1a96d312", toMap(context).get("X-B3-SpanId"));
+  }
+
+  @Test
+  public void testShouldOnlyWriteBaggageWhenAskedFor() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("traceparent", TRACEPARENT);
+    context.put("user", "r\u00e9my");
+
+    ByteBuf without = Unpooled.buffer();
+    context.writeTo(without, false);
+    BinaryTraceContext decoded = new BinaryTraceContext();
+    Assert.assertTrue(decoded.readFrom(without, 0, without.readableBytes()));
+    Assert.assertFalse(decoded.hasBaggage());
+
+    ByteBuf with = Unpooled.buffer();
+    context.writeTo(with, true);
+    Assert.assertTrue(decoded.readFrom(with, 0, with.readableBytes()));
+    Assert.assertEquals("r\u00e9my", toMap(decoded).get("user"));
+  }
+
+  @Test
+  public void testShouldFallBackToTextMapForUnknownFormats() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("traceid", "42");
+    context.put("spanid", "7");
+    Assert.assertFalse(context.isValid());
+
+    ByteBuf encoded =
+        new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT)
+            .encode(Unpooled.EMPTY_BUFFER, context, "HelloService", "hello");
+    try {
+      Assert.assertFalse(Metadata.hasBinaryTracing(encoded));
+      Map<String, String> tracing = Tracing.byteBufToMap(Metadata.getTracing(encoded));
+      Assert.assertEquals("42", tracing.get("traceid"));
+      Assert.assertEquals("7", tracing.get("spanid"));
+    } finally {
+      encoded.release();
+    }
+  }
+
+  @Test
+  public void testShouldEncodeTextMapTracingByDefault() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("traceparent", TRACEPARENT);
+    context.put("user", "remy");
+
+    ByteBuf encoded =
+        new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT)
+            .encode(Unpooled.EMPTY_BUFFER, context, "HelloService", "hello");
+    try {
+      // Decoders that predate the binary layout read the section as a text map
+      Assert.assertFalse(Metadata.hasBinaryTracing(encoded));
+      Map<String, String> tracing = Tracing.byteBufToMap(Metadata.getTracing(encoded));
+      Assert.assertEquals(TRACEPARENT, tracing.get("traceparent"));
+      Assert.assertEquals("remy", tracing.get("user"));
+    } finally {
+      encoded.release();
+    }
+  }
+
+  @Test
+  public void testShouldEncodeBinaryTracingInMetadata() {
+    BinaryTraceContext context = new BinaryTraceContext();
+    context.put("traceparent", TRACEPARENT);
+
+    ByteBuf encoded =
+        new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT, true, false)
+            .encode(Unpooled.EMPTY_BUFFER, context, "HelloService", "hello");
+    try {
+      Assert.assertTrue(Metadata.hasBinaryTracing(encoded));
+      Assert.assertEquals(Metadata.VERSION, Metadata.getVersion(encoded));
+      Assert.assertEquals("hello", Metadata.getMethod(encoded));
+      ByteBuf tracing = Metadata.getTracing(encoded);
+      Assert.assertEquals(BinaryTraceContext.ENCODED_LENGTH, tracing.readableBytes());
+      Assert.assertEquals(0, Metadata.getMetadata(encoded).readableBytes());
+    } finally {
+      encoded.release();
+    }
+  }
+
+  private static Map<String, String> toMap(BinaryTraceContext context) {
+    Map<String, String> map = new HashMap<>();
+    for (Map.Entry<String, String> entry : context) {
+      map.put(entry.getKey(), entry.getValue());
+    }
+    return map;
+  }
+}
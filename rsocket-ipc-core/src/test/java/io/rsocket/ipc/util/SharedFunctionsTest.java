@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.rsocket.ipc.util;
+
+import java.lang.ref.WeakReference;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.function.Function;
+import org.junit.Assert;
+import org.junit.Test;
+
+public class SharedFunctionsTest {
+  @Test
+  public void testShouldBuildOnceOnFirstUseAndShare() {
+    Object owner = new Object();
+    AtomicInteger built = new AtomicInteger();
+
+    Function<Integer, Integer> first =
+        SharedFunctions.lazy(
+            owner,
+            "increment",
+            () -> {
+              built.incrementAndGet();
+              return (Integer i) -> i + 1;
+            });
+    Function<Integer, Integer> second =
+        SharedFunctions.lazy(owner, "increment", () -> i -> i + 2);
+
+    Assert.assertSame(first, second);
+    Assert.assertEquals(0, built.get());
+
+    Assert.assertEquals(2, first.apply(1).intValue());
+    Assert.assertEquals(3, second.apply(2).intValue());
+    Assert.assertEquals(1, built.get());
+
+    Assert.assertNotSame(first, SharedFunctions.lazy(new Object(), "increment", () -> i -> i));
+  }
+
+  @Test
+  public void testShouldNotKeepTheOwnerReachable() throws InterruptedException {
+    WeakReference<Object> owner = shareFunctionOfOwner();
+
+    for (int i = 0; i < 100 && owner.get() != null; i++) {
+      System.gc();
+      Thread.sleep(10);
+    }
+    Assert.assertNull(owner.get());
+  }
+
+  private static WeakReference<Object> shareFunctionOfOwner() {
+    Object owner = new Object();
+    // Like the functions of a registry or tracer, this one references its owner
+    Function<Object, Boolean> function = SharedFunctions.lazy(owner, "owner", () -> owner::equals);
+    Assert.assertTrue(function.apply(owner));
+    return new WeakReference<>(owner);
+  }
+}
@@ -0,0 +1,53 @@
+package io.rsocket.graphql;
+
+import graphql.execution.preparsed.PreparsedDocumentEntry;
+import java.util.LinkedHashMap;
+import java.util.Map;
+
+/**
+ * LRU cache of parsed and validated documents, keyed by the {@link Util#queryHash(String) hash} of
+ * their query. It also backs persisted queries, for which clients only send the hash of a query
+ * they sent before. Documents are validated against a single schema, so every schema needs a cache
+ * of its own.
+ */
+final class DocumentCache {
+  static final int DEFAULT_MAXIMUM_SIZE = 1024;
+
+  private final Map<String, Document> documents;
+
+  DocumentCache(int maximumSize) {
+    this.documents =
+        new LinkedHashMap<String, Document>(16, 0.75f, true) {
+          private static final long serialVersionUID = 1;
+
+          @Override
+          protected boolean removeEldestEntry(Map.Entry<String, Document> eldest) {
+            return size() > maximumSize;
+          }
+        };
+  }
+
+  /** @return the document of the query with the given hash, or null if it is not cached */
+  Document get(String hash) {
+    synchronized (documents) {
+      return documents.get(hash);
+    }
+  }
+
+  PreparsedDocumentEntry put(String hash, String query, PreparsedDocumentEntry entry) {
+    synchronized (documents) {
+      documents.put(hash, new Document(query, entry));
+    }
+    return entry;
+  }
+
+  static final class Document {
+    final String query;
+    final PreparsedDocumentEntry entry;
+
+    private Document(String query, PreparsedDocumentEntry entry) {
+      this.query = query;
+      this.entry = entry;
+    }
+  }
+}
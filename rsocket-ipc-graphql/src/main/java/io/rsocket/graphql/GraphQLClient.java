@@ -50,6 +50,12 @@ public final class GraphQLClient {
   }
 
   public interface C<T> {
+    /**
+     * Sends queries as persisted queries: after the first request only the hash of a query is
+     * sent, the server keeps the parsed document.
+     */
+    C<T> persistedQueries();
+
     Query<T> query();
 
     Mutate<T> mutate();
@@ -65,6 +71,7 @@ public final class GraphQLClient {
     private RSocket rsocket;
     private MeterRegistry meterRegistry;
     private Tracer tracer;
+    private boolean persistedQueries;
 
     private Builder(final String service) {
       this.service = service;
@@ -154,9 +161,18 @@ public final class GraphQLClient {
       return p.marshall(marshaller).unmarshall(unmarshaller);
     }
 
+    @Override
+    public C<O> persistedQueries() {
+      this.persistedQueries = true;
+      return this;
+    }
+
     @Override
     public Query<O> query() {
       Functions.RequestResponse query = client().requestResponse("Query");
+      if (persistedQueries) {
+        query = PersistedQueries.requestResponse(query);
+      }
 
       return query::apply;
     }
@@ -164,6 +180,9 @@ public final class GraphQLClient {
     @Override
     public Mutate<O> mutate() {
       Functions.RequestResponse mutate = client().requestResponse("Mutate");
+      if (persistedQueries) {
+        mutate = PersistedQueries.requestResponse(mutate);
+      }
 
       return mutate::apply;
     }
@@ -171,6 +190,9 @@ public final class GraphQLClient {
     @Override
     public Subscription<O> subscription() {
       Functions.RequestStream subscription = client().requestStream("Subscription");
+      if (persistedQueries) {
+        subscription = PersistedQueries.requestStream(subscription);
+      }
 
       return subscription::apply;
     }
@@ -5,6 +5,8 @@ import java.util.List;
 
 public class GraphQLErrorException extends Exception {
   private static final long serialVersionUID = 1;
+  /** Start of the message sent back when a persisted query is not known to the server. */
+  public static final String PERSISTED_QUERY_NOT_FOUND = "PersistedQueryNotFound";
 
   private GraphQLErrorException(String message) {
     super(message);
@@ -23,4 +25,8 @@ public class GraphQLErrorException extends Exception {
 
     return new GraphQLErrorException(errorMessages.toString());
   }
+
+  public static GraphQLErrorException persistedQueryNotFound(String hash) {
+    return new GraphQLErrorException(PERSISTED_QUERY_NOT_FOUND + ": " + hash);
+  }
 }
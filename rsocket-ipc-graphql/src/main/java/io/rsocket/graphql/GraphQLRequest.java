@@ -1,15 +1,20 @@
 package io.rsocket.graphql;
 
 import com.fasterxml.jackson.annotation.JsonIgnoreProperties;
+import com.fasterxml.jackson.annotation.JsonInclude;
 import com.fasterxml.jackson.databind.annotation.JsonDeserialize;
 import java.util.HashMap;
 import java.util.Map;
 
 /** @author Andrew Potter */
 @JsonIgnoreProperties(ignoreUnknown = true)
+@JsonInclude(JsonInclude.Include.NON_NULL)
 public class GraphQLRequest {
   private String query;
 
+  // Hex encoded SHA-256 hash of the query. Sent without the query once the server has seen it.
+  private String queryHash;
+
   @JsonDeserialize(using = VariablesDeserializer.class)
   private Map<String, Object> variables = new HashMap<>();
 
@@ -33,6 +38,14 @@ public class GraphQLRequest {
     this.query = query;
   }
 
+  public String getQueryHash() {
+    return queryHash;
+  }
+
+  public void setQueryHash(String queryHash) {
+    this.queryHash = queryHash;
+  }
+
   public Map<String, Object> getVariables() {
     return variables;
   }
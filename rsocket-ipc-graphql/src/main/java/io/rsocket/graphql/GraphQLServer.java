@@ -60,6 +60,12 @@ public final class GraphQLServer {
   }
 
   public interface T<O> {
+    /**
+     * Sets how many parsed and validated queries are kept per schema, 1024 by default. Persisted
+     * queries are looked up in the same cache.
+     */
+    T<O> documentCache(int maximumSize);
+
     IPCRSocket toIPCRSocket();
   }
 
@@ -73,6 +79,7 @@ public final class GraphQLServer {
     private GraphQLSchema readOnlySchema;
     private MeterRegistry meterRegistry;
     private Tracer tracer;
+    private int documentCacheSize = DocumentCache.DEFAULT_MAXIMUM_SIZE;
 
     private Builder(String service) {
       this.service = service;
@@ -134,6 +141,15 @@ public final class GraphQLServer {
       return this;
     }
 
+    @Override
+    public T documentCache(int maximumSize) {
+      if (maximumSize < 0) {
+        throw new IllegalArgumentException("maximumSize must not be negative");
+      }
+      this.documentCacheSize = maximumSize;
+      return this;
+    }
+
     @Override
     public IPCRSocket toIPCRSocket() {
       Server.M service = Server.service(this.service);
@@ -152,17 +168,24 @@ public final class GraphQLServer {
         p = t.noTracer();
       }
 
+      // Mutations and subscriptions are validated against the same schema, queries against the
+      // read only one
+      DocumentCache readOnlyDocuments = new DocumentCache(documentCacheSize);
+      DocumentCache documents = new DocumentCache(documentCacheSize);
+
       return p.marshall(marshaller)
           .unmarshall(unmarshaller)
           .requestResponse(
               "Query",
-              new GraphQLServerRequestResponse(dataLoadRegistry, instrumentation, readOnlySchema))
+              new GraphQLServerRequestResponse(
+                  dataLoadRegistry, instrumentation, readOnlySchema, readOnlyDocuments))
           .requestResponse(
               "Mutation",
-              new GraphQLServerRequestResponse(dataLoadRegistry, instrumentation, schema))
+              new GraphQLServerRequestResponse(
+                  dataLoadRegistry, instrumentation, schema, documents))
           .requestStream(
               "Subscription",
-              new GraphQLServerRequestStream(dataLoadRegistry, instrumentation, schema))
+              new GraphQLServerRequestStream(dataLoadRegistry, instrumentation, schema, documents))
           .toIPCRSocket();
     }
 
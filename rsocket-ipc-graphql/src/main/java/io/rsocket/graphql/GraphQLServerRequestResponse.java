@@ -17,19 +17,25 @@ class GraphQLServerRequestResponse implements Functions.RequestResponse<GraphQLR
   private final DataLoaderRegistry registry;
   private final Instrumentation instrumentation;
   private final GraphQLSchema graphQLSchema;
+  private final DocumentCache documents;
 
   GraphQLServerRequestResponse(
-      DataLoaderRegistry registry, Instrumentation instrumentation, GraphQLSchema graphQLSchema) {
+      DataLoaderRegistry registry,
+      Instrumentation instrumentation,
+      GraphQLSchema graphQLSchema,
+      DocumentCache documents) {
     this.registry = registry;
     this.instrumentation = instrumentation;
     this.graphQLSchema = graphQLSchema;
+    this.documents = documents;
   }
 
   @Override
   public Mono<Object> apply(GraphQLRequest request, ByteBuf byteBuf) {
     try {
       CompletableFuture<ExecutionResult> result =
-          Util.executeGraphQLRequest(request, byteBuf, registry, graphQLSchema, instrumentation);
+          Util.executeGraphQLRequest(
+              request, byteBuf, registry, graphQLSchema, instrumentation, documents);
 
       return Mono.fromFuture(result)
           .flatMap(
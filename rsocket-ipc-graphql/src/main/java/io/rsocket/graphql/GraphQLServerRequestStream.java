@@ -18,12 +18,17 @@ class GraphQLServerRequestStream implements Functions.RequestStream<GraphQLReque
   private final DataLoaderRegistry registry;
   private final Instrumentation instrumentation;
   private final GraphQLSchema graphQLSchema;
+  private final DocumentCache documents;
 
   GraphQLServerRequestStream(
-      DataLoaderRegistry registry, Instrumentation instrumentation, GraphQLSchema graphQLSchema) {
+      DataLoaderRegistry registry,
+      Instrumentation instrumentation,
+      GraphQLSchema graphQLSchema,
+      DocumentCache documents) {
     this.registry = registry;
     this.instrumentation = instrumentation;
     this.graphQLSchema = graphQLSchema;
+    this.documents = documents;
   }
 
   @Override
@@ -31,7 +36,8 @@ class GraphQLServerRequestStream implements Functions.RequestStream<GraphQLReque
     try {
 
       CompletableFuture<ExecutionResult> result =
-          Util.executeGraphQLRequest(request, byteBuf, registry, graphQLSchema, instrumentation);
+          Util.executeGraphQLRequest(
+              request, byteBuf, registry, graphQLSchema, instrumentation, documents);
 
       return Mono.fromFuture(result)
           .flatMapMany(
@@ -0,0 +1,84 @@
+package io.rsocket.graphql;
+
+import io.netty.buffer.ByteBuf;
+import io.rsocket.ipc.Functions;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.function.BiFunction;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Sends queries as persisted queries. A query goes out in full along with its hash the first
+ * time, afterwards only its hash is sent. If the server no longer knows the hash, the request is
+ * sent again in full.
+ */
+final class PersistedQueries {
+  // Hashes of the queries the server answered
+  private final Set<String> known = ConcurrentHashMap.newKeySet();
+
+  static <O> Functions.RequestResponse<GraphQLRequest, O> requestResponse(
+      Functions.RequestResponse<GraphQLRequest, O> requestResponse) {
+    PersistedQueries queries = new PersistedQueries();
+    return (request, metadata) ->
+        Mono.fromDirect(queries.send(request, metadata, requestResponse::apply));
+  }
+
+  static <O> Functions.RequestStream<GraphQLRequest, O> requestStream(
+      Functions.RequestStream<GraphQLRequest, O> requestStream) {
+    PersistedQueries queries = new PersistedQueries();
+    return (request, metadata) ->
+        Flux.from(queries.send(request, metadata, requestStream::apply));
+  }
+
+  private <O> Publisher<O> send(
+      GraphQLRequest request,
+      ByteBuf metadata,
+      BiFunction<GraphQLRequest, ByteBuf, Publisher<O>> send) {
+    String query = request.getQuery();
+    if (query == null) {
+      return send.apply(request, metadata);
+    }
+
+    String hash = Util.queryHash(query);
+    if (!known.contains(hash)) {
+      return remember(send.apply(copy(request, query, hash), metadata), hash);
+    }
+
+    // The metadata is released by every attempt, keep it for the retry
+    metadata.retain();
+    boolean[] retried = new boolean[1];
+    return Flux.from(send.apply(copy(request, null, hash), metadata))
+        .onErrorResume(
+            PersistedQueries::isNotFound,
+            t -> {
+              retried[0] = true;
+              known.remove(hash);
+              return remember(send.apply(copy(request, query, hash), metadata), hash);
+            })
+        .doFinally(
+            signal -> {
+              if (!retried[0]) {
+                metadata.release();
+              }
+            });
+  }
+
+  // The server cached the query once it answered
+  private <O> Flux<O> remember(Publisher<O> response, String hash) {
+    return Flux.from(response).doOnNext(o -> known.add(hash)).doOnComplete(() -> known.add(hash));
+  }
+
+  private static boolean isNotFound(Throwable t) {
+    String message = t.getMessage();
+    return message != null && message.contains(GraphQLErrorException.PERSISTED_QUERY_NOT_FOUND);
+  }
+
+  private static GraphQLRequest copy(GraphQLRequest request, String query, String hash) {
+    GraphQLRequest copy =
+        new GraphQLRequest(query, request.getVariables(), request.getOperationName());
+    copy.setQueryHash(hash);
+    return copy;
+  }
+}
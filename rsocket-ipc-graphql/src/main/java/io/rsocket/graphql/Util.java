@@ -7,10 +7,24 @@ import graphql.execution.ExecutionId;
 import graphql.execution.instrumentation.Instrumentation;
 import graphql.schema.GraphQLSchema;
 import io.netty.buffer.ByteBuf;
+import java.nio.charset.StandardCharsets;
+import java.security.MessageDigest;
+import java.security.NoSuchAlgorithmException;
 import java.util.concurrent.CompletableFuture;
 import org.dataloader.DataLoaderRegistry;
 
 class Util {
+  private static final char[] HEX = "0123456789abcdef".toCharArray();
+  private static final ThreadLocal<MessageDigest> SHA_256 =
+      ThreadLocal.withInitial(
+          () -> {
+            try {
+              return MessageDigest.getInstance("SHA-256");
+            } catch (NoSuchAlgorithmException e) {
+              throw new IllegalStateException(e);
+            }
+          });
+
   private Util() {}
 
   static CompletableFuture<ExecutionResult> executeGraphQLRequest(
@@ -18,10 +32,42 @@ class Util {
       ByteBuf byteBuf,
       DataLoaderRegistry registry,
       GraphQLSchema graphQLSchema,
-      Instrumentation instrumentation) {
+      Instrumentation instrumentation,
+      DocumentCache documents) {
+    GraphQL.Builder graphQL = GraphQL.newGraphQL(graphQLSchema).instrumentation(instrumentation);
+
+    String query = request.getQuery();
+    String hash = request.getQueryHash();
+    if (query != null || hash != null) {
+      DocumentCache.Document document;
+      if (query == null) {
+        // A persisted query, the client sent it along with its hash before
+        document = documents.get(hash);
+        if (document == null) {
+          return failed(GraphQLErrorException.persistedQueryNotFound(hash));
+        }
+        query = document.query;
+      } else {
+        String actual = queryHash(query);
+        if (hash != null && !hash.equals(actual)) {
+          return failed(new IllegalArgumentException("query does not match hash " + hash));
+        }
+        hash = actual;
+        document = documents.get(hash);
+      }
+
+      String key = hash;
+      graphQL.preparsedDocumentProvider(
+          (executionInput, parseAndValidate) ->
+              document != null
+                  ? document.entry
+                  : documents.put(
+                      key, executionInput.getQuery(), parseAndValidate.apply(executionInput)));
+    }
+
     ExecutionInput.Builder builder =
         ExecutionInput.newExecutionInput()
-            .query(request.getQuery())
+            .query(query)
             .operationName(request.getOperationName())
             .variables(request.getVariables())
             .context(byteBuf)
@@ -33,9 +79,23 @@ class Util {
 
     ExecutionInput executionInput = builder.build();
 
-    return GraphQL.newGraphQL(graphQLSchema)
-        .instrumentation(instrumentation)
-        .build()
-        .executeAsync(executionInput);
+    return graphQL.build().executeAsync(executionInput);
+  }
+
+  /** Hex encoded SHA-256 hash of the UTF-8 encoded query, as sent for persisted queries. */
+  static String queryHash(String query) {
+    byte[] digest = SHA_256.get().digest(query.getBytes(StandardCharsets.UTF_8));
+    char[] hex = new char[digest.length * 2];
+    for (int i = 0; i < digest.length; i++) {
+      hex[i * 2] = HEX[(digest[i] >> 4) & 0xF];
+      hex[i * 2 + 1] = HEX[digest[i] & 0xF];
+    }
+    return new String(hex);
+  }
+
+  private static CompletableFuture<ExecutionResult> failed(Throwable t) {
+    CompletableFuture<ExecutionResult> future = new CompletableFuture<>();
+    future.completeExceptionally(t);
+    return future;
   }
 }
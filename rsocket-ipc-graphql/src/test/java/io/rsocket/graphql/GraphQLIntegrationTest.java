@@ -28,6 +28,7 @@ import java.nio.file.Path;
 import java.nio.file.Paths;
 import java.util.HashMap;
 import java.util.Map;
+import org.junit.Assert;
 import org.junit.Test;
 import reactor.core.Exceptions;
 import reactor.core.publisher.Mono;
@@ -86,6 +87,62 @@ public class GraphQLIntegrationTest {
     System.out.println(book);
   }
 
+  @Test
+  public void testPersistedQuery() throws Exception {
+    RequestHandlingRSocket requestHandler = new RequestHandlingRSocket();
+
+    RSocketServer.create()
+        .acceptor((setup, sendingSocket) -> Mono.just(requestHandler))
+        .bindNow(LocalServerTransport.create("testPersistedQuery"));
+
+    RSocket rsocket =
+        RSocketConnector.connectWith(LocalClientTransport.create("testPersistedQuery")).block();
+
+    String query = "{ bookById(id: \"book-1\") { id name } }";
+
+    IPCRSocket service =
+        GraphQLServer.service("books")
+            .noMeterRegistry()
+            .noTracer()
+            .marshall(Json.marshaller(Object.class))
+            .unmarshall(Json.unmarshaller(GraphQLRequest.class))
+            .noDataLoadRegister()
+            .defaultInstrumentation()
+            .schema(getGraphQLSchema())
+            .noReadOnlySchema()
+            .documentCache(16)
+            .toIPCRSocket();
+
+    requestHandler.withEndpoint(service);
+
+    GraphQLClient.Query bookQuery =
+        GraphQLClient.service("books")
+            .rsocket(rsocket)
+            .customMetadataEncoder(new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT))
+            .noMeterRegistry()
+            .noTracer()
+            .marshall(Json.marshaller(GraphQLRequest.class))
+            .unmarshall(unmarshaller())
+            .persistedQueries()
+            .query();
+
+    // The first request registers the query, the second one only sends its hash
+    for (int i = 0; i < 2; i++) {
+      GraphQLRequest request = new GraphQLRequest(query, new HashMap<>(), "");
+      GraphQLDataFetchers.Book book = (GraphQLDataFetchers.Book) bookQuery.apply(request).block();
+      Assert.assertNotNull(book);
+    }
+
+    GraphQLRequest unknown = new GraphQLRequest(null, new HashMap<>(), "");
+    unknown.setQueryHash(Util.queryHash("{ bookById(id: \"book-2\") { id } }"));
+    try {
+      bookQuery.apply(unknown).block();
+      Assert.fail("unknown persisted query should fail");
+    } catch (Exception e) {
+      Assert.assertTrue(e.getMessage().contains(GraphQLErrorException.PERSISTED_QUERY_NOT_FOUND));
+    }
+  }
+
   private static Unmarshaller<GraphQLDataFetchers.Book> unmarshaller() {
     ObjectMapper mapper = new ObjectMapper();
     mapper.registerModule(new AfterburnerModule());
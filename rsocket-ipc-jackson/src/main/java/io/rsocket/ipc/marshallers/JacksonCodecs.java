@@ -0,0 +1,169 @@
+package io.rsocket.ipc.marshallers;
+
+import com.fasterxml.jackson.databind.ObjectMapper;
+import com.fasterxml.jackson.databind.ObjectReader;
+import com.fasterxml.jackson.databind.ObjectWriter;
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.netty.buffer.ByteBufInputStream;
+import io.rsocket.ipc.Marshaller;
+import io.rsocket.ipc.Unmarshaller;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import reactor.core.Exceptions;
+
+/**
+ * Marshallers and unmarshallers backed by a single {@link ObjectMapper}. The reader and the writer
+ * of every class are looked up once and kept, and so is a rolling estimate of the serialized size
+ * that output buffers are presized with. Jackson writes into and reads from the buffers directly:
+ * heap buffers are parsed in place, direct and composite ones through their NIO buffers, and any
+ * other buffer through a stream.
+ */
+final class JacksonCodecs {
+  private final ClassValue<Codec> codecs;
+
+  JacksonCodecs(ObjectMapper mapper) {
+    this.codecs =
+        new ClassValue<Codec>() {
+          @Override
+          protected Codec computeValue(Class<?> type) {
+            return new Codec(mapper.readerFor(type), mapper.writerFor(type));
+          }
+        };
+  }
+
+  <T> Marshaller<T> marshaller(Class<T> clazz) {
+    Codec codec = codecs.get(clazz);
+    return t -> {
+      // The declared class only serves values of exactly that class, subclasses and values of an
+      // Object marshaller are written as their runtime class
+      if (t == null || t.getClass() == clazz) {
+        return codec.write(t);
+      }
+      return codecs.get(t.getClass()).write(t);
+    };
+  }
+
+  <T> Unmarshaller<T> unmarshaller(Class<T> clazz) {
+    Codec codec = codecs.get(clazz);
+    return codec::read;
+  }
+
+  private static final class Codec {
+    private static final int MIN_ESTIMATE = 64;
+    private static final int MAX_ESTIMATE = 1 << 20;
+
+    private final ObjectReader reader;
+    private final ObjectWriter writer;
+    // Moving average of the serialized sizes. Updates race, but a lost update only makes the
+    // estimate a little less accurate.
+    private int estimate = MIN_ESTIMATE;
+
+    Codec(ObjectReader reader, ObjectWriter writer) {
+      this.reader = reader;
+      this.writer = writer;
+    }
+
+    ByteBuf write(Object value) {
+      int estimate = this.estimate;
+      // Leave some headroom so values slightly above the average do not make the buffer grow
+      ByteBuf byteBuf = ByteBufAllocator.DEFAULT.buffer(estimate + (estimate >> 2));
+      try {
+        writer.writeValue(new ByteBufOutput(byteBuf), value);
+      } catch (Throwable t) {
+        byteBuf.release();
+        throw Exceptions.propagate(t);
+      }
+      int size = byteBuf.readableBytes();
+      this.estimate =
+          Math.max(MIN_ESTIMATE, Math.min(MAX_ESTIMATE, estimate + ((size - estimate) >> 3)));
+      return byteBuf;
+    }
+
+    <T> T read(ByteBuf byteBuf) {
+      try {
+        if (byteBuf.hasArray()) {
+          int offset = byteBuf.arrayOffset() + byteBuf.readerIndex();
+          return reader.readValue(byteBuf.array(), offset, byteBuf.readableBytes());
+        }
+        if (byteBuf.nioBufferCount() >= 0) {
+          return reader.readValue(new ByteBufInput(byteBuf.nioBuffers()));
+        }
+        // Buffers without NIO buffers throw from nioBuffers(), the duplicate keeps the reader index
+        return reader.readValue(new ByteBufInputStream(byteBuf.duplicate()));
+      } catch (Throwable t) {
+        throw Exceptions.propagate(t);
+      }
+    }
+  }
+
+  /**
+   * Appends to a buffer. Unlike {@link io.netty.buffer.ByteBufOutputStream} it carries no {@link
+   * java.io.DataOutput} state, Jackson only ever writes byte ranges out of its own buffer.
+   */
+  private static final class ByteBufOutput extends OutputStream {
+    private final ByteBuf byteBuf;
+
+    ByteBufOutput(ByteBuf byteBuf) {
+      this.byteBuf = byteBuf;
+    }
+
+    @Override
+    public void write(int b) {
+      byteBuf.writeByte(b);
+    }
+
+    @Override
+    public void write(byte[] b, int off, int len) {
+      byteBuf.writeBytes(b, off, len);
+    }
+  }
+
+  /** Reads the NIO buffers of a direct or composite buffer without touching its reader index. */
+  private static final class ByteBufInput extends InputStream {
+    private final ByteBuffer[] buffers;
+    private int index;
+
+    ByteBufInput(ByteBuffer[] buffers) {
+      this.buffers = buffers;
+    }
+
+    @Override
+    public int read() {
+      ByteBuffer buffer = current();
+      return buffer == null ? -1 : buffer.get() & 0xFF;
+    }
+
+    @Override
+    public int read(byte[] b, int off, int len) {
+      if (len == 0) {
+        return 0;
+      }
+      ByteBuffer buffer = current();
+      if (buffer == null) {
+        return -1;
+      }
+      int read = Math.min(len, buffer.remaining());
+      buffer.get(b, off, read);
+      return read;
+    }
+
+    @Override
+    public int available() {
+      ByteBuffer buffer = current();
+      return buffer == null ? 0 : buffer.remaining();
+    }
+
+    private ByteBuffer current() {
+      while (index < buffers.length) {
+        ByteBuffer buffer = buffers[index];
+        if (buffer.hasRemaining()) {
+          return buffer;
+        }
+        index++;
+      }
+      return null;
+    }
+  }
+}
@@ -2,23 +2,17 @@ package io.rsocket.ipc.marshallers;
 
 import com.fasterxml.jackson.databind.ObjectMapper;
 import com.fasterxml.jackson.module.afterburner.AfterburnerModule;
-import io.netty.buffer.ByteBuf;
-import io.netty.buffer.ByteBufAllocator;
-import io.netty.buffer.ByteBufInputStream;
-import io.netty.buffer.ByteBufOutputStream;
 import io.rsocket.ipc.Marshaller;
 import io.rsocket.ipc.Unmarshaller;
-import java.io.IOException;
-import java.io.InputStream;
-import java.io.OutputStream;
-import reactor.core.Exceptions;
 
 public class Json {
   private final ObjectMapper mapper;
+  private final JacksonCodecs codecs;
 
   private Json() {
     mapper = new ObjectMapper();
     mapper.registerModule(new AfterburnerModule());
+    codecs = new JacksonCodecs(mapper);
   }
 
   private static class Lazy {
@@ -29,28 +23,11 @@ public class Json {
     return Lazy.INSTANCE;
   }
 
-  @SuppressWarnings("unused")
   public static <T> Marshaller<T> marshaller(Class<T> clazz) {
-    return t -> {
-      ByteBuf byteBuf = ByteBufAllocator.DEFAULT.buffer();
-      OutputStream bos = new ByteBufOutputStream(byteBuf);
-      try {
-        Json.getInstance().mapper.writeValue(bos, t);
-      } catch (IOException e) {
-        throw Exceptions.propagate(e);
-      }
-      return byteBuf;
-    };
+    return Json.getInstance().codecs.marshaller(clazz);
   }
 
   public static <T> Unmarshaller<T> unmarshaller(Class<T> clazz) {
-    return byteBuf -> {
-      InputStream bis = new ByteBufInputStream(byteBuf);
-      try {
-        return Json.getInstance().mapper.readValue(bis, clazz);
-      } catch (Throwable t) {
-        throw Exceptions.propagate(t);
-      }
-    };
+    return Json.getInstance().codecs.unmarshaller(clazz);
   }
 }
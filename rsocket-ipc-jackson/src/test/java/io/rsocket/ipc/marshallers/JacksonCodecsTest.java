@@ -0,0 +1,122 @@
+package io.rsocket.ipc.marshallers;
+
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.netty.buffer.CompositeByteBuf;
+import io.netty.buffer.Unpooled;
+import io.netty.buffer.WrappedByteBuf;
+import io.rsocket.ipc.Marshaller;
+import io.rsocket.ipc.Unmarshaller;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import java.util.List;
+import org.junit.Assert;
+import org.junit.Test;
+
+public class JacksonCodecsTest {
+  private static final Marshaller<Message> JSON_MARSHALLER = Json.marshaller(Message.class);
+  private static final Unmarshaller<Message> JSON_UNMARSHALLER = Json.unmarshaller(Message.class);
+
+  @Test
+  public void testShouldRoundTripHeapBuffer() {
+    assertRoundTrip(Unpooled::copiedBuffer);
+  }
+
+  @Test
+  public void testShouldRoundTripDirectBuffer() {
+    assertRoundTrip(
+        bytes -> ByteBufAllocator.DEFAULT.directBuffer(bytes.length).writeBytes(bytes));
+  }
+
+  @Test
+  public void testShouldRoundTripCompositeBuffer() {
+    assertRoundTrip(
+        bytes -> {
+          int half = bytes.length / 2;
+          CompositeByteBuf composite = Unpooled.compositeBuffer();
+          composite.addComponent(true, Unpooled.copiedBuffer(bytes, 0, half));
+          composite.addComponent(
+              true,
+              Unpooled.directBuffer(bytes.length - half)
+                  .writeBytes(bytes, half, bytes.length - half));
+          return composite;
+        });
+  }
+
+  @Test
+  public void testShouldRoundTripBufferWithoutNioBuffers() {
+    assertRoundTrip(
+        bytes ->
+            new WrappedByteBuf(Unpooled.directBuffer(bytes.length).writeBytes(bytes)) {
+              @Override
+              public int nioBufferCount() {
+                return -1;
+              }
+
+              @Override
+              public ByteBuffer[] nioBuffers() {
+                throw new UnsupportedOperationException();
+              }
+            });
+  }
+
+  @Test
+  public void testShouldRoundTripCbor() {
+    Message message = Message.of("cbor", 7, Arrays.asList("a", "b"));
+    ByteBuf encoded = Cbor.marshaller(Message.class).apply(message);
+    try {
+      Assert.assertEquals(message, Cbor.unmarshaller(Message.class).apply(encoded));
+    } finally {
+      encoded.release();
+    }
+  }
+
+  private static void assertRoundTrip(Copier copier) {
+    Message message = Message.of("d\u00e9j\u00e0 vu", 42, Arrays.asList("x", "y", "z"));
+    ByteBuf encoded = JSON_MARSHALLER.apply(message);
+    byte[] bytes = new byte[encoded.readableBytes()];
+    encoded.readBytes(bytes);
+    encoded.release();
+
+    ByteBuf byteBuf = copier.copy(bytes);
+    try {
+      int readerIndex = byteBuf.readerIndex();
+      Assert.assertEquals(message, JSON_UNMARSHALLER.apply(byteBuf));
+      Assert.assertEquals(readerIndex, byteBuf.readerIndex());
+    } finally {
+      byteBuf.release();
+    }
+  }
+
+  private interface Copier {
+    ByteBuf copy(byte[] bytes);
+  }
+
+  public static class Message {
+    public String name;
+    public int count;
+    public List<String> tags;
+
+    static Message of(String name, int count, List<String> tags) {
+      Message message = new Message();
+      message.name = name;
+      message.count = count;
+      message.tags = tags;
+      return message;
+    }
+
+    @Override
+    public boolean equals(Object o) {
+      if (!(o instanceof Message)) {
+        return false;
+      }
+      Message other = (Message) o;
+      return name.equals(other.name) && count == other.count && tags.equals(other.tags);
+    }
+
+    @Override
+    public int hashCode() {
+      return name.hashCode() * 31 + count;
+    }
+  }
+}
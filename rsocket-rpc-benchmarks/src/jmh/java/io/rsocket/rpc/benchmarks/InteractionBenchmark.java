@@ -0,0 +1,163 @@
+package io.rsocket.rpc.benchmarks;
+
+import brave.Tracing;
+import brave.opentracing.BraveTracer;
+import com.google.protobuf.ByteString;
+import io.micrometer.core.instrument.MeterRegistry;
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry;
+import io.opentracing.Tracer;
+import io.rsocket.Closeable;
+import io.rsocket.RSocket;
+import io.rsocket.SocketAcceptor;
+import io.rsocket.core.RSocketConnector;
+import io.rsocket.core.RSocketServer;
+import io.rsocket.frame.decoder.PayloadDecoder;
+import io.rsocket.transport.local.LocalClientTransport;
+import io.rsocket.transport.local.LocalServerTransport;
+import io.rsocket.transport.netty.client.TcpClientTransport;
+import io.rsocket.transport.netty.server.CloseableChannel;
+import io.rsocket.transport.netty.server.TcpServerTransport;
+import java.util.UUID;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+import zipkin2.reporter.Reporter;
+
+/**
+ * Runs one call of every interaction model against an echo service over a real RSocket
+ * connection. Subclasses plug in the client and server under test. Throughput runs report the
+ * bytes allocated per call with the gc profiler, sample time runs the latency percentiles; a call
+ * of the stream and channel benchmarks moves {@code streamSize} messages.
+ */
+@BenchmarkMode({Mode.Throughput, Mode.SampleTime})
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(value = 1, jvmArgsAppend = "-Dio.netty.leakDetection.level=disabled")
+@State(Scope.Benchmark)
+public abstract class InteractionBenchmark {
+  @Param({"local", "tcp"})
+  public String transport;
+
+  @Param({"false", "true"})
+  public boolean instrumented;
+
+  @Param({"100"})
+  public int streamSize;
+
+  protected MeterRegistry registry;
+  protected Tracer tracer;
+
+  private Tracing tracing;
+  private Closeable server;
+  private RSocket rSocket;
+  private BenchmarkRequest request;
+  private BenchmarkRequest streamRequest;
+  private Flux<BenchmarkRequest> channelRequests;
+
+  @Setup
+  public void setup() {
+    if (instrumented) {
+      registry = new SimpleMeterRegistry();
+      tracing = Tracing.newBuilder().spanReporter(Reporter.NOOP).build();
+      tracer = BraveTracer.create(tracing);
+    }
+
+    request =
+        BenchmarkRequest.newBuilder()
+            .setId(1)
+            .setMessage("benchmark")
+            .setBody(ByteString.copyFrom(new byte[128]))
+            .build();
+    streamRequest = request.toBuilder().setId(streamSize).build();
+    channelRequests = Flux.range(0, streamSize).map(i -> request);
+
+    SocketAcceptor acceptor = SocketAcceptor.with(handler());
+    switch (transport) {
+      case "local":
+        String name = "benchmark-" + UUID.randomUUID();
+        server =
+            RSocketServer.create(acceptor)
+                .payloadDecoder(PayloadDecoder.ZERO_COPY)
+                .bind(LocalServerTransport.create(name))
+                .block();
+        rSocket =
+            RSocketConnector.create()
+                .payloadDecoder(PayloadDecoder.ZERO_COPY)
+                .connect(LocalClientTransport.create(name))
+                .block();
+        break;
+      case "tcp":
+        CloseableChannel channel =
+            RSocketServer.create(acceptor)
+                .payloadDecoder(PayloadDecoder.ZERO_COPY)
+                .bind(TcpServerTransport.create("localhost", 0))
+                .block();
+        server = channel;
+        rSocket =
+            RSocketConnector.create()
+                .payloadDecoder(PayloadDecoder.ZERO_COPY)
+                .connect(TcpClientTransport.create(channel.address()))
+                .block();
+        break;
+      default:
+        throw new IllegalArgumentException("unknown transport " + transport);
+    }
+    connected(rSocket);
+  }
+
+  @TearDown
+  public void tearDown() {
+    rSocket.dispose();
+    server.dispose();
+    if (tracing != null) {
+      tracing.close();
+    }
+  }
+
+  /** @return the server side of the connection, built with {@link #registry} and {@link #tracer} */
+  protected abstract RSocket handler();
+
+  /** Builds the client under test, with {@link #registry} and {@link #tracer}. */
+  protected abstract void connected(RSocket rSocket);
+
+  protected abstract Mono<Void> doFireAndForget(BenchmarkRequest request);
+
+  protected abstract Mono<BenchmarkResponse> doRequestResponse(BenchmarkRequest request);
+
+  protected abstract Flux<BenchmarkResponse> doRequestStream(BenchmarkRequest request);
+
+  protected abstract Flux<BenchmarkResponse> doRequestChannel(Flux<BenchmarkRequest> requests);
+
+  @Benchmark
+  public void fireAndForget() {
+    doFireAndForget(request).block();
+  }
+
+  @Benchmark
+  public BenchmarkResponse requestResponse() {
+    return doRequestResponse(request).block();
+  }
+
+  @Benchmark
+  public BenchmarkResponse requestStream() {
+    return doRequestStream(streamRequest).blockLast();
+  }
+
+  @Benchmark
+  public BenchmarkResponse requestChannel() {
+    return doRequestChannel(channelRequests).blockLast();
+  }
+}
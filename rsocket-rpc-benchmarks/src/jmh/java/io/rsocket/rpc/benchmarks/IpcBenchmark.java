@@ -0,0 +1,111 @@
+package io.rsocket.rpc.benchmarks;
+
+import com.google.protobuf.InvalidProtocolBufferException;
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.ByteBufAllocator;
+import io.rsocket.RSocket;
+import io.rsocket.ipc.Client;
+import io.rsocket.ipc.Functions;
+import io.rsocket.ipc.RequestHandlingRSocket;
+import io.rsocket.ipc.Server;
+import io.rsocket.ipc.decoders.CompositeMetadataDecoder;
+import io.rsocket.ipc.encoders.DefaultMetadataEncoder;
+import io.rsocket.ipc.marshallers.Protobuf;
+import reactor.core.Exceptions;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/** The same workload as {@link RpcBenchmark} through the {@link Client} and {@link Server}. */
+public class IpcBenchmark extends InteractionBenchmark {
+  private static final String SERVICE = BenchmarkService.SERVICE;
+
+  private Functions.FireAndForget<BenchmarkRequest> fireAndForget;
+  private Functions.RequestResponse<BenchmarkRequest, BenchmarkResponse> requestResponse;
+  private Functions.RequestStream<BenchmarkRequest, BenchmarkResponse> requestStream;
+  private Functions.RequestChannel<BenchmarkRequest, BenchmarkResponse> requestChannel;
+
+  @Override
+  protected RSocket handler() {
+    Server.M service = Server.service(SERVICE);
+    Server.T metered =
+        registry == null ? service.noMeterRegistry() : service.meterRegistry(registry);
+    Server.P traced = tracer == null ? metered.noTracer() : metered.tracer(tracer);
+    return new RequestHandlingRSocket(new CompositeMetadataDecoder())
+        .withEndpoint(
+            traced
+                .marshall(Protobuf.marshaller(BenchmarkResponse.class))
+                .unmarshall(Protobuf.unmarshaller(IpcBenchmark::parseRequest))
+                .fireAndForget(
+                    BenchmarkService.METHOD_FIRE_AND_FORGET, (request, metadata) -> Mono.empty())
+                .requestResponse(
+                    BenchmarkService.METHOD_REQUEST_RESPONSE,
+                    (request, metadata) -> Mono.just(DefaultBenchmarkService.response(request)))
+                .requestStream(
+                    BenchmarkService.METHOD_REQUEST_STREAM,
+                    (request, metadata) -> {
+                      BenchmarkResponse response = DefaultBenchmarkService.response(request);
+                      return Flux.range(0, request.getId()).map(i -> response);
+                    })
+                .requestChannel(
+                    BenchmarkService.METHOD_REQUEST_CHANNEL,
+                    (request, requests, metadata) ->
+                        Flux.from(requests).map(DefaultBenchmarkService::response))
+                .toIPCRSocket());
+  }
+
+  @Override
+  protected void connected(RSocket rSocket) {
+    Client.M service =
+        Client.service(SERVICE)
+            .rsocket(rSocket)
+            .customMetadataEncoder(new DefaultMetadataEncoder(ByteBufAllocator.DEFAULT));
+    Client.T metered =
+        registry == null ? service.noMeterRegistry() : service.meterRegistry(registry);
+    Client.P traced = tracer == null ? metered.noTracer() : metered.tracer(tracer);
+    Client<BenchmarkRequest, BenchmarkResponse> client =
+        traced
+            .marshall(Protobuf.marshaller(BenchmarkRequest.class))
+            .unmarshall(Protobuf.unmarshaller(IpcBenchmark::parseResponse));
+
+    fireAndForget = client.fireAndForget(BenchmarkService.METHOD_FIRE_AND_FORGET);
+    requestResponse = client.requestResponse(BenchmarkService.METHOD_REQUEST_RESPONSE);
+    requestStream = client.requestStream(BenchmarkService.METHOD_REQUEST_STREAM);
+    requestChannel = client.requestChannel(BenchmarkService.METHOD_REQUEST_CHANNEL);
+  }
+
+  @Override
+  protected Mono<Void> doFireAndForget(BenchmarkRequest request) {
+    return fireAndForget.apply(request);
+  }
+
+  @Override
+  protected Mono<BenchmarkResponse> doRequestResponse(BenchmarkRequest request) {
+    return requestResponse.apply(request);
+  }
+
+  @Override
+  protected Flux<BenchmarkResponse> doRequestStream(BenchmarkRequest request) {
+    return requestStream.apply(request);
+  }
+
+  @Override
+  protected Flux<BenchmarkResponse> doRequestChannel(Flux<BenchmarkRequest> requests) {
+    return requestChannel.apply(requests);
+  }
+
+  private static BenchmarkRequest parseRequest(ByteBuf byteBuf) {
+    try {
+      return BenchmarkRequest.parseFrom(byteBuf.nioBuffer());
+    } catch (InvalidProtocolBufferException e) {
+      throw Exceptions.propagate(e);
+    }
+  }
+
+  private static BenchmarkResponse parseResponse(ByteBuf byteBuf) {
+    try {
+      return BenchmarkResponse.parseFrom(byteBuf.nioBuffer());
+    } catch (InvalidProtocolBufferException e) {
+      throw Exceptions.propagate(e);
+    }
+  }
+}
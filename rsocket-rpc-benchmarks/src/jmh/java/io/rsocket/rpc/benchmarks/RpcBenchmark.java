@@ -0,0 +1,58 @@
+package io.rsocket.rpc.benchmarks;
+
+import io.rsocket.RSocket;
+import io.rsocket.rpc.rsocket.RequestHandlingRSocket;
+import java.util.Optional;
+import org.openjdk.jmh.annotations.Param;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * The generated {@link BenchmarkServiceClient} and {@link BenchmarkServiceServer}. With {@code
+ * reuseBuilders} the service reads requests from the builders the server reuses instead of having
+ * them built into messages, the gc profiler shows the difference in bytes allocated per call.
+ */
+public class RpcBenchmark extends InteractionBenchmark {
+  @Param({"false", "true"})
+  public boolean reuseBuilders;
+
+  private BenchmarkServiceClient client;
+
+  @Override
+  protected RSocket handler() {
+    return new RequestHandlingRSocket(
+        new BenchmarkServiceServer(
+            reuseBuilders ? new BuilderReadingBenchmarkService() : new DefaultBenchmarkService(),
+            Optional.empty(),
+            Optional.ofNullable(registry),
+            Optional.ofNullable(tracer)));
+  }
+
+  @Override
+  protected void connected(RSocket rSocket) {
+    client =
+        instrumented
+            ? new BenchmarkServiceClient(rSocket, registry, tracer)
+            : new BenchmarkServiceClient(rSocket);
+  }
+
+  @Override
+  protected Mono<Void> doFireAndForget(BenchmarkRequest request) {
+    return client.fireAndForget(request);
+  }
+
+  @Override
+  protected Mono<BenchmarkResponse> doRequestResponse(BenchmarkRequest request) {
+    return client.requestResponse(request);
+  }
+
+  @Override
+  protected Flux<BenchmarkResponse> doRequestStream(BenchmarkRequest request) {
+    return client.requestStream(request);
+  }
+
+  @Override
+  protected Flux<BenchmarkResponse> doRequestChannel(Flux<BenchmarkRequest> requests) {
+    return client.requestChannel(requests);
+  }
+}
@@ -0,0 +1,126 @@
+package io.rsocket.rpc.benchmarks;
+
+import com.google.protobuf.ByteString;
+import io.rsocket.RSocket;
+import io.rsocket.SocketAcceptor;
+import io.rsocket.core.RSocketConnector;
+import io.rsocket.core.RSocketServer;
+import io.rsocket.frame.decoder.PayloadDecoder;
+import io.rsocket.ipc.percore.ThreadPerCore;
+import io.rsocket.rpc.rsocket.RequestHandlingRSocket;
+import io.rsocket.transport.netty.client.TcpClientTransport;
+import io.rsocket.transport.netty.server.CloseableChannel;
+import io.rsocket.transport.netty.server.TcpServerTransport;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OperationsPerInvocation;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import reactor.core.publisher.Flux;
+import reactor.netty.resources.LoopResources;
+import reactor.netty.tcp.TcpClient;
+import reactor.netty.tcp.TcpServer;
+
+/**
+ * Request-response throughput of a thread-per-core server over TCP loopback. The server runs
+ * {@code cores} event loops registered as {@link ThreadPerCore cores} and the client opens one
+ * connection per core, so the requests, handler and responses of a connection stay on one loop.
+ * Comparing the throughput of every {@code cores} value with 1 shows how far the server scales.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(value = 1, jvmArgsAppend = "-Dio.netty.leakDetection.level=disabled")
+@State(Scope.Benchmark)
+public class ThreadPerCoreBenchmark {
+  private static final int CALLS = 1024;
+
+  @Param({"1", "2", "4", "8"})
+  public int cores;
+
+  /** Requests in flight per connection. */
+  @Param({"64"})
+  public int concurrency;
+
+  private LoopResources serverLoops;
+  private LoopResources clientLoops;
+  private CloseableChannel server;
+  private RSocket[] rSockets;
+  private BenchmarkServiceClient[] clients;
+  private BenchmarkRequest request;
+
+  @Setup
+  public void setup() {
+    serverLoops = LoopResources.create("server-core", cores, true);
+    clientLoops = LoopResources.create("client-core", cores, true);
+
+    RequestHandlingRSocket handler =
+        new RequestHandlingRSocket(
+            new BenchmarkServiceServer(
+                new DefaultBenchmarkService(),
+                Optional.empty(),
+                Optional.empty(),
+                Optional.empty()));
+    TcpServer tcpServer =
+        TcpServer.create()
+            .host("localhost")
+            .port(0)
+            .runOn(serverLoops)
+            // Connections are spread over the loops, each registers before serving its first one
+            .doOnConnection(
+                connection -> ThreadPerCore.register(connection.channel().eventLoop()));
+    server =
+        RSocketServer.create(SocketAcceptor.with(handler))
+            .payloadDecoder(PayloadDecoder.ZERO_COPY)
+            .bind(TcpServerTransport.create(tcpServer))
+            .block();
+
+    TcpClient tcpClient = TcpClient.create().remoteAddress(server::address).runOn(clientLoops);
+    rSockets = new RSocket[cores];
+    clients = new BenchmarkServiceClient[cores];
+    for (int i = 0; i < cores; i++) {
+      rSockets[i] =
+          RSocketConnector.create()
+              .payloadDecoder(PayloadDecoder.ZERO_COPY)
+              .connect(TcpClientTransport.create(tcpClient))
+              .block();
+      clients[i] = new BenchmarkServiceClient(rSockets[i]);
+    }
+
+    request =
+        BenchmarkRequest.newBuilder()
+            .setId(1)
+            .setMessage("benchmark")
+            .setBody(ByteString.copyFrom(new byte[128]))
+            .build();
+  }
+
+  @TearDown
+  public void tearDown() {
+    for (RSocket rSocket : rSockets) {
+      rSocket.dispose();
+    }
+    server.dispose();
+    clientLoops.disposeLater().block();
+    serverLoops.disposeLater().block();
+  }
+
+  @Benchmark
+  @OperationsPerInvocation(CALLS)
+  public void requestResponse() {
+    Flux.range(0, CALLS)
+        .flatMap(i -> clients[i % cores].requestResponse(request), concurrency * cores)
+        .blockLast();
+  }
+}
@@ -0,0 +1,30 @@
+package io.rsocket.rpc.benchmarks;
+
+import io.netty.buffer.ByteBuf;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/**
+ * Echoes requests back like {@link DefaultBenchmarkService}, but reads them straight from the
+ * builders the server reuses. The response is built before returning, so nothing reads a builder
+ * after the server has handed it to the next request.
+ */
+public class BuilderReadingBenchmarkService extends DefaultBenchmarkService {
+  @Override
+  public Mono<Void> fireAndForget(BenchmarkRequestOrBuilder message, ByteBuf metadata) {
+    return Mono.empty();
+  }
+
+  @Override
+  public Mono<BenchmarkResponse> requestResponse(
+      BenchmarkRequestOrBuilder message, ByteBuf metadata) {
+    return Mono.just(response(message));
+  }
+
+  @Override
+  public Flux<BenchmarkResponse> requestStream(
+      BenchmarkRequestOrBuilder message, ByteBuf metadata) {
+    BenchmarkResponse response = response(message);
+    return Flux.range(0, message.getId()).map(i -> response);
+  }
+}
@@ -0,0 +1,39 @@
+package io.rsocket.rpc.benchmarks;
+
+import io.netty.buffer.ByteBuf;
+import org.reactivestreams.Publisher;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+
+/** Echoes requests back, so the benchmarks measure the RPC layers rather than the service. */
+public class DefaultBenchmarkService implements BenchmarkService {
+  @Override
+  public Mono<Void> fireAndForget(BenchmarkRequest message, ByteBuf metadata) {
+    return Mono.empty();
+  }
+
+  @Override
+  public Mono<BenchmarkResponse> requestResponse(BenchmarkRequest message, ByteBuf metadata) {
+    return Mono.just(response(message));
+  }
+
+  @Override
+  public Flux<BenchmarkResponse> requestStream(BenchmarkRequest message, ByteBuf metadata) {
+    BenchmarkResponse response = response(message);
+    return Flux.range(0, message.getId()).map(i -> response);
+  }
+
+  @Override
+  public Flux<BenchmarkResponse> requestChannel(
+      Publisher<BenchmarkRequest> messages, ByteBuf metadata) {
+    return Flux.from(messages).map(DefaultBenchmarkService::response);
+  }
+
+  public static BenchmarkResponse response(BenchmarkRequestOrBuilder request) {
+    return BenchmarkResponse.newBuilder()
+        .setId(request.getId())
+        .setMessage(request.getMessage())
+        .setBody(request.getBody())
+        .build();
+  }
+}
@@ -0,0 +1,127 @@
+package io.rsocket.rpc.benchmarks;
+
+import static reactor.core.publisher.Sinks.EmitFailureHandler.FAIL_FAST;
+
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry;
+import io.netty.buffer.ByteBuf;
+import io.netty.buffer.Unpooled;
+import io.rsocket.Closeable;
+import io.rsocket.RSocket;
+import io.rsocket.SocketAcceptor;
+import io.rsocket.core.RSocketConnector;
+import io.rsocket.core.RSocketServer;
+import io.rsocket.rpc.rsocket.RequestHandlingRSocket;
+import io.rsocket.transport.local.LocalClientTransport;
+import io.rsocket.transport.local.LocalServerTransport;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Optional;
+import java.util.UUID;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import org.junit.After;
+import org.junit.Assert;
+import org.junit.Before;
+import org.junit.Test;
+import reactor.core.publisher.Flux;
+import reactor.core.publisher.Mono;
+import reactor.core.publisher.Sinks;
+
+/** The batch methods of the generated client against the generated server. */
+public class BatchTest {
+  private static final int REQUESTS = 5;
+
+  private Closeable server;
+  private RSocket rSocket;
+  private SimpleMeterRegistry registry;
+  private BenchmarkServiceClient client;
+  private CountDownLatch arrived;
+  private List<Sinks.One<BenchmarkResponse>> responses;
+
+  @Before
+  public void setUp() {
+    arrived = new CountDownLatch(REQUESTS);
+    responses = new ArrayList<>();
+    for (int i = 0; i < REQUESTS; i++) {
+      responses.add(Sinks.one());
+    }
+    // Every request completes when the test says so, in the order the test picks
+    BenchmarkService service =
+        new BuilderReadingBenchmarkService() {
+          @Override
+          public Mono<BenchmarkResponse> requestResponse(
+              BenchmarkRequestOrBuilder message, ByteBuf metadata) {
+            Sinks.One<BenchmarkResponse> response = responses.get(message.getId());
+            BenchmarkResponse built = response(message);
+            arrived.countDown();
+            return response.asMono().map(ignored -> built);
+          }
+        };
+    RequestHandlingRSocket handler =
+        new RequestHandlingRSocket(
+            new BenchmarkServiceServer(
+                service, Optional.empty(), Optional.empty(), Optional.empty()));
+
+    String name = "batch-" + UUID.randomUUID();
+    server =
+        RSocketServer.create(SocketAcceptor.with(handler))
+            .bind(LocalServerTransport.create(name))
+            .block();
+    rSocket = RSocketConnector.create().connect(LocalClientTransport.create(name)).block();
+    registry = new SimpleMeterRegistry();
+    client = new BenchmarkServiceClient(rSocket, registry);
+  }
+
+  @After
+  public void tearDown() {
+    rSocket.dispose();
+    server.dispose();
+  }
+
+  @Test
+  public void testShouldEmitResponsesInRequestOrder() throws Exception {
+    Assert.assertEquals(Arrays.asList(0, 1, 2, 3, 4), batch(true, 4, 3, 2, 1, 0));
+    assertRecorded();
+  }
+
+  @Test
+  public void testShouldEmitResponsesAsTheyComplete() throws Exception {
+    Assert.assertEquals(Arrays.asList(4, 1, 3, 0, 2), batch(false, 4, 1, 3, 0, 2));
+    assertRecorded();
+  }
+
+  /** Sends a batch and, once every request arrived, completes them in the given order. */
+  private List<Integer> batch(boolean ordered, int... completionOrder) throws Exception {
+    Flux<BenchmarkRequest> requests =
+        Flux.range(0, REQUESTS).map(id -> BenchmarkRequest.newBuilder().setId(id).build());
+    CompletableFuture<List<Integer>> ids =
+        client
+            .requestResponseBatch(requests, ordered, Unpooled.EMPTY_BUFFER)
+            .map(BenchmarkResponse::getId)
+            .collectList()
+            .toFuture();
+
+    Assert.assertTrue(arrived.await(5, TimeUnit.SECONDS));
+    for (int id : completionOrder) {
+      responses.get(id).emitValue(BenchmarkResponse.getDefaultInstance(), FAIL_FAST);
+    }
+    return ids.get(5, TimeUnit.SECONDS);
+  }
+
+  // The client meters record the batch as one call with a response per request
+  private void assertRecorded() {
+    Assert.assertEquals(REQUESTS, count("next"), 0);
+    Assert.assertEquals(1, count("complete"), 0);
+  }
+
+  private double count(String status) {
+    return registry
+        .get("rsocket.client.request")
+        .tag("method", BenchmarkService.METHOD_REQUEST_RESPONSE)
+        .tag("status", status)
+        .counter()
+        .count();
+  }
+}
@@ -0,0 +1,76 @@
+package io.rsocket.rpc;
+
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OperationsPerInvocation;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+import reactor.core.publisher.Flux;
+import reactor.core.scheduler.Scheduler;
+import reactor.core.scheduler.Schedulers;
+import reactor.util.concurrent.Queues;
+
+/**
+ * Iterates a stream of a million elements emitted on another thread, the way blocking clients
+ * consume a server stream, with the lock based baseline and with each {@link WaitStrategy}.
+ * Scores are elements per second.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@OperationsPerInvocation(BlockingIterableBenchmark.ELEMENTS)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 10, time = 1)
+@Fork(1)
+@State(Scope.Benchmark)
+public class BlockingIterableBenchmark {
+  static final int ELEMENTS = 1_000_000;
+
+  @Param({"lock", "park", "spin-yield-park"})
+  String waitStrategy;
+
+  Scheduler producer;
+  Flux<Integer> source;
+
+  @Setup
+  public void setup() {
+    producer = Schedulers.newSingle("producer");
+    source = Flux.range(0, ELEMENTS).subscribeOn(producer);
+  }
+
+  @TearDown
+  public void tearDown() {
+    producer.dispose();
+  }
+
+  @Benchmark
+  public void iterate(Blackhole bh) {
+    for (Integer i : iterable()) {
+      bh.consume(i);
+    }
+  }
+
+  private Iterable<Integer> iterable() {
+    switch (waitStrategy) {
+      case "lock":
+        return new LockingBlockingIterable<>(source, Queues.SMALL_BUFFER_SIZE, Queues.small());
+      case "park":
+        return new BlockingIterable<>(
+            source, Queues.SMALL_BUFFER_SIZE, Queues.small(), WaitStrategy.PARK);
+      case "spin-yield-park":
+        return new BlockingIterable<>(
+            source, Queues.SMALL_BUFFER_SIZE, Queues.small(), WaitStrategy.DEFAULT);
+      default:
+        throw new IllegalArgumentException("unknown wait strategy " + waitStrategy);
+    }
+  }
+}
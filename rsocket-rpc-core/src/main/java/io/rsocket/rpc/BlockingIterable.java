@@ -2,9 +2,7 @@ package io.rsocket.rpc;
 
 import java.util.*;
 import java.util.concurrent.atomic.AtomicReferenceFieldUpdater;
-import java.util.concurrent.locks.Condition;
-import java.util.concurrent.locks.Lock;
-import java.util.concurrent.locks.ReentrantLock;
+import java.util.concurrent.locks.LockSupport;
 import java.util.function.Supplier;
 import java.util.stream.Stream;
 import java.util.stream.StreamSupport;
@@ -22,6 +20,10 @@ import reactor.util.annotation.Nullable;
  *
  * <p>It also implements methods to stream the contents via Stream that also supports cancellation.
  *
+ * <p>The subscriber hands elements to the consuming thread through the queue alone. The consumer
+ * waits for the next one according to its {@link WaitStrategy}, and is only unparked by the
+ * producer once it actually parked, so a busy stream never takes a lock.
+ *
  * @param <T> the value type
  */
 public class BlockingIterable<T> implements Iterable<T>, Scannable {
@@ -32,14 +34,29 @@ public class BlockingIterable<T> implements Iterable<T>, Scannable {
 
   final Supplier<Queue<T>> queueSupplier;
 
+  final WaitStrategy waitStrategy;
+
   public BlockingIterable(
       Publisher<? extends T> source, int batchSize, Supplier<Queue<T>> queueSupplier) {
+    this(source, batchSize, queueSupplier, WaitStrategy.DEFAULT);
+  }
+
+  /**
+   * @param queueSupplier supplies the queue between the subscriber and the consuming thread, which
+   *     only needs to support a single producer and a single consumer
+   */
+  public BlockingIterable(
+      Publisher<? extends T> source,
+      int batchSize,
+      Supplier<Queue<T>> queueSupplier,
+      WaitStrategy waitStrategy) {
     if (batchSize <= 0) {
       throw new IllegalArgumentException("batchSize > 0 required but it was " + batchSize);
     }
     this.source = Objects.requireNonNull(source, "source");
     this.batchSize = batchSize;
     this.queueSupplier = Objects.requireNonNull(queueSupplier, "queueSupplier");
+    this.waitStrategy = Objects.requireNonNull(waitStrategy, "waitStrategy");
   }
 
   static long unboundedOrPrefetch(int prefetch) {
@@ -95,7 +112,7 @@ public class BlockingIterable<T> implements Iterable<T>, Scannable {
       throw Exceptions.propagate(e);
     }
 
-    return new SubscriberIterator<>(q, batchSize);
+    return new SubscriberIterator<>(q, batchSize, waitStrategy);
   }
 
   static final class SubscriberIterator<T>
@@ -105,22 +122,28 @@ public class BlockingIterable<T> implements Iterable<T>, Scannable {
     static final AtomicReferenceFieldUpdater<SubscriberIterator, Subscription> S =
         AtomicReferenceFieldUpdater.newUpdater(SubscriberIterator.class, Subscription.class, "s");
 
+    @SuppressWarnings("rawtypes")
+    static final AtomicReferenceFieldUpdater<SubscriberIterator, Thread> WAITER =
+        AtomicReferenceFieldUpdater.newUpdater(SubscriberIterator.class, Thread.class, "waiter");
+
     final Queue<T> queue;
     final int batchSize;
     final int limit;
-    final Lock lock;
-    final Condition condition;
+    final int spins;
+    final int spinsAndYields;
     long produced;
     volatile Subscription s;
     volatile boolean done;
     Throwable error;
+    // The consuming thread while it is parked or about to park
+    volatile Thread waiter;
 
-    SubscriberIterator(Queue<T> queue, int batchSize) {
+    SubscriberIterator(Queue<T> queue, int batchSize, WaitStrategy waitStrategy) {
       this.queue = queue;
       this.batchSize = batchSize;
       this.limit = unboundedOrLimit(batchSize);
-      this.lock = new ReentrantLock();
-      this.condition = lock.newCondition();
+      this.spins = waitStrategy.spins;
+      this.spinsAndYields = waitStrategy.spins + waitStrategy.yields;
     }
 
     @Override
@@ -137,23 +160,42 @@ public class BlockingIterable<T> implements Iterable<T>, Scannable {
           }
         }
         if (empty) {
-          lock.lock();
-          try {
-            while (!done && queue.isEmpty()) {
-              condition.await();
-            }
-          } catch (InterruptedException ex) {
-            run();
-            throw Exceptions.propagate(ex);
-          } finally {
-            lock.unlock();
-          }
+          await();
         } else {
           return true;
         }
       }
     }
 
+    void await() {
+      int idle = 0;
+      while (!done && queue.isEmpty()) {
+        if (idle < spins) {
+          idle++;
+          continue;
+        }
+        if (idle < spinsAndYields) {
+          idle++;
+          Thread.yield();
+          continue;
+        }
+
+        // Publish the thread before checking again, the producer unparks whoever it finds after
+        // offering, so either it sees the thread or this sees the element
+        Thread current = Thread.currentThread();
+        waiter = current;
+        if (!done && queue.isEmpty()) {
+          LockSupport.park(this);
+        }
+        WAITER.compareAndSet(this, current, null);
+
+        if (Thread.interrupted()) {
+          run();
+          throw Exceptions.propagate(new InterruptedException());
+        }
+      }
+    }
+
     @Override
     public T next() {
       if (hasNext()) {
@@ -216,11 +258,11 @@ public class BlockingIterable<T> implements Iterable<T>, Scannable {
     }
 
     void signalConsumer() {
-      lock.lock();
-      try {
-        condition.signalAll();
-      } finally {
-        lock.unlock();
+      // An atomic swap rather than a plain read, so the offer before it cannot be reordered after
+      // reading the waiter
+      Thread waiter = WAITER.getAndSet(this, null);
+      if (waiter != null) {
+        LockSupport.unpark(waiter);
       }
     }
 
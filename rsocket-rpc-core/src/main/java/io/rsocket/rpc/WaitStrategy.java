@@ -0,0 +1,35 @@
+package io.rsocket.rpc;
+
+/**
+ * How a {@link BlockingIterable} waits for the next element: it busy-spins first, then yields its
+ * time slice, and only parks the thread when nothing arrived in the meantime. Spinning and yielding
+ * keep a busy stream from paying for a park and unpark per element, parking keeps an idle one from
+ * burning a core.
+ */
+public final class WaitStrategy {
+  /** Parks as soon as the queue is empty, for consumers that must not spend CPU while waiting. */
+  public static final WaitStrategy PARK = new WaitStrategy(0, 0);
+
+  /** Spins and yields for a few microseconds before parking. */
+  public static final WaitStrategy DEFAULT = new WaitStrategy(128, 8);
+
+  final int spins;
+  final int yields;
+
+  private WaitStrategy(int spins, int yields) {
+    this.spins = spins;
+    this.yields = yields;
+  }
+
+  /**
+   * @param spins how often to check for an element in a busy loop before yielding
+   * @param yields how often to yield before parking
+   */
+  public static WaitStrategy spinYieldPark(int spins, int yields) {
+    if (spins < 0 || yields < 0) {
+      throw new IllegalArgumentException(
+          "spins and yields must not be negative but were " + spins + " and " + yields);
+    }
+    return new WaitStrategy(spins, yields);
+  }
+}
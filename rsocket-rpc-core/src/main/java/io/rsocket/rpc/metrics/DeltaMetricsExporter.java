@@ -0,0 +1,81 @@
+package io.rsocket.rpc.metrics;
+
+import io.micrometer.core.instrument.MeterRegistry;
+import io.netty.buffer.Unpooled;
+import io.rsocket.rpc.metrics.om.MetricsSnapshot;
+import io.rsocket.rpc.metrics.om.MetricsSnapshotHandler;
+import java.time.Duration;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+import reactor.core.Disposable;
+import reactor.core.publisher.Flux;
+import reactor.util.retry.Retry;
+
+/**
+ * Streams the meters of a registry over a single long lived {@link
+ * MetricsSnapshotHandler#streamMetrics} channel. The first snapshot carries every meter with its
+ * id, later snapshots only carry the meters whose measurements changed and refer to them by the
+ * ref assigned in the first one. The refs are reassigned whenever the channel is reopened.
+ */
+public class DeltaMetricsExporter implements Disposable, Runnable {
+  private static final Duration RETRY_DELAY = Duration.ofSeconds(1);
+
+  private final Logger logger = LoggerFactory.getLogger(DeltaMetricsExporter.class);
+  private final MetricsSnapshotHandler handler;
+  private final MeterRegistry registry;
+  private final Duration exportFrequency;
+  private volatile Disposable disposable;
+
+  public DeltaMetricsExporter(
+      MetricsSnapshotHandler handler, MeterRegistry registry, Duration exportFrequency) {
+    this.handler = handler;
+    this.registry = registry;
+    this.exportFrequency = exportFrequency;
+  }
+
+  private Flux<MetricsSnapshot> getMetricsSnapshotStream() {
+    return Flux.defer(
+        () -> {
+          MetricsDeltaEncoder encoder = new MetricsDeltaEncoder();
+          return Flux.interval(Duration.ZERO, exportFrequency)
+              .onBackpressureDrop()
+              .map(l -> encoder.encode(registry.getMeters()))
+              .filter(snapshot -> snapshot.getMetersCount() > 0 || snapshot.getRemovedCount() > 0);
+        });
+  }
+
+  @Override
+  public void dispose() {
+    Disposable d;
+    synchronized (this) {
+      d = disposable;
+      disposable = null;
+    }
+    if (d != null) {
+      d.dispose();
+    }
+  }
+
+  @Override
+  public boolean isDisposed() {
+    Disposable d = disposable;
+    return d == null || d.isDisposed();
+  }
+
+  @Override
+  public void run() {
+    synchronized (this) {
+      if (disposable != null) {
+        return;
+      }
+
+      this.disposable =
+          Flux.defer(
+                  () -> handler.streamMetrics(getMetricsSnapshotStream(), Unpooled.EMPTY_BUFFER))
+              .doOnError(throwable -> logger.debug("error streaming metrics", throwable))
+              .retryWhen(Retry.fixedDelay(Long.MAX_VALUE, RETRY_DELAY))
+              .repeatWhen(completions -> completions.delayElements(RETRY_DELAY))
+              .subscribe();
+    }
+  }
+}
@@ -0,0 +1,82 @@
+package io.rsocket.rpc.metrics;
+
+import io.rsocket.ipc.metrics.LatencyHistogram;
+import io.rsocket.ipc.metrics.LatencyRecorder;
+import io.rsocket.rpc.metrics.om.Meter;
+import io.rsocket.rpc.metrics.om.MeterId;
+import io.rsocket.rpc.metrics.om.MeterMeasurement;
+import io.rsocket.rpc.metrics.om.MeterStatistic;
+import io.rsocket.rpc.metrics.om.MeterTag;
+import io.rsocket.rpc.metrics.om.MeterType;
+import io.rsocket.rpc.metrics.om.MetricsSnapshot;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Converts the histograms of a {@link LatencyRecorder} into {@link Meter}s. Every histogram
+ * becomes one meter per percentile, tagged like the percentiles of a Micrometer timer, and one
+ * meter holding the count, the total time and the maximum.
+ */
+public final class LatencySnapshots {
+  static final double[] PERCENTILES = {0.5, 0.99, 0.999};
+  static final String[] PERCENTILE_TAGS = {"0.5", "0.99", "0.999"};
+
+  private LatencySnapshots() {}
+
+  /**
+   * @param reset whether to clear the histograms, so that every snapshot covers the time since
+   *     the previous one
+   */
+  public static MetricsSnapshot snapshot(LatencyRecorder recorder, boolean reset) {
+    return MetricsSnapshot.newBuilder().addAllMeters(toMeters(recorder, reset)).build();
+  }
+
+  public static List<Meter> toMeters(LatencyRecorder recorder, boolean reset) {
+    List<Meter> meters = new ArrayList<>();
+    for (LatencyHistogram histogram : recorder.histograms()) {
+      LatencyHistogram.Snapshot snapshot =
+          reset ? histogram.snapshotAndReset() : histogram.snapshot();
+
+      for (int i = 0; i < PERCENTILES.length; i++) {
+        MeterId.Builder id =
+            id(histogram)
+                .addTag(MeterTag.newBuilder().setKey("percentile").setValue(PERCENTILE_TAGS[i]));
+        meters.add(
+            Meter.newBuilder()
+                .setId(id)
+                .addMeasure(
+                    MeterMeasurement.newBuilder()
+                        .setValue(snapshot.valueAtPercentile(PERCENTILES[i]))
+                        .setStatistic(MeterStatistic.DURATION))
+                .build());
+      }
+
+      meters.add(
+          Meter.newBuilder()
+              .setId(id(histogram))
+              .addMeasure(
+                  MeterMeasurement.newBuilder()
+                      .setValue(snapshot.count())
+                      .setStatistic(MeterStatistic.COUNT))
+              .addMeasure(
+                  MeterMeasurement.newBuilder()
+                      .setValue(snapshot.totalNanos())
+                      .setStatistic(MeterStatistic.TOTAL_TIME))
+              .addMeasure(
+                  MeterMeasurement.newBuilder()
+                      .setValue(snapshot.maxNanos())
+                      .setStatistic(MeterStatistic.MAX))
+              .build());
+    }
+    return meters;
+  }
+
+  private static MeterId.Builder id(LatencyHistogram histogram) {
+    return MeterId.newBuilder()
+        .setName("rsocket." + histogram.role() + ".latency")
+        .addTag(MeterTag.newBuilder().setKey("service").setValue(histogram.service()))
+        .addTag(MeterTag.newBuilder().setKey("method").setValue(histogram.method()))
+        .setType(MeterType.TIMER)
+        .setBaseUnit("nanoseconds");
+  }
+}
@@ -0,0 +1,219 @@
+package io.rsocket.rpc.metrics;
+
+import io.micrometer.core.instrument.Measurement;
+import io.micrometer.core.instrument.Statistic;
+import io.micrometer.core.instrument.Tag;
+import io.micrometer.core.instrument.Timer;
+import io.micrometer.core.instrument.distribution.ValueAtPercentile;
+import io.rsocket.rpc.metrics.om.Meter;
+import io.rsocket.rpc.metrics.om.MeterId;
+import io.rsocket.rpc.metrics.om.MeterMeasurement;
+import io.rsocket.rpc.metrics.om.MeterStatistic;
+import io.rsocket.rpc.metrics.om.MeterTag;
+import io.rsocket.rpc.metrics.om.MeterType;
+import io.rsocket.rpc.metrics.om.MetricsSnapshot;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Turns the meters of a registry into the delta snapshots of a single stream. A meter gets a ref
+ * the first time it is seen and its id is only sent along with that first snapshot. Afterwards a
+ * meter is only sent, by ref, when one of its measurements changed, and meters that disappeared
+ * from the registry are listed as removed. Not thread safe.
+ */
+final class MetricsDeltaEncoder {
+  private final Map<io.micrometer.core.instrument.Meter.Id, Entry> entries = new HashMap<>();
+  private int nextRef = 1;
+  private long generation;
+
+  MetricsSnapshot encode(Iterable<io.micrometer.core.instrument.Meter> meters) {
+    long generation = ++this.generation;
+    MetricsSnapshot.Builder snapshot = MetricsSnapshot.newBuilder().setDelta(true);
+
+    for (io.micrometer.core.instrument.Meter meter : meters) {
+      io.micrometer.core.instrument.Meter.Id id = meter.getId();
+      Entry entry = entries.get(id);
+      boolean added = entry == null;
+      if (added) {
+        entry = new Entry(nextRef++);
+        entries.put(id, entry);
+      }
+      entry.generation = generation;
+
+      if (meter instanceof Timer) {
+        encodePercentiles((Timer) meter, entry, snapshot);
+      }
+
+      int size = 0;
+      double[] values = entry.values;
+      MeterStatistic[] statistics = entry.statistics;
+      boolean changed = added;
+      for (Measurement measurement : meter.measure()) {
+        if (size == values.length) {
+          values = Arrays.copyOf(values, Math.max(4, size * 2));
+          statistics = Arrays.copyOf(statistics, values.length);
+          changed = true;
+        }
+        double value = measurement.getValue();
+        changed |= Double.doubleToLongBits(values[size]) != Double.doubleToLongBits(value);
+        values[size] = value;
+        statistics[size] = convert(measurement.getStatistic());
+        size++;
+      }
+      changed |= size != entry.size;
+      entry.values = values;
+      entry.statistics = statistics;
+      entry.size = size;
+
+      if (changed) {
+        Meter.Builder builder = Meter.newBuilder().setRef(entry.ref);
+        if (added) {
+          builder.setId(id(id));
+        }
+        for (int i = 0; i < size; i++) {
+          builder.addMeasure(
+              MeterMeasurement.newBuilder().setValue(values[i]).setStatistic(statistics[i]));
+        }
+        snapshot.addMeters(builder);
+      }
+    }
+
+    Iterator<Entry> iterator = entries.values().iterator();
+    while (iterator.hasNext()) {
+      Entry entry = iterator.next();
+      if (entry.generation != generation) {
+        snapshot.addRemoved(entry.ref);
+        for (Entry percentile : entry.percentiles) {
+          snapshot.addRemoved(percentile.ref);
+        }
+        iterator.remove();
+      }
+    }
+
+    return snapshot.build();
+  }
+
+  // Percentiles are sent as meters of their own, tagged with the percentile
+  private void encodePercentiles(Timer timer, Entry entry, MetricsSnapshot.Builder snapshot) {
+    ValueAtPercentile[] percentiles = timer.takeSnapshot().percentileValues();
+    if (entry.percentiles.length != percentiles.length) {
+      // Only happens the first time, the percentiles of a timer are fixed
+      for (Entry percentile : entry.percentiles) {
+        snapshot.addRemoved(percentile.ref);
+      }
+      entry.percentiles = new Entry[percentiles.length];
+      for (int i = 0; i < percentiles.length; i++) {
+        entry.percentiles[i] = new Entry(nextRef++);
+        entry.percentiles[i].values = new double[] {Double.NaN};
+      }
+    }
+
+    for (int i = 0; i < percentiles.length; i++) {
+      Entry percentile = entry.percentiles[i];
+      double value = percentiles[i].value(TimeUnit.NANOSECONDS);
+      boolean added = percentile.size == 0;
+      if (!added
+          && Double.doubleToLongBits(percentile.values[0]) == Double.doubleToLongBits(value)) {
+        continue;
+      }
+      percentile.values[0] = value;
+      percentile.size = 1;
+
+      Meter.Builder builder = Meter.newBuilder().setRef(percentile.ref);
+      if (added) {
+        builder.setId(
+            id(timer.getId())
+                .setBaseUnit("nanoseconds")
+                .addTag(
+                    MeterTag.newBuilder()
+                        .setKey("percentile")
+                        .setValue(round(percentiles[i].percentile()))));
+      }
+      builder.addMeasure(
+          MeterMeasurement.newBuilder().setValue(value).setStatistic(MeterStatistic.DURATION));
+      snapshot.addMeters(builder);
+    }
+  }
+
+  private static MeterId.Builder id(io.micrometer.core.instrument.Meter.Id id) {
+    MeterId.Builder builder = MeterId.newBuilder().setName(id.getName());
+    for (Tag tag : id.getTags()) {
+      builder.addTag(MeterTag.newBuilder().setKey(tag.getKey()).setValue(tag.getValue()));
+    }
+    builder.setType(convert(id.getType()));
+    if (id.getDescription() != null) {
+      builder.setDescription(id.getDescription());
+    }
+    if (id.getBaseUnit() != null) {
+      builder.setBaseUnit(id.getBaseUnit());
+    }
+    return builder;
+  }
+
+  private static String round(double percentile) {
+    double roundOff = (double) Math.round(percentile * 10_000.0) / 10_000.0;
+    return String.valueOf(roundOff);
+  }
+
+  private static MeterType convert(io.micrometer.core.instrument.Meter.Type type) {
+    switch (type) {
+      case GAUGE:
+        return MeterType.GAUGE;
+      case TIMER:
+        return MeterType.TIMER;
+      case COUNTER:
+        return MeterType.COUNTER;
+      case LONG_TASK_TIMER:
+        return MeterType.LONG_TASK_TIMER;
+      case DISTRIBUTION_SUMMARY:
+        return MeterType.DISTRIBUTION_SUMMARY;
+      case OTHER:
+        return MeterType.OTHER;
+      default:
+        throw new IllegalStateException("unknown type " + type.name());
+    }
+  }
+
+  private static MeterStatistic convert(Statistic statistic) {
+    switch (statistic) {
+      case MAX:
+        return MeterStatistic.MAX;
+      case COUNT:
+        return MeterStatistic.COUNT;
+      case TOTAL:
+        return MeterStatistic.TOTAL;
+      case VALUE:
+        return MeterStatistic.VALUE;
+      case UNKNOWN:
+        return MeterStatistic.UNKNOWN;
+      case DURATION:
+        return MeterStatistic.DURATION;
+      case TOTAL_TIME:
+        return MeterStatistic.TOTAL_TIME;
+      case ACTIVE_TASKS:
+        return MeterStatistic.ACTIVE_TASKS;
+      default:
+        throw new IllegalStateException("unknown type " + statistic.name());
+    }
+  }
+
+  private static final class Entry {
+    private static final double[] NO_VALUES = new double[0];
+    private static final MeterStatistic[] NO_STATISTICS = new MeterStatistic[0];
+    private static final Entry[] NO_PERCENTILES = new Entry[0];
+
+    final int ref;
+    long generation;
+    double[] values = NO_VALUES;
+    MeterStatistic[] statistics = NO_STATISTICS;
+    int size;
+    Entry[] percentiles = NO_PERCENTILES;
+
+    Entry(int ref) {
+      this.ref = ref;
+    }
+  }
+}
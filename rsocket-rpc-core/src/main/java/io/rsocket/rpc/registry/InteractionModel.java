@@ -0,0 +1,9 @@
+package io.rsocket.rpc.registry;
+
+/** RSocket interaction model a generated method is served with. */
+public enum InteractionModel {
+  FIRE_AND_FORGET,
+  REQUEST_RESPONSE,
+  REQUEST_STREAM,
+  REQUEST_CHANNEL
+}
@@ -0,0 +1,90 @@
+package io.rsocket.rpc.registry;
+
+import com.google.protobuf.Parser;
+import java.util.Objects;
+
+/**
+ * Static description of a generated route. Instances are created by generated registries, so
+ * routes, message parsers and generated classes can be looked up without reflection.
+ */
+public final class RouteDescriptor {
+  private final String service;
+  private final String method;
+  private final String route;
+  private final InteractionModel interactionModel;
+  private final Parser<?> inputParser;
+  private final Parser<?> outputParser;
+  private final Class<?> serverClass;
+  private final Class<?> clientClass;
+
+  public RouteDescriptor(
+      String service,
+      String method,
+      String route,
+      InteractionModel interactionModel,
+      Parser<?> inputParser,
+      Parser<?> outputParser,
+      Class<?> serverClass,
+      Class<?> clientClass) {
+    this.service = Objects.requireNonNull(service, "service");
+    this.method = Objects.requireNonNull(method, "method");
+    this.route = Objects.requireNonNull(route, "route");
+    this.interactionModel = Objects.requireNonNull(interactionModel, "interactionModel");
+    this.inputParser = Objects.requireNonNull(inputParser, "inputParser");
+    this.outputParser = Objects.requireNonNull(outputParser, "outputParser");
+    this.serverClass = Objects.requireNonNull(serverClass, "serverClass");
+    this.clientClass = Objects.requireNonNull(clientClass, "clientClass");
+  }
+
+  /** @return fully qualified name of the service */
+  public String service() {
+    return service;
+  }
+
+  /** @return name of the method */
+  public String method() {
+    return method;
+  }
+
+  /** @return route the method is registered under */
+  public String route() {
+    return route;
+  }
+
+  public InteractionModel interactionModel() {
+    return interactionModel;
+  }
+
+  /** @return parser of the request message */
+  public Parser<?> inputParser() {
+    return inputParser;
+  }
+
+  /** @return parser of the response message */
+  public Parser<?> outputParser() {
+    return outputParser;
+  }
+
+  /** @return generated server class serving the route */
+  public Class<?> serverClass() {
+    return serverClass;
+  }
+
+  /** @return generated client class calling the route */
+  public Class<?> clientClass() {
+    return clientClass;
+  }
+
+  @Override
+  public String toString() {
+    return "RouteDescriptor{"
+        + "route='"
+        + route
+        + '\''
+        + ", interactionModel="
+        + interactionModel
+        + ", serverClass="
+        + serverClass.getName()
+        + '}';
+  }
+}
@@ -0,0 +1,28 @@
+package io.rsocket.rpc.registry;
+
+import io.rsocket.ipc.SelfRegistrable;
+import java.util.List;
+
+/**
+ * Registry generated for a proto file when the {@code generate-registry} option is passed to the
+ * protoc plugin. It lists every route of the file statically and registers all services added to
+ * it in one call:
+ *
+ * <pre>{@code
+ * RequestHandlingRSocket handler =
+ *     new RequestHandlingRSocket()
+ *         .withEndpoint(new MyServiceRSocketRpcRegistry().withMyService(new DefaultMyService()));
+ * }</pre>
+ *
+ * No classpath scanning or dependency injection is needed to discover the generated servers.
+ */
+public interface ServiceRegistry extends SelfRegistrable {
+
+  /**
+   * Routes of every service declared in the proto file, including services without a registered
+   * implementation.
+   *
+   * @return unmodifiable list of routes in declaration order
+   */
+  List<RouteDescriptor> routes();
+}
@@ -0,0 +1,47 @@
+package io.rsocket.rpc;
+
+import java.util.Iterator;
+import org.junit.Assert;
+import org.junit.Test;
+import reactor.core.publisher.Flux;
+import reactor.core.scheduler.Schedulers;
+import reactor.util.concurrent.Queues;
+
+public class BlockingIterableTest {
+  @Test
+  public void testShouldIterateElementsEmittedOnAnotherThread() {
+    for (WaitStrategy waitStrategy :
+        new WaitStrategy[] {
+          WaitStrategy.PARK, WaitStrategy.DEFAULT, WaitStrategy.spinYieldPark(0, 1)
+        }) {
+      Flux<Integer> source = Flux.range(0, 100_000).subscribeOn(Schedulers.single());
+      BlockingIterable<Integer> iterable =
+          new BlockingIterable<>(source, Queues.SMALL_BUFFER_SIZE, Queues.small(), waitStrategy);
+
+      int expected = 0;
+      for (Integer i : iterable) {
+        Assert.assertEquals(expected++, i.intValue());
+      }
+      Assert.assertEquals(100_000, expected);
+    }
+  }
+
+  @Test
+  public void testShouldRethrowError() {
+    Flux<Integer> source =
+        Flux.just(1)
+            .concatWith(Flux.error(new IllegalStateException("boom")))
+            .subscribeOn(Schedulers.single());
+    Iterator<Integer> iterator =
+        new BlockingIterable<>(source, Queues.SMALL_BUFFER_SIZE, Queues.small(), WaitStrategy.PARK)
+            .iterator();
+
+    Assert.assertEquals(1, iterator.next().intValue());
+    try {
+      iterator.hasNext();
+      Assert.fail("hasNext should rethrow the error of the source");
+    } catch (IllegalStateException e) {
+      Assert.assertEquals("boom", e.getMessage());
+    }
+  }
+}
@@ -0,0 +1,53 @@
+package io.rsocket.rpc.metrics;
+
+import io.micrometer.core.instrument.Counter;
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry;
+import io.rsocket.rpc.metrics.om.Meter;
+import io.rsocket.rpc.metrics.om.MetricsSnapshot;
+import java.util.Collections;
+import org.junit.Assert;
+import org.junit.Test;
+
+public class MetricsDeltaEncoderTest {
+  @Test
+  public void testShouldOnlySendChangedMeters() {
+    SimpleMeterRegistry registry = new SimpleMeterRegistry();
+    Counter requests = registry.counter("requests", "service", "foo");
+    Counter errors = registry.counter("errors", "service", "foo");
+    MetricsDeltaEncoder encoder = new MetricsDeltaEncoder();
+
+    MetricsSnapshot first = encoder.encode(registry.getMeters());
+    Assert.assertTrue(first.getDelta());
+    Assert.assertEquals(2, first.getMetersCount());
+    for (Meter meter : first.getMetersList()) {
+      Assert.assertTrue(meter.hasId());
+      Assert.assertTrue(meter.getRef() > 0);
+    }
+
+    MetricsSnapshot unchanged = encoder.encode(registry.getMeters());
+    Assert.assertEquals(0, unchanged.getMetersCount());
+    Assert.assertEquals(0, unchanged.getRemovedCount());
+
+    requests.increment();
+    MetricsSnapshot changed = encoder.encode(registry.getMeters());
+    Assert.assertEquals(1, changed.getMetersCount());
+    Meter meter = changed.getMeters(0);
+    Assert.assertFalse(meter.hasId());
+    Assert.assertEquals(ref(first, "requests"), meter.getRef());
+    Assert.assertEquals(1.0, meter.getMeasure(0).getValue(), 0.0);
+
+    MetricsSnapshot removed = encoder.encode(Collections.singletonList(requests));
+    Assert.assertEquals(0, removed.getMetersCount());
+    Assert.assertEquals(1, removed.getRemovedCount());
+    Assert.assertEquals(ref(first, "errors"), removed.getRemoved(0));
+  }
+
+  private static int ref(MetricsSnapshot snapshot, String name) {
+    for (Meter meter : snapshot.getMetersList()) {
+      if (meter.getId().getName().equals(name)) {
+        return meter.getRef();
+      }
+    }
+    throw new AssertionError("no meter named " + name);
+  }
+}
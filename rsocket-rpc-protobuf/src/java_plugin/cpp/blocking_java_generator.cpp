@@ -1,15 +1,11 @@
 #include "blocking_java_generator.h"
-#include "rsocket/options.pb.h"
+#include "service_model.h"
+#include "template_printer.h"
 
 #include <algorithm>
 #include <iostream>
-#include <iterator>
-#include <map>
 #include <vector>
-#include <google/protobuf/compiler/java/java_names.h>
 #include <google/protobuf/descriptor.h>
-#include <google/protobuf/descriptor.pb.h>
-#include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 
 // Stringify helpers used solely to cast RSOCKET_RPC_VERSION
@@ -29,203 +25,14 @@ namespace blocking_java_rsocket_rpc_generator {
 
 using google::protobuf::FileDescriptor;
 using google::protobuf::ServiceDescriptor;
-using google::protobuf::MethodDescriptor;
-using google::protobuf::Descriptor;
-using google::protobuf::io::Printer;
-using google::protobuf::SourceLocation;
-using io::rsocket::rpc::RSocketMethodOptions;
-
-// Adjust a method name prefix identifier to follow the JavaBean spec:
-//   - decapitalize the first letter
-//   - remove embedded underscores & capitalize the following letter
-static string MixedLower(const string& word) {
-  string w;
-  w += tolower(word[0]);
-  bool after_underscore = false;
-  for (size_t i = 1; i < word.length(); ++i) {
-    if (word[i] == '_') {
-      after_underscore = true;
-    } else {
-      w += after_underscore ? toupper(word[i]) : word[i];
-      after_underscore = false;
-    }
-  }
-  return w;
-}
-
-// Converts to the identifier to the ALL_UPPER_CASE format.
-//   - An underscore is inserted where a lower case letter is followed by an
-//     upper case letter.
-//   - All letters are converted to upper case
-static string ToAllUpperCase(const string& word) {
-  string w;
-  for (size_t i = 0; i < word.length(); ++i) {
-    w += toupper(word[i]);
-    if ((i < word.length() - 1) && islower(word[i]) && isupper(word[i + 1])) {
-      w += '_';
-    }
-  }
-  return w;
-}
-
-static inline string LowerMethodName(const MethodDescriptor* method) {
-  return MixedLower(method->name());
-}
-
-static inline string MethodFieldName(const MethodDescriptor* method) {
-  return "METHOD_" + ToAllUpperCase(method->name());
-}
-
-static inline string RouteFieldName(const MethodDescriptor* method) {
-  return "ROUTE_" + ToAllUpperCase(method->name());
-}
-
-static inline string MessageFullJavaName(const Descriptor* desc) {
-  return google::protobuf::compiler::java::ClassName(desc);
-}
-
-static inline string ServiceFieldName(const ServiceDescriptor* service) { return "SERVICE_ID"; }
-
-static inline string NamespaceIdFieldName(const ServiceDescriptor* service) { return "NAMESPACE_ID"; }
-
-template <typename ITR>
-static void SplitStringToIteratorUsing(const string& full,
-                                       const char* delim,
-                                       ITR& result) {
-  // Optimize the common case where delim is a single character.
-  if (delim[0] != '\0' && delim[1] == '\0') {
-    char c = delim[0];
-    const char* p = full.data();
-    const char* end = p + full.size();
-    while (p != end) {
-      if (*p == c) {
-        ++p;
-      } else {
-        const char* start = p;
-        while (++p != end && *p != c);
-        *result++ = string(start, p - start);
-      }
-    }
-    return;
-  }
-
-  string::size_type begin_index, end_index;
-  begin_index = full.find_first_not_of(delim);
-  while (begin_index != string::npos) {
-    end_index = full.find_first_of(delim, begin_index);
-    if (end_index == string::npos) {
-      *result++ = full.substr(begin_index);
-      return;
-    }
-    *result++ = full.substr(begin_index, (end_index - begin_index));
-    begin_index = full.find_first_not_of(delim, end_index);
-  }
-}
-
-static void SplitStringUsing(const string& full,
-                             const char* delim,
-                             std::vector<string>* result) {
-  std::back_insert_iterator< std::vector<string> > it(*result);
-  SplitStringToIteratorUsing(full, delim, it);
-}
-
-static std::vector<string> Split(const string& full, const char* delim) {
-  std::vector<string> result;
-  SplitStringUsing(full, delim, &result);
-  return result;
-}
-
-static string EscapeJavadoc(const string& input) {
-  string result;
-  result.reserve(input.size() * 2);
-
-  char prev = '*';
-
-  for (string::size_type i = 0; i < input.size(); i++) {
-    char c = input[i];
-    switch (c) {
-      case '*':
-        // Avoid "/*".
-        if (prev == '/') {
-          result.append("&#42;");
-        } else {
-          result.push_back(c);
-        }
-        break;
-      case '/':
-        // Avoid "*/".
-        if (prev == '*') {
-          result.append("&#47;");
-        } else {
-          result.push_back(c);
-        }
-        break;
-      case '@':
-        // '@' starts javadoc tags including the @deprecated tag, which will
-        // cause a compile-time error if inserted before a declaration that
-        // does not have a corresponding @Deprecated annotation.
-        result.append("&#64;");
-        break;
-      case '<':
-        // Avoid interpretation as HTML.
-        result.append("&lt;");
-        break;
-      case '>':
-        // Avoid interpretation as HTML.
-        result.append("&gt;");
-        break;
-      case '&':
-        // Avoid interpretation as HTML.
-        result.append("&amp;");
-        break;
-      case '\\':
-        // Java interprets Unicode escape sequences anywhere!
-        result.append("&#92;");
-        break;
-      default:
-        result.push_back(c);
-        break;
-    }
-
-    prev = c;
-  }
+using rsocket_rpc_generator::Printer;
+using rsocket_rpc_generator::Variables;
+using rsocket_rpc_generator::MethodModel;
+using rsocket_rpc_generator::ServiceModel;
 
-  return result;
-}
-
-template <typename DescriptorType>
-static string GetCommentsForDescriptor(const DescriptorType* descriptor) {
-  SourceLocation location;
-  if (descriptor->GetSourceLocation(&location)) {
-    return location.leading_comments.empty() ?
-      location.trailing_comments : location.leading_comments;
-  }
-  return string();
-}
-
-static std::vector<string> GetDocLines(const string& comments) {
-  if (!comments.empty()) {
-    // Ideally we should parse the comment text as Markdown and
-    // write it back as HTML, but this requires a Markdown parser.  For now
-    // we just use <pre> to get fixed-width text formatting.
-
-    // If the comment itself contains block comment start or end markers,
-    // HTML-escape them so that they don't accidentally close the doc comment.
-    string escapedComments = EscapeJavadoc(comments);
+static inline string ServiceFieldName() { return "SERVICE_ID"; }
 
-    std::vector<string> lines = Split(escapedComments, "\n");
-    while (!lines.empty() && lines.back().empty()) {
-      lines.pop_back();
-    }
-    return lines;
-  }
-  return std::vector<string>();
-}
-
-template <typename DescriptorType>
-static std::vector<string> GetDocLinesForDescriptor(const DescriptorType* descriptor) {
-  return GetDocLines(GetCommentsForDescriptor(descriptor));
-}
+static inline string NamespaceIdFieldName() { return "NAMESPACE_ID"; }
 
 static void WriteDocCommentBody(Printer* printer,
                                     const std::vector<string>& lines,
@@ -252,41 +59,32 @@ static void WriteDocCommentBody(Printer* printer,
   }
 }
 
-static void WriteDocComment(Printer* printer, const string& comments) {
-  printer->Print("/**\n");
-  std::vector<string> lines = GetDocLines(comments);
-  WriteDocCommentBody(printer, lines, false);
-  printer->Print(" */\n");
-}
-
 static void WriteServiceDocComment(Printer* printer,
-                                       const ServiceDescriptor* service) {
+                                       const ServiceModel& service) {
   // Deviating from protobuf to avoid extraneous docs
   // (see https://github.com/google/protobuf/issues/1406);
   printer->Print("/**\n");
-  std::vector<string> lines = GetDocLinesForDescriptor(service);
-  WriteDocCommentBody(printer, lines, true);
+  WriteDocCommentBody(printer, service.doc_lines, true);
   printer->Print(" */\n");
 }
 
-void WriteMethodDocComment(Printer* printer,
-                           const MethodDescriptor* method) {
+static void WriteMethodDocComment(Printer* printer,
+                                  const MethodModel& method) {
   // Deviating from protobuf to avoid extraneous docs
   // (see https://github.com/google/protobuf/issues/1406);
   printer->Print("/**\n");
-  std::vector<string> lines = GetDocLinesForDescriptor(method);
-  WriteDocCommentBody(printer, lines, true);
+  WriteDocCommentBody(printer, method.doc_lines, true);
   printer->Print(" */\n");
 }
 
-static void PrintInterface(const ServiceDescriptor* service,
-                           std::map<string, string>* vars,
+static void PrintInterface(const ServiceModel& service,
+                           Variables* vars,
                            Printer* p,
                            ProtoFlavor flavor,
                            bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["service_field_name"] = ServiceFieldName(service);
-  (*vars)["file_name"] = service->file()->name();
+  (*vars)["service_name"] = service.name;
+  (*vars)["service_field_name"] = ServiceFieldName();
+  (*vars)["file_name"] = service.file_name;
   (*vars)["RSOCKET_RPC_VERSION"] = "";
   #ifdef RSOCKET_RPC_VERSION
   if (!disable_version) {
@@ -305,25 +103,24 @@ static void PrintInterface(const ServiceDescriptor* service,
   // Service IDs
   p->Print(*vars, "String $service_field_name$ = \"$Package$$service_name$\";\n");
 
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["method_field_name"] = MethodFieldName(method);
-    (*vars)["route_field_name"] = RouteFieldName(method);
-    (*vars)["method_name"] = method->name();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["method_field_name"] = method.field_name;
+    (*vars)["route_field_name"] = method.route_field_name;
+    (*vars)["method_name"] = method.name;
 
     p->Print(*vars, "String $method_field_name$ = \"$method_name$\";\n");
     p->Print(*vars, "String $route_field_name$ = $service_field_name$ + \".\" + $method_field_name$;\n");
   }
 
   // RPC methods
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     // Method signature
     p->Print("\n");
@@ -334,7 +131,7 @@ static void PrintInterface(const ServiceDescriptor* service,
     } else if (client_streaming) {
       p->Print(*vars, "$output_type$ $lower_method_name$");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(*vars, "void $lower_method_name$");
       } else {
         p->Print(*vars, "$output_type$ $lower_method_name$");
@@ -353,16 +150,16 @@ static void PrintInterface(const ServiceDescriptor* service,
   p->Print("}\n");
 }
 
-static void PrintClient(const ServiceDescriptor* service,
-                        std::map<string, string>* vars,
+static void PrintClient(const ServiceModel& service,
+                        Variables* vars,
                         Printer* p,
                         ProtoFlavor flavor,
                         bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["namespace_id_name"] = NamespaceIdFieldName(service);
-  (*vars)["service_id_name"] = ServiceFieldName(service);
-  (*vars)["file_name"] = service->file()->name();
-  (*vars)["client_class_name"] = ClientClassName(service);
+  (*vars)["service_name"] = service.name;
+  (*vars)["namespace_id_name"] = NamespaceIdFieldName();
+  (*vars)["service_id_name"] = ServiceFieldName();
+  (*vars)["file_name"] = service.file_name;
+  (*vars)["client_class_name"] = ClientClassName(service.descriptor);
   (*vars)["RSOCKET_RPC_VERSION"] = "";
   #ifdef RSOCKET_RPC_VERSION
   if (!disable_version) {
@@ -434,15 +231,14 @@ static void PrintClient(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // RPC methods
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_id_name"] = MethodFieldName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_id_name"] = method.field_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     // Method signature
     if (server_streaming) {
@@ -456,7 +252,7 @@ static void PrintClient(const ServiceDescriptor* service,
           "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
           "public $output_type$ $lower_method_name$");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "@$RSocketRpcGeneratedMethod$(returnTypeClass = Void.class)\n"
@@ -474,7 +270,7 @@ static void PrintClient(const ServiceDescriptor* service,
           *vars,
           "($Iterable$<$input_type$> messages) {\n");
       p->Indent();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
           p->Print(
               *vars,
               "$lower_method_name$(messages, $Unpooled$.EMPTY_BUFFER);\n");
@@ -491,7 +287,7 @@ static void PrintClient(const ServiceDescriptor* service,
           *vars,
           "($input_type$ message) {\n");
       p->Indent();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
           p->Print(
               *vars,
               "$lower_method_name$(message, $Unpooled$.EMPTY_BUFFER);\n");
@@ -518,8 +314,7 @@ static void PrintClient(const ServiceDescriptor* service,
           "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
           "public $output_type$ $lower_method_name$");
     } else {
-      const Descriptor* output_type = method->output_type();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "@$Override$\n"
@@ -565,7 +360,7 @@ static void PrintClient(const ServiceDescriptor* service,
           *vars,
           "($Iterable$<$input_type$> messages, $ByteBuf$ metadata) {\n");
       p->Indent();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "delegate.$lower_method_name$($Flux$.defer(() -> $Flux$.fromIterable(messages)), metadata).block();\n");
@@ -581,7 +376,7 @@ static void PrintClient(const ServiceDescriptor* service,
           *vars,
           "($input_type$ message, $ByteBuf$ metadata) {\n");
       p->Indent();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "delegate.$lower_method_name$(message, metadata).block();\n");
@@ -599,16 +394,43 @@ static void PrintClient(const ServiceDescriptor* service,
   p->Print("}\n\n");
 }
 
-static void PrintServer(const ServiceDescriptor* service,
-                        std::map<string, string>* vars,
+// Numbers the routes of the given methods, followed by the batch routes of the
+// batched ones, for the dispatch switch of one interaction model. The switch
+// finds the index straight from the request metadata, so dispatching a request
+// decodes no route.
+static void PrintRouteIndex(const char* field_name,
+                            const vector<const MethodModel*>& methods,
+                            const vector<const MethodModel*>& batched,
+                            Variables* vars,
+                            Printer* p) {
+  (*vars)["route_index_field"] = field_name;
+  p->Print(*vars, "private static final $RouteIndex$ $route_index_field$ = new $RouteIndex$(");
+  const char* separator = "";
+  for (size_t i = 0; i < methods.size(); ++i) {
+    (*vars)["separator"] = separator;
+    (*vars)["route_field_name"] = methods[i]->route_field_name;
+    p->Print(*vars, "$separator$$service_name$.$route_field_name$");
+    separator = ", ";
+  }
+  for (size_t i = 0; i < batched.size(); ++i) {
+    (*vars)["separator"] = separator;
+    (*vars)["batch_route_field_name"] = batched[i]->batch_route_field_name;
+    p->Print(*vars, "$separator$$service_name$.$batch_route_field_name$");
+    separator = ", ";
+  }
+  p->Print(");\n\n");
+}
+
+static void PrintServer(const ServiceModel& service,
+                        Variables* vars,
                         Printer* p,
                         ProtoFlavor flavor,
                         bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["namespace_id_name"] = NamespaceIdFieldName(service);
-  (*vars)["service_id_name"] = ServiceFieldName(service);
-  (*vars)["file_name"] = service->file()->name();
-  (*vars)["server_class_name"] = ServerClassName(service);
+  (*vars)["service_name"] = service.name;
+  (*vars)["namespace_id_name"] = NamespaceIdFieldName();
+  (*vars)["service_id_name"] = ServiceFieldName();
+  (*vars)["file_name"] = service.file_name;
+  (*vars)["server_class_name"] = ServerClassName(service.descriptor);
   (*vars)["RSOCKET_RPC_VERSION"] = "";
   #ifdef RSOCKET_RPC_VERSION
   if (!disable_version) {
@@ -635,12 +457,11 @@ static void PrintServer(const ServiceDescriptor* service,
       "private final $Scheduler$ scheduler;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     if (server_streaming) {
       p->Print(
@@ -651,7 +472,7 @@ static void PrintServer(const ServiceDescriptor* service,
           *vars,
           "private final $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> $lower_method_name$;\n");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "private final $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>> $lower_method_name$;\n");
@@ -663,6 +484,20 @@ static void PrintServer(const ServiceDescriptor* service,
     }
   }
 
+  // Latency histograms, fire and forget calls are not measured by the blocking server
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    if (method.fire_and_forget) {
+      continue;
+    }
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
+
+    p->Print(
+        *vars,
+        "private final $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> $lower_method_name$Latency = $RSocketRpcMetrics$.sharedRecorded($LatencyRecorder$.global(), Blocking$service_name$.$service_id_name$, Blocking$service_name$.$method_field_name$, \"server\");\n");
+  }
+
   p->Print(
       *vars,
       "@$Inject$\n"
@@ -678,9 +513,9 @@ static void PrintServer(const ServiceDescriptor* service,
     );
     p->Indent();
      // RPC metrics
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
 
       p->Print(
          *vars,
@@ -694,10 +529,10 @@ static void PrintServer(const ServiceDescriptor* service,
     );
     p->Indent();
     // RPC metrics
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
-      (*vars)["method_field_name"] = MethodFieldName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
+      (*vars)["method_field_name"] = method.field_name;
 
       p->Print(
           *vars,
@@ -751,37 +586,13 @@ static void PrintServer(const ServiceDescriptor* service,
     p->Outdent();
     p->Print("}\n\n");
 
-  std::vector<const MethodDescriptor*> fire_and_forget;
-  std::vector<const MethodDescriptor*> request_response;
-  std::vector<const MethodDescriptor*> request_stream;
-  std::vector<const MethodDescriptor*> request_channel;
-
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
-
-    if (client_streaming) {
-      request_channel.push_back(method);
-    } else if (server_streaming) {
-      request_stream.push_back(method);
-    } else {
-      if (options.fire_and_forget()) {
-        fire_and_forget.push_back(method);
-      } else {
-        request_response.push_back(method);
-      }
-    }
-  }
-
   // Fire and forget
   p->Print(
     *vars,
     "@$Override$\n"
     "public $Mono$<$Void$> fireAndForget($Payload$ payload) {\n");
   p->Indent();
-  if (fire_and_forget.empty()) {
+  if (service.fire_and_forget.empty()) {
     p->Print(
         *vars,
         "return $Mono$.error(new UnsupportedOperationException(\"Fire And Forget is not implemented.\"));\n");
@@ -794,6 +605,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Mono$<$Void$> response = this.doDecodeAndHandleFireAndForget(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -817,6 +629,7 @@ static void PrintServer(const ServiceDescriptor* service,
 
 
   // Do Decode And Fire and forget delegate
+  PrintRouteIndex("FIRE_AND_FORGET_ROUTES", service.fire_and_forget, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Mono$<Void> doDecodeAndHandleFireAndForget(\n");
@@ -832,16 +645,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(FIRE_AND_FORGET_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.fire_and_forget.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -865,12 +679,12 @@ static void PrintServer(const ServiceDescriptor* service,
 
 
   // Do Service Fire-And-Forget
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -894,7 +708,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Mono$<$Payload$> requestResponse($Payload$ payload) {\n");
   p->Indent();
-  if (request_response.empty()) {
+  if (service.request_response.empty()) {
     p->Print(
         *vars,
         "return $Mono$.error(new UnsupportedOperationException(\"Request Response is not implemented.\"));\n");
@@ -907,6 +721,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Mono$<$Payload$> response = this.doDecodeAndHandleRequestResponse(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -929,6 +744,7 @@ static void PrintServer(const ServiceDescriptor* service,
    "}\n\n");
 
   // Do Decode And Request Response delegate
+  PrintRouteIndex("REQUEST_RESPONSE_ROUTES", service.request_response, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Mono$<$Payload$> doDecodeAndHandleRequestResponse(\n");
@@ -944,16 +760,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(REQUEST_RESPONSE_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.request_response.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -976,12 +793,12 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Request-Response
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -993,7 +810,7 @@ static void PrintServer(const ServiceDescriptor* service,
         "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
         "$input_type$ message = $input_type$.parseFrom(is);\n"
         "$ByteBuf$ metadata = decoded.metadata().retain();\n"
-        "return $Mono$.fromSupplier(() -> { try { return service.$lower_method_name$(message, metadata); } finally { metadata.release(); } } ).map(serializer).transform($lower_method_name$).subscribeOn(scheduler);\n");
+        "return $Mono$.fromSupplier(() -> { try { return service.$lower_method_name$(message, metadata); } finally { metadata.release(); } } ).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency).subscribeOn(scheduler);\n");
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
@@ -1006,7 +823,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestStream($Payload$ payload) {\n");
   p->Indent();
-  if (request_stream.empty()) {
+  if (service.request_stream.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request Stream is not implemented.\"));\n");
@@ -1019,6 +836,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Flux$<$Payload$> response = this.doDecodeAndHandleRequestStream(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -1041,6 +859,7 @@ static void PrintServer(const ServiceDescriptor* service,
    "}\n\n");
 
   // Do Decode And Request Stream delegate
+  PrintRouteIndex("REQUEST_STREAM_ROUTES", service.request_stream, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Flux$<$Payload$> doDecodeAndHandleRequestStream(\n");
@@ -1056,16 +875,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(REQUEST_STREAM_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.request_stream.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -1088,12 +908,12 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Service Request-Stream
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -1105,19 +925,20 @@ static void PrintServer(const ServiceDescriptor* service,
         "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
         "$input_type$ message = $input_type$.parseFrom(is);\n"
         "$ByteBuf$ metadata = decoded.metadata().retain();\n"
-        "return $Flux$.defer(() -> { try { return $Flux$.fromIterable(service.$lower_method_name$(message, metadata)).map(serializer).transform($lower_method_name$); } finally { metadata.release(); } }).subscribeOn(scheduler);\n");
+        "return $Flux$.defer(() -> { try { return $Flux$.fromIterable(service.$lower_method_name$(message, metadata)).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency); } finally { metadata.release(); } }).subscribeOn(scheduler);\n");
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
   }
 
   // Request-Channel
+  PrintRouteIndex("REQUEST_CHANNEL_ROUTES", service.request_channel, vector<const MethodModel*>(), vars, p);
   p->Print(
       *vars,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestChannel($Payload$ payload, $Flux$<$Payload$> payloads) {\n");
   p->Indent();
-  if (request_channel.empty()) {
+  if (service.request_channel.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request Channel is not implemented.\"));\n");
@@ -1132,20 +953,23 @@ static void PrintServer(const ServiceDescriptor* service,
 
     p->Print(
         *vars,
-        "switch(decoded.route()) {\n");
+        "switch(REQUEST_CHANNEL_ROUTES.indexOf(decoded)) {\n");
     p->Indent();
-    for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-      const MethodDescriptor* method = *it;
-      (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-      (*vars)["method_name"] = method->name();
-      (*vars)["route_field_name"] = RouteFieldName(method);
+    for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+      const MethodModel& method = **it;
+      (*vars)["route_index"] = std::to_string(it - service.request_channel.begin());
+      (*vars)["input_type"] = method.input_type;
+      (*vars)["method_name"] = method.name;
+      (*vars)["route_field_name"] = method.route_field_name;
       p->Print(
           *vars,
-          "case $service_name$.$route_field_name$: {\n");
+          "case $route_index$: {\n");
       p->Indent();
       p->Print(
           *vars,
-          "return this.do$method_name$RequestChannel(payloads, payload, decoded);\n");
+          "$Flux$<$Payload$> response = this.do$method_name$RequestChannel(payloads, payload, decoded);\n"
+          "decoded.recycle();\n"
+          "return response;\n");
       p->Outdent();
       p->Print("}\n");
     }
@@ -1155,6 +979,7 @@ static void PrintServer(const ServiceDescriptor* service,
     p->Indent();
     p->Print(
         *vars,
+        "decoded.recycle();\n"
         "payload.release();\n"
         "return $Flux$.error(new UnsupportedOperationException());\n");
     p->Outdent();
@@ -1185,7 +1010,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestChannel($Publisher$<$Payload$> payloads) {\n");
   p->Indent();
-  if (request_channel.empty()) {
+  if (service.request_channel.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request-Channel not implemented.\"));\n");
@@ -1223,12 +1048,12 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Request-Channel
-  for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -1246,14 +1071,14 @@ static void PrintServer(const ServiceDescriptor* service,
     p->Print(
         *vars,
         "$ByteBuf$ metadata = decoded.metadata().retain();\n");
-    if (method->server_streaming()) {
+    if (method.server_streaming) {
       p->Print(
           *vars,
-          "return $Flux$.defer(() -> { try { return $Flux$.fromIterable(service.$lower_method_name$(messages.toIterable(), metadata)).map(serializer).transform($lower_method_name$); } finally { metadata.release(); } }).subscribeOn(scheduler);\n");
+          "return $Flux$.defer(() -> { try { return $Flux$.fromIterable(service.$lower_method_name$(messages.toIterable(), metadata)).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency); } finally { metadata.release(); } }).subscribeOn(scheduler);\n");
     } else {
       p->Print(
           *vars,
-          "return $Mono$.fromSupplier(() -> { try { return service.$lower_method_name$(messages.toIterable(), metadata); } finally { metadata.release(); } }).map(serializer).transform($lower_method_name$).$flux$().subscribeOn(scheduler);\n");
+          "return $Mono$.fromSupplier(() -> { try { return service.$lower_method_name$(messages.toIterable(), metadata); } finally { metadata.release(); } }).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency).$flux$().subscribeOn(scheduler);\n");
     }
     p->Outdent();
     p->Print("}\n");
@@ -1267,34 +1092,34 @@ static void PrintServer(const ServiceDescriptor* service,
     "@$Override$\n"
     "public void selfRegister($MutableRouter$ router) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withFireAndForgetRoute($service_name$.$route_field_name$, this::do$method_name$FireAndForget);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestResponseRoute($service_name$.$route_field_name$, this::do$method_name$RequestResponse);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestStreamRoute($service_name$.$route_field_name$, this::do$method_name$RequestStream);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestChannelRoute($service_name$.$route_field_name$, this::do$method_name$RequestChannel);\n");
@@ -1387,19 +1212,20 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n");
 }
 
-void GenerateInterface(const ServiceDescriptor* service,
+bool GenerateInterface(const ServiceModel& service,
                        google::protobuf::io::ZeroCopyOutputStream* out,
                        ProtoFlavor flavor,
                        bool disable_version) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Generated"] = "javax.annotation.Generated";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
   vars["Iterable"] = "Iterable";
 
   Printer printer(out, '$');
-    string package_name = ServiceJavaPackage(service->file());
+    const string& package_name = service.java_package;
     if (!package_name.empty()) {
       printer.Print(
           "package $package_name$;\n\n",
@@ -1407,20 +1233,19 @@ void GenerateInterface(const ServiceDescriptor* service,
     }
 
     // Package string is used to fully qualify method names.
-    vars["Package"] = service->file()->package();
-    if (!vars["Package"].empty()) {
-      vars["Package"].append(".");
-    }
+    vars["Package"] = service.proto_package;
     PrintInterface(service, &vars, &printer, flavor, disable_version);
+    printer.Flush();
+    return !printer.failed();
 }
 
-void GenerateClient(const ServiceDescriptor* service,
+bool GenerateClient(const ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Flux"] = "reactor.core.publisher.Flux";
   vars["Mono"] = "reactor.core.publisher.Mono";
   vars["from"] = "from";
@@ -1436,6 +1261,7 @@ void GenerateClient(const ServiceDescriptor* service,
   vars["Payload"] = "io.rsocket.Payload";
   vars["ByteBufPayload"] = "io.rsocket.util.ByteBufPayload";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
   vars["ByteBufAllocator"] = "io.netty.buffer.ByteBufAllocator";
   vars["Unpooled"] = "io.netty.buffer.Unpooled";
   vars["ByteBuffer"] = "java.nio.ByteBuffer";
@@ -1443,12 +1269,13 @@ void GenerateClient(const ServiceDescriptor* service,
   vars["CodedOutputStream"] = "com.google.protobuf.CodedOutputStream";
   vars["RSocketRpcMetadata"] = "io.rsocket.ipc.frames.Metadata";
   vars["RSocketRpcMetrics"] = "io.rsocket.ipc.metrics.Metrics";
+  vars["LatencyRecorder"] = "io.rsocket.ipc.metrics.LatencyRecorder";
   vars["MeterRegistry"] = "io.micrometer.core.instrument.MeterRegistry";
   vars["MessageLite"] = "com.google.protobuf.MessageLite";
   vars["Parser"] = "com.google.protobuf.Parser";
   vars["BlockingIterable"] = " io.rsocket.rpc.BlockingIterable";
   vars["Iterable"] = "Iterable";
-  vars["PackageName"] = ServiceJavaPackage(service->file());
+  vars["PackageName"] = service.java_package;
   vars["Queues"] = "reactor.util.concurrent.Queues";
   vars["RSocketRpcGeneratedMethod"] = "io.rsocket.rpc.annotations.internal.GeneratedMethod";
   vars["Tag"] = "io.rsocket.ipc.tracing.Tag";
@@ -1460,7 +1287,7 @@ void GenerateClient(const ServiceDescriptor* service,
   vars["SimpleSpanContext"] = "io.rsocket.ipc.tracing.SimpleSpanContext";
 
   Printer printer(out, '$');
-    string package_name = ServiceJavaPackage(service->file());
+    const string& package_name = service.java_package;
     if (!package_name.empty()) {
       printer.Print(
           "package $package_name$;\n\n",
@@ -1468,20 +1295,19 @@ void GenerateClient(const ServiceDescriptor* service,
     }
 
     // Package string is used to fully qualify method names.
-    vars["Package"] = service->file()->package();
-    if (!vars["Package"].empty()) {
-      vars["Package"].append(".");
-    }
+    vars["Package"] = service.proto_package;
     PrintClient(service, &vars, &printer, flavor, disable_version);
+    printer.Flush();
+    return !printer.failed();
 }
 
-void GenerateServer(const ServiceDescriptor* service,
+bool GenerateServer(const ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Flux"] = "reactor.core.publisher.Flux";
   vars["Mono"] = "reactor.core.publisher.Mono";
   vars["from"] = "from";
@@ -1502,8 +1328,10 @@ void GenerateServer(const ServiceDescriptor* service,
   vars["AbstractRSocketService"] = "io.rsocket.rpc.AbstractRSocketService";
   vars["RSocketRpcMetadata"] = "io.rsocket.ipc.frames.Metadata";
   vars["RSocketRpcMetrics"] = "io.rsocket.ipc.metrics.Metrics";
+  vars["LatencyRecorder"] = "io.rsocket.ipc.metrics.LatencyRecorder";
   vars["MeterRegistry"] = "io.micrometer.core.instrument.MeterRegistry";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
   vars["ByteBuffer"] = "java.nio.ByteBuffer";
   vars["ByteBufAllocator"] = "io.netty.buffer.ByteBufAllocator";
   vars["CodedInputStream"] = "com.google.protobuf.CodedInputStream";
@@ -1532,7 +1360,7 @@ void GenerateServer(const ServiceDescriptor* service,
   vars["MutableRouter"] = "io.rsocket.ipc.MutableRouter";
 
   Printer printer(out, '$');
-    string package_name = ServiceJavaPackage(service->file());
+    const string& package_name = service.java_package;
     if (!package_name.empty()) {
       printer.Print(
           "package $package_name$;\n\n",
@@ -1540,22 +1368,41 @@ void GenerateServer(const ServiceDescriptor* service,
     }
 
     // Package string is used to fully qualify method names.
-    vars["Package"] = service->file()->package();
-    if (!vars["Package"].empty()) {
-      vars["Package"].append(".");
-    }
+    vars["Package"] = service.proto_package;
     PrintServer(service, &vars, &printer, flavor, disable_version);
+    printer.Flush();
+    return !printer.failed();
+}
+
+bool GenerateInterface(const ServiceDescriptor* service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateInterface(model, out, flavor, disable_version);
+}
+
+bool GenerateClient(const ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateClient(model, out, flavor, disable_version);
+}
+
+bool GenerateServer(const ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateServer(model, out, flavor, disable_version);
 }
 
 string ServiceJavaPackage(const FileDescriptor* file) {
-  string result = google::protobuf::compiler::java::ClassName(file);
-  size_t last_dot_pos = result.find_last_of('.');
-  if (last_dot_pos != string::npos) {
-    result.resize(last_dot_pos);
-  } else {
-    result = "";
-  }
-  return result;
+  return rsocket_rpc_generator::JavaPackage(file);
 }
 
 string ClientClassName(const google::protobuf::ServiceDescriptor* service) {
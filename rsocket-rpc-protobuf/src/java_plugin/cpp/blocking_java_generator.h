@@ -8,6 +8,8 @@
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/descriptor.h>
 
+#include "service_model.h"
+
 
 // Abort the program after logging the mesage if the given condition is not
 // true. Otherwise, do nothing.
@@ -35,20 +37,44 @@ string ClientClassName(const google::protobuf::ServiceDescriptor* service);
 // Returns the name of the client class for the given service.
 string ServerClassName(const google::protobuf::ServiceDescriptor* service);
 
+// Like their reactive counterparts, the Generate functions return false if
+// the stream failed.
+
 // Writes the generated interface into the given ZeroCopyOutputStream
-void GenerateInterface(const google::protobuf::ServiceDescriptor* service,
+bool GenerateInterface(const google::protobuf::ServiceDescriptor* service,
                        google::protobuf::io::ZeroCopyOutputStream* out,
                        ProtoFlavor flavor,
                        bool disable_version);
 
 // Writes the generated client into the given ZeroCopyOutputStream
-void GenerateClient(const google::protobuf::ServiceDescriptor* service,
+bool GenerateClient(const google::protobuf::ServiceDescriptor* service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version);
 
 // Writes the generated server into the given ZeroCopyOutputStream
-void GenerateServer(const google::protobuf::ServiceDescriptor* service,
+bool GenerateServer(const google::protobuf::ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version);
+
+// Writes the generated interface of a prebuilt service model into the given
+// ZeroCopyOutputStream
+bool GenerateInterface(const rsocket_rpc_generator::ServiceModel& service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version);
+
+// Writes the generated client of a prebuilt service model into the given
+// ZeroCopyOutputStream
+bool GenerateClient(const rsocket_rpc_generator::ServiceModel& service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version);
+
+// Writes the generated server of a prebuilt service model into the given
+// ZeroCopyOutputStream
+bool GenerateServer(const rsocket_rpc_generator::ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version);
@@ -0,0 +1,321 @@
+#include "generation_cache.h"
+
+#include <stdio.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <google/protobuf/compiler/java/java_names.h>
+#include <google/protobuf/descriptor.pb.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define RSOCKET_RPC_MKDIR(path) _mkdir(path)
+#define RSOCKET_RPC_GETPID() _getpid()
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define RSOCKET_RPC_MKDIR(path) mkdir(path, 0755)
+#define RSOCKET_RPC_GETPID() getpid()
+#endif
+
+// Stringify helpers used solely to cast rsocket_rpc_version
+#ifndef STR
+#define STR(s) #s
+#endif
+
+#ifndef XSTR
+#define XSTR(s) STR(s)
+#endif
+
+namespace rsocket_rpc_generator {
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::FileDescriptor;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::ServiceDescriptor;
+using google::protobuf::SourceLocation;
+
+// Bumped whenever the layout of the hashed content or of the entries changes.
+static const int kCacheFormatVersion = 2;
+
+// The build defines RSOCKET_RPC_GENERATOR_DIGEST as a digest of the generator
+// sources, so every change to the generators changes all cache keys. Without
+// it the output of the plugin can change while the keys stay the same, and
+// the cache is not used at all.
+#ifdef RSOCKET_RPC_GENERATOR_DIGEST
+static const char kGeneratorDigest[] = XSTR(RSOCKET_RPC_GENERATOR_DIGEST);
+#endif
+
+static int cache_hits = 0;
+static int cache_misses = 0;
+
+namespace {
+
+// Feeds every value to two unrelated 64-bit hashes, FNV-1a and a
+// rotate-xor-multiply hash with a final avalanche, so that their collisions
+// are independent. Every value is length prefixed so that adjacent strings
+// cannot be confused with each other.
+class Hasher {
+ public:
+  Hasher() : fnv_(14695981039346656037ULL), mix_(0) {}
+
+  void Add(const std::string& value) {
+    Add(static_cast<uint64_t>(value.size()));
+    AddBytes(value.data(), value.size());
+  }
+
+  void Add(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      char byte = static_cast<char>((value >> (i * 8)) & 0xff);
+      AddBytes(&byte, 1);
+    }
+  }
+
+  void Add(const ContentHash& value) {
+    Add(value.primary);
+    Add(value.secondary);
+  }
+
+  ContentHash hash() const {
+    ContentHash hash;
+    hash.primary = fnv_;
+    uint64_t mix = mix_;
+    mix ^= mix >> 33;
+    mix *= 0xff51afd7ed558ccdULL;
+    mix ^= mix >> 33;
+    mix *= 0xc4ceb9fe1a85ec53ULL;
+    mix ^= mix >> 33;
+    hash.secondary = mix;
+    return hash;
+  }
+
+ private:
+  void AddBytes(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      unsigned char byte = static_cast<unsigned char>(data[i]);
+      fnv_ ^= byte;
+      fnv_ *= 1099511628211ULL;
+      mix_ = ((mix_ << 5) | (mix_ >> 59)) ^ byte;
+      mix_ *= 0x9e3779b97f4a7c15ULL;
+    }
+  }
+
+  uint64_t fnv_;
+  uint64_t mix_;
+};
+
+template <typename DescriptorType>
+void AddComments(Hasher* hasher, const DescriptorType* descriptor) {
+  SourceLocation location;
+  if (descriptor->GetSourceLocation(&location)) {
+    hasher->Add(location.leading_comments);
+    hasher->Add(location.trailing_comments);
+  } else {
+    hasher->Add(std::string());
+    hasher->Add(std::string());
+  }
+}
+
+void AddFile(Hasher* hasher, const FileDescriptor* file) {
+  hasher->Add(file->name());
+  hasher->Add(file->package());
+  hasher->Add(file->options().SerializeAsString());
+}
+
+void AddMessage(Hasher* hasher, const Descriptor* message,
+                std::set<const Descriptor*>* visited) {
+  if (!visited->insert(message).second) {
+    hasher->Add(message->full_name());
+    return;
+  }
+  hasher->Add(message->full_name());
+  hasher->Add(google::protobuf::compiler::java::ClassName(message));
+  AddFile(hasher, message->file());
+  hasher->Add(static_cast<uint64_t>(message->field_count()));
+  for (int i = 0; i < message->field_count(); ++i) {
+    const FieldDescriptor* field = message->field(i);
+    hasher->Add(field->name());
+    hasher->Add(static_cast<uint64_t>(field->number()));
+    hasher->Add(static_cast<uint64_t>(field->type()));
+    hasher->Add(static_cast<uint64_t>(field->label()));
+    if (field->message_type() != NULL) {
+      AddMessage(hasher, field->message_type(), visited);
+    } else if (field->enum_type() != NULL) {
+      hasher->Add(field->enum_type()->full_name());
+    }
+  }
+}
+
+std::string ToHex(uint64_t value) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex(16, '0');
+  for (int i = 15; i >= 0; --i) {
+    hex[i] = kDigits[value & 0xf];
+    value >>= 4;
+  }
+  return hex;
+}
+
+// The first line of every entry, identifying the full key it was stored
+// under.
+std::string EntryHeader(const ContentHash& service_hash, const std::string& file_name) {
+  return ToHex(service_hash.primary) + ToHex(service_hash.secondary) + " " + file_name + "\n";
+}
+
+// Creates the directory and any missing parents. Errors are ignored, they
+// surface later when the entry cannot be written.
+void MakeDirectories(const std::string& path) {
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i == path.size() || path[i] == '/' || path[i] == '\\') {
+      RSOCKET_RPC_MKDIR(path.substr(0, i).c_str());
+    }
+  }
+}
+
+}  // namespace
+
+ContentHash ServiceContentHash(
+    const ServiceDescriptor* service,
+    const std::vector<std::pair<std::string, std::string> >& parameters) {
+  Hasher hasher;
+  hasher.Add(static_cast<uint64_t>(kCacheFormatVersion));
+#ifdef RSOCKET_RPC_VERSION
+  hasher.Add(std::string(XSTR(RSOCKET_RPC_VERSION)));
+#endif
+#ifdef RSOCKET_RPC_GENERATOR_DIGEST
+  hasher.Add(std::string(kGeneratorDigest));
+#endif
+  hasher.Add(static_cast<uint64_t>(parameters.size()));
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    hasher.Add(parameters[i].first);
+    hasher.Add(parameters[i].second);
+  }
+
+  AddFile(&hasher, service->file());
+  hasher.Add(service->full_name());
+  hasher.Add(service->options().SerializeAsString());
+  AddComments(&hasher, service);
+
+  std::set<const Descriptor*> visited;
+  hasher.Add(static_cast<uint64_t>(service->method_count()));
+  for (int i = 0; i < service->method_count(); ++i) {
+    const MethodDescriptor* method = service->method(i);
+    hasher.Add(method->name());
+    hasher.Add(static_cast<uint64_t>(method->client_streaming()));
+    hasher.Add(static_cast<uint64_t>(method->server_streaming()));
+    hasher.Add(method->options().SerializeAsString());
+    AddComments(&hasher, method);
+    AddMessage(&hasher, method->input_type(), &visited);
+    AddMessage(&hasher, method->output_type(), &visited);
+  }
+  return hasher.hash();
+}
+
+ContentHash FileContentHash(
+    const FileDescriptor* file,
+    const std::vector<std::pair<std::string, std::string> >& parameters) {
+  Hasher hasher;
+  hasher.Add(static_cast<uint64_t>(file->service_count()));
+  for (int i = 0; i < file->service_count(); ++i) {
+    hasher.Add(ServiceContentHash(file->service(i), parameters));
+  }
+  return hasher.hash();
+}
+
+GenerationCache::GenerationCache(const std::string& directory)
+    : directory_(directory) {
+#ifndef RSOCKET_RPC_GENERATOR_DIGEST
+  static bool warned = false;
+  if (enabled() && !warned) {
+    warned = true;
+    fprintf(stderr,
+            "rsocket-rpc: cache_dir is ignored, the plugin was built without "
+            "RSOCKET_RPC_GENERATOR_DIGEST\n");
+  }
+  directory_.clear();
+#endif
+  if (enabled()) {
+    MakeDirectories(directory_);
+  }
+}
+
+bool GenerationCache::Lookup(const ContentHash& service_hash, const std::string& file_name,
+                             std::string* content) const {
+  if (!enabled()) {
+    return false;
+  }
+  std::ifstream in(EntryPath(service_hash, file_name).c_str(),
+                   std::ios::in | std::ios::binary);
+  if (!in) {
+    ++cache_misses;
+    return false;
+  }
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  if (in.bad()) {
+    ++cache_misses;
+    return false;
+  }
+  // The entry name only covers the primary hash, an entry stored under a
+  // different key that happens to share it is a miss.
+  std::string entry = buffer.str();
+  std::string header = EntryHeader(service_hash, file_name);
+  if (entry.compare(0, header.size(), header) != 0) {
+    ++cache_misses;
+    return false;
+  }
+  content->assign(entry, header.size(), std::string::npos);
+  ++cache_hits;
+  return true;
+}
+
+void GenerationCache::Store(const ContentHash& service_hash, const std::string& file_name,
+                            const std::string& content) const {
+  if (!enabled()) {
+    return;
+  }
+  // Write to a private temporary file and rename it into place, so concurrent
+  // protoc runs sharing the directory never observe a partial entry.
+  std::string path = EntryPath(service_hash, file_name);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << RSOCKET_RPC_GETPID();
+  {
+    std::ofstream out(tmp_path.str().c_str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return;
+    }
+    std::string header = EntryHeader(service_hash, file_name);
+    out.write(header.data(), header.size());
+    out.write(content.data(), content.size());
+    if (!out) {
+      out.close();
+      remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    remove(tmp_path.str().c_str());
+  }
+}
+
+std::string GenerationCache::EntryPath(const ContentHash& service_hash,
+                                       const std::string& file_name) const {
+  Hasher hasher;
+  hasher.Add(service_hash.primary);
+  hasher.Add(file_name);
+  return directory_ + "/" + ToHex(hasher.hash().primary);
+}
+
+int GenerationCache::hits() {
+  return cache_hits;
+}
+
+int GenerationCache::misses() {
+  return cache_misses;
+}
+
+}  // namespace rsocket_rpc_generator
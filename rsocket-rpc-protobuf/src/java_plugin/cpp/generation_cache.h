@@ -0,0 +1,73 @@
+#ifndef RSOCKET_RPC_COMPILER_GENERATION_CACHE_H_
+#define RSOCKET_RPC_COMPILER_GENERATION_CACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+
+namespace rsocket_rpc_generator {
+
+// Cache key made of two independent 64-bit hashes of the same content. The
+// primary hash names the cache entry and the secondary one is stored in it
+// and compared on lookup, so a collision of one hash alone is never served.
+struct ContentHash {
+  ContentHash() : primary(0), secondary(0) {}
+
+  uint64_t primary;
+  uint64_t secondary;
+};
+
+// Returns a stable hash of everything the generators read from the
+// given service: the generator version and source digest, the plugin
+// parameters, the java naming options of the declaring file, service and
+// method comments, method options, and the names of all transitively
+// referenced message types.
+ContentHash ServiceContentHash(
+    const google::protobuf::ServiceDescriptor* service,
+    const std::vector<std::pair<std::string, std::string> >& parameters);
+
+// Returns a stable hash over the content hashes of all services of the
+// given file, for outputs that depend on every service of the file.
+ContentHash FileContentHash(
+    const google::protobuf::FileDescriptor* file,
+    const std::vector<std::pair<std::string, std::string> >& parameters);
+
+// Content-addressed store of generated files. Each entry is a flat file in the
+// cache directory named after the hash of the service content and the output
+// file name, so entries never need to be invalidated: a change to the input
+// produces a different key. Entries start with the full key, which is checked
+// before their content is used.
+class GenerationCache {
+ public:
+  // An empty directory disables the cache, and so does a plugin built without
+  // a generator digest.
+  explicit GenerationCache(const std::string& directory);
+
+  bool enabled() const { return !directory_.empty(); }
+
+  // Looks up the content generated for file_name of a service with the given
+  // content hash. Returns false on a miss.
+  bool Lookup(const ContentHash& service_hash, const std::string& file_name,
+              std::string* content) const;
+
+  // Stores the content generated for file_name. Failures are not fatal, the
+  // file is simply regenerated on the next run.
+  void Store(const ContentHash& service_hash, const std::string& file_name,
+             const std::string& content) const;
+
+  // Hit/miss counters over all caches used by this process.
+  static int hits();
+  static int misses();
+
+ private:
+  std::string EntryPath(const ContentHash& service_hash, const std::string& file_name) const;
+
+  std::string directory_;
+};
+
+}  // namespace rsocket_rpc_generator
+
+#endif  // RSOCKET_RPC_COMPILER_GENERATION_CACHE_H_
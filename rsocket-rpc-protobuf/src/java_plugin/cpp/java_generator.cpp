@@ -1,15 +1,12 @@
 #include "java_generator.h"
-#include "rsocket/options.pb.h"
+#include "service_model.h"
+#include "template_printer.h"
 
 #include <algorithm>
 #include <iostream>
-#include <iterator>
-#include <map>
 #include <vector>
 #include <google/protobuf/compiler/java/java_names.h>
 #include <google/protobuf/descriptor.h>
-#include <google/protobuf/descriptor.pb.h>
-#include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 
 // Stringify helpers used solely to cast rsocket_rpc_version
@@ -29,201 +26,12 @@ namespace java_rsocket_rpc_generator {
 
 using google::protobuf::FileDescriptor;
 using google::protobuf::ServiceDescriptor;
-using google::protobuf::MethodDescriptor;
-using google::protobuf::Descriptor;
-using google::protobuf::io::Printer;
-using google::protobuf::SourceLocation;
-using io::rsocket::rpc::RSocketMethodOptions;
-
-// Adjust a method name prefix identifier to follow the JavaBean spec:
-//   - decapitalize the first letter
-//   - remove embedded underscores & capitalize the following letter
-static string MixedLower(const string& word) {
-  string w;
-  w += tolower(word[0]);
-  bool after_underscore = false;
-  for (size_t i = 1; i < word.length(); ++i) {
-    if (word[i] == '_') {
-      after_underscore = true;
-    } else {
-      w += after_underscore ? toupper(word[i]) : word[i];
-      after_underscore = false;
-    }
-  }
-  return w;
-}
-
-// Converts to the identifier to the ALL_UPPER_CASE format.
-//   - An underscore is inserted where a lower case letter is followed by an
-//     upper case letter.
-//   - All letters are converted to upper case
-static string ToAllUpperCase(const string& word) {
-  string w;
-  for (size_t i = 0; i < word.length(); ++i) {
-    w += toupper(word[i]);
-    if ((i < word.length() - 1) && islower(word[i]) && isupper(word[i + 1])) {
-      w += '_';
-    }
-  }
-  return w;
-}
-
-static inline string LowerMethodName(const MethodDescriptor* method) {
-  return MixedLower(method->name());
-}
-
-static inline string MethodFieldName(const MethodDescriptor* method) {
-  return "METHOD_" + ToAllUpperCase(method->name());
-}
-
-static inline string RouteFieldName(const MethodDescriptor* method) {
-  return "ROUTE_" + ToAllUpperCase(method->name());
-}
-
-static inline string MessageFullJavaName(const Descriptor* desc) {
-  return google::protobuf::compiler::java::ClassName(desc);
-}
-
-static inline string ServiceFieldName(const ServiceDescriptor* service) { return "SERVICE"; }
-
-template <typename ITR>
-static void SplitStringToIteratorUsing(const string& full,
-                                       const char* delim,
-                                       ITR& result) {
-  // Optimize the common case where delim is a single character.
-  if (delim[0] != '\0' && delim[1] == '\0') {
-    char c = delim[0];
-    const char* p = full.data();
-    const char* end = p + full.size();
-    while (p != end) {
-      if (*p == c) {
-        ++p;
-      } else {
-        const char* start = p;
-        while (++p != end && *p != c);
-        *result++ = string(start, p - start);
-      }
-    }
-    return;
-  }
-
-  string::size_type begin_index, end_index;
-  begin_index = full.find_first_not_of(delim);
-  while (begin_index != string::npos) {
-    end_index = full.find_first_of(delim, begin_index);
-    if (end_index == string::npos) {
-      *result++ = full.substr(begin_index);
-      return;
-    }
-    *result++ = full.substr(begin_index, (end_index - begin_index));
-    begin_index = full.find_first_not_of(delim, end_index);
-  }
-}
-
-static void SplitStringUsing(const string& full,
-                             const char* delim,
-                             std::vector<string>* result) {
-  std::back_insert_iterator< std::vector<string> > it(*result);
-  SplitStringToIteratorUsing(full, delim, it);
-}
-
-static std::vector<string> Split(const string& full, const char* delim) {
-  std::vector<string> result;
-  SplitStringUsing(full, delim, &result);
-  return result;
-}
-
-static string EscapeJavadoc(const string& input) {
-  string result;
-  result.reserve(input.size() * 2);
-
-  char prev = '*';
-
-  for (string::size_type i = 0; i < input.size(); i++) {
-    char c = input[i];
-    switch (c) {
-      case '*':
-        // Avoid "/*".
-        if (prev == '/') {
-          result.append("&#42;");
-        } else {
-          result.push_back(c);
-        }
-        break;
-      case '/':
-        // Avoid "*/".
-        if (prev == '*') {
-          result.append("&#47;");
-        } else {
-          result.push_back(c);
-        }
-        break;
-      case '@':
-        // '@' starts javadoc tags including the @deprecated tag, which will
-        // cause a compile-time error if inserted before a declaration that
-        // does not have a corresponding @Deprecated annotation.
-        result.append("&#64;");
-        break;
-      case '<':
-        // Avoid interpretation as HTML.
-        result.append("&lt;");
-        break;
-      case '>':
-        // Avoid interpretation as HTML.
-        result.append("&gt;");
-        break;
-      case '&':
-        // Avoid interpretation as HTML.
-        result.append("&amp;");
-        break;
-      case '\\':
-        // Java interprets Unicode escape sequences anywhere!
-        result.append("&#92;");
-        break;
-      default:
-        result.push_back(c);
-        break;
-    }
-
-    prev = c;
-  }
-
-  return result;
-}
-
-template <typename DescriptorType>
-static string GetCommentsForDescriptor(const DescriptorType* descriptor) {
-  SourceLocation location;
-  if (descriptor->GetSourceLocation(&location)) {
-    return location.leading_comments.empty() ?
-      location.trailing_comments : location.leading_comments;
-  }
-  return string();
-}
-
-static std::vector<string> GetDocLines(const string& comments) {
-  if (!comments.empty()) {
-    // Ideally we should parse the comment text as Markdown and
-    // write it back as HTML, but this requires a Markdown parser.  For now
-    // we just use <pre> to get fixed-width text formatting.
-
-    // If the comment itself contains block comment start or end markers,
-    // HTML-escape them so that they don't accidentally close the doc comment.
-    string escapedComments = EscapeJavadoc(comments);
-
-    std::vector<string> lines = Split(escapedComments, "\n");
-    while (!lines.empty() && lines.back().empty()) {
-      lines.pop_back();
-    }
-    return lines;
-  }
-  return std::vector<string>();
-}
+using rsocket_rpc_generator::Printer;
+using rsocket_rpc_generator::Variables;
+using rsocket_rpc_generator::MethodModel;
+using rsocket_rpc_generator::ServiceModel;
 
-template <typename DescriptorType>
-static std::vector<string> GetDocLinesForDescriptor(const DescriptorType* descriptor) {
-  return GetDocLines(GetCommentsForDescriptor(descriptor));
-}
+static inline string ServiceFieldName() { return "SERVICE"; }
 
 static void WriteDocCommentBody(Printer* printer,
                                     const std::vector<string>& lines,
@@ -250,41 +58,59 @@ static void WriteDocCommentBody(Printer* printer,
   }
 }
 
-static void WriteDocComment(Printer* printer, const string& comments) {
-  printer->Print("/**\n");
-  std::vector<string> lines = GetDocLines(comments);
-  WriteDocCommentBody(printer, lines, false);
-  printer->Print(" */\n");
-}
-
 static void WriteServiceDocComment(Printer* printer,
-                                       const ServiceDescriptor* service) {
+                                       const ServiceModel& service) {
   // Deviating from protobuf to avoid extraneous docs
   // (see https://github.com/google/protobuf/issues/1406);
   printer->Print("/**\n");
-  std::vector<string> lines = GetDocLinesForDescriptor(service);
-  WriteDocCommentBody(printer, lines, true);
+  WriteDocCommentBody(printer, service.doc_lines, true);
   printer->Print(" */\n");
 }
 
-void WriteMethodDocComment(Printer* printer,
-                           const MethodDescriptor* method) {
+static void WriteMethodDocComment(Printer* printer,
+                                  const MethodModel& method) {
   // Deviating from protobuf to avoid extraneous docs
   // (see https://github.com/google/protobuf/issues/1406);
   printer->Print("/**\n");
-  std::vector<string> lines = GetDocLinesForDescriptor(method);
-  WriteDocCommentBody(printer, lines, true);
+  WriteDocCommentBody(printer, method.doc_lines, true);
+  if (method.chunked) {
+    printer->Print(
+        " * The {@code $field$} field is streamed in chunks as the data of the chunked message,\n"
+        " * its header leaves it empty.\n",
+        "field", method.chunked_field);
+  }
   printer->Print(" */\n");
 }
 
-static void PrintInterface(const ServiceDescriptor* service,
-                           std::map<string, string>* vars,
+// Prints the return type, name and parameters of a chunked method, whose
+// chunked messages are passed as a header and a stream of data buffers.
+static void PrintChunkedSignature(const MethodModel& method, Variables* vars, Printer* p,
+                                  bool with_metadata) {
+  if (method.chunked_response_field != NULL) {
+    p->Print(*vars, "$Mono$<$Chunked$<$output_type$>> $lower_method_name$");
+  } else {
+    p->Print(*vars, "$Mono$<$output_type$> $lower_method_name$");
+  }
+  if (method.chunked_request_field != NULL) {
+    p->Print(*vars, "($Chunked$<$input_type$> message");
+  } else {
+    p->Print(*vars, "($input_type$ message");
+  }
+  if (with_metadata) {
+    p->Print(*vars, ", $ByteBuf$ metadata");
+  }
+  p->Print(")");
+}
+
+static void PrintInterface(const ServiceModel& service,
+                           Variables* vars,
                            Printer* p,
                            ProtoFlavor flavor,
-                           bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["service_field_name"] = ServiceFieldName(service);
-  (*vars)["file_name"] = service->file()->name();
+                           bool disable_version,
+                           bool reuse_builders) {
+  (*vars)["service_name"] = service.name;
+  (*vars)["service_field_name"] = ServiceFieldName();
+  (*vars)["file_name"] = service.file_name;
   (*vars)["rsocket_rpc_version"] = "";
   #ifdef rsocket_rpc_version
   if (!disable_version) {
@@ -303,36 +129,46 @@ static void PrintInterface(const ServiceDescriptor* service,
   // Service IDs
   p->Print(*vars, "String $service_field_name$ = \"$Package$$service_name$\";\n");
 
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["method_field_name"] = MethodFieldName(method);
-    (*vars)["route_field_name"] = RouteFieldName(method);
-    (*vars)["method_name"] = method->name();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["method_field_name"] = method.field_name;
+    (*vars)["route_field_name"] = method.route_field_name;
+    (*vars)["method_name"] = method.name;
 
     p->Print(*vars, "String $method_field_name$ = \"$method_name$\";\n");
     p->Print(*vars, "String $route_field_name$ = $service_field_name$ + \".\" + $method_field_name$;\n");
+    if (method.kind == rsocket_rpc_generator::REQUEST_RESPONSE) {
+      (*vars)["batch_field_name"] = method.batch_field_name;
+      (*vars)["batch_route_field_name"] = method.batch_route_field_name;
+      p->Print(*vars, "String $batch_field_name$ = $method_field_name$ + \"/batch\";\n");
+      p->Print(*vars, "String $batch_route_field_name$ = $service_field_name$ + \".\" + $batch_field_name$;\n");
+    }
   }
 
   // RPC methods
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     // Method signature
     p->Print("\n");
     WriteMethodDocComment(p, method);
 
+    if (method.chunked) {
+      PrintChunkedSignature(method, vars, p, true);
+      p->Print(";\n");
+      continue;
+    }
     if (server_streaming) {
       p->Print(*vars, "$Flux$<$output_type$> $lower_method_name$");
     } else if (client_streaming) {
       p->Print(*vars, "$Mono$<$output_type$> $lower_method_name$");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(*vars, "$Mono$<Void> $lower_method_name$");
       } else {
         p->Print(*vars, "$Mono$<$output_type$> $lower_method_name$");
@@ -347,20 +183,183 @@ static void PrintInterface(const ServiceDescriptor* service,
     }
   }
 
+  // Overloads the server hands reused request builders to
+  if (reuse_builders) {
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      if (method.client_streaming || method.chunked) {
+        continue;
+      }
+      (*vars)["input_type"] = method.input_type;
+      (*vars)["output_type"] = method.output_type;
+      (*vars)["lower_method_name"] = method.lower_name;
+
+      p->Print(
+          *vars,
+          "\n"
+          "/**\n"
+          " * Handles a request the server parsed into a builder that it reuses for the next request\n"
+          " * on the same thread. The builder is only valid until this method returns: read what the\n"
+          " * response needs before returning, and neither retain the builder nor read it from the\n"
+          " * returned publisher. By default it is built into a message for the overload taking one.\n"
+          " */\n");
+      if (method.server_streaming) {
+        p->Print(*vars, "default $Flux$<$output_type$> $lower_method_name$");
+      } else if (method.fire_and_forget) {
+        p->Print(*vars, "default $Mono$<Void> $lower_method_name$");
+      } else {
+        p->Print(*vars, "default $Mono$<$output_type$> $lower_method_name$");
+      }
+      p->Print(
+          *vars,
+          "($input_type$OrBuilder message, $ByteBuf$ metadata) {\n"
+          "  return $lower_method_name$(message instanceof $input_type$ ? ($input_type$) message : (($input_type$.Builder) message).build(), metadata);\n"
+          "}\n");
+    }
+  }
+
+  p->Outdent();
+  p->Print("}\n");
+}
+
+// Returns the type of the values the client side metrics and tracing of a
+// method observe: the payloads for a chunked response, which is only decoded
+// after them, the response messages otherwise.
+static string ClientValueType(const MethodModel& method, Variables* vars) {
+  return method.chunked_response_field != NULL ? (*vars)["Payload"] : method.output_type;
+}
+
+// Prints both client methods of a chunked method. The request is sent as a
+// channel if it is chunked, the response is decoded into a chunked message.
+static void PrintChunkedClientMethods(const MethodModel& method, Variables* vars, Printer* p) {
+  (*vars)["chunked_field"] = method.chunked_field;
+  (*vars)["chunked_field_name"] = method.chunked_field_name;
+  p->Print(*vars, "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n");
+  p->Print("public ");
+  PrintChunkedSignature(method, vars, p, false);
+  p->Print(" {\n");
+  p->Indent();
+  p->Print(*vars, "return $lower_method_name$(message, $Unpooled$.EMPTY_BUFFER);\n");
+  p->Outdent();
+  p->Print("}\n\n");
+
+  p->Print(
+      *vars,
+      "@$Override$\n"
+      "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
+      "public ");
+  PrintChunkedSignature(method, vars, p, true);
+  p->Print(" {\n");
+  p->Indent();
+  p->Print(*vars, "$BinaryTraceContext$ traceContext = new $BinaryTraceContext$();\n");
+  if (method.chunked_request_field != NULL) {
+    p->Print(*vars, "return rSocket.requestChannel($Flux$.defer(new $Supplier$<$Flux$<$Payload$>>() {\n");
+  } else {
+    p->Print(*vars, "return $Flux$.defer(new $Supplier$<$Flux$<$Payload$>>() {\n");
+  }
+  p->Indent();
+  p->Print(
+      *vars,
+      "@$Override$\n"
+      "public $Flux$<$Payload$> get() {\n");
+  p->Indent();
+  if (method.chunked_request_field != NULL) {
+    p->Print(
+        *vars,
+        "if (!message.header().get$chunked_field_name$().isEmpty()) {\n"
+        "  metadata.release();\n"
+        "  return $Flux$.error(new IllegalArgumentException(\"The $chunked_field$ field of a chunked message is sent in chunks and must be empty in its header\"));\n"
+        "}\n"
+        "final $ByteBuf$ data = serialize(message.header());\n");
+  } else {
+    p->Print(*vars, "final $ByteBuf$ data = serialize(message);\n");
+  }
+  p->Print(
+      *vars,
+      "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
+      "metadata.release();\n");
+  if (method.chunked_request_field != NULL) {
+    p->Print(*vars, "return $Chunks$.encode($ByteBufPayload$.create(data, metadataBuf), message.data());\n");
+  } else {
+    p->Print(*vars, "return rSocket.requestStream($ByteBufPayload$.create(data, metadataBuf));\n");
+  }
   p->Outdent();
   p->Print("}\n");
+  p->Outdent();
+  if (method.chunked_request_field != NULL) {
+    p->Print("}))");
+  } else {
+    p->Print("}).transform(retryAfterBackoff::apply)");
+  }
+  if (method.chunked_response_field != NULL) {
+    p->Print(
+        *vars,
+        ".transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext)).as(payloads -> $Chunks$.decode(payloads, deserializer($output_type$.parser())));\n");
+  } else {
+    p->Print(
+        *vars,
+        ".map(deserializer($output_type$.parser())).single().transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
+  }
+  p->Outdent();
+  p->Print("}\n\n");
+}
+
+// Prints both batch methods of a request-response method, which send any
+// number of requests over one channel and take their responses back in
+// completion or, if asked to, in request order.
+static void PrintBatchClientMethods(const MethodModel& method, Variables* vars, Printer* p) {
+  (*vars)["batch_field_name"] = method.batch_field_name;
+  p->Print(
+      *vars,
+      "/**\n"
+      " * Sends the requests as one batch and emits their responses as they complete.\n"
+      " */\n"
+      "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
+      "public $Flux$<$output_type$> $lower_method_name$Batch($Publisher$<$input_type$> messages) {\n"
+      "  return $lower_method_name$Batch(messages, false, $Unpooled$.EMPTY_BUFFER);\n"
+      "}\n\n");
+
+  p->Print(
+      *vars,
+      "/**\n"
+      " * Sends the requests as one batch with the given metadata. With {@code ordered} the responses\n"
+      " * are emitted in the order of their requests, otherwise as they complete. The first failed\n"
+      " * request fails the whole batch.\n"
+      " */\n"
+      "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
+      "public $Flux$<$output_type$> $lower_method_name$Batch($Publisher$<$input_type$> messages, boolean ordered, $ByteBuf$ metadata) {\n");
+  p->Indent();
+  p->Print(
+      *vars,
+      "$BinaryTraceContext$ traceContext = new $BinaryTraceContext$();\n"
+      "return $Flux$.defer(new $Supplier$<$Flux$<$Payload$>>() {\n");
+  p->Indent();
+  p->Print(
+      *vars,
+      "@$Override$\n"
+      "public $Flux$<$Payload$> get() {\n"
+      "  final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$batch_field_name$);\n"
+      "  metadata.release();\n"
+      "  return rSocket.requestChannel($Batches$.requests(messages, $client_class_name$::serialize, metadataBuf));\n"
+      "}\n");
+  p->Outdent();
+  p->Print(
+      *vars,
+      "}).as(responses -> $Batches$.responses(responses, ordered, deserializer($output_type$.parser()))).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
+  p->Outdent();
+  p->Print("}\n\n");
 }
 
-static void PrintClient(const ServiceDescriptor* service,
-                        std::map<string, string>* vars,
+static void PrintClient(const ServiceModel& service,
+                        Variables* vars,
                         Printer* p,
                         ProtoFlavor flavor,
                         bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["service_field_name"] = ServiceFieldName(service);
+  (*vars)["service_name"] = service.name;
+  (*vars)["service_field_name"] = ServiceFieldName();
 
-  (*vars)["file_name"] = service->file()->name();
-  (*vars)["client_class_name"] = ClientClassName(service);
+  (*vars)["file_name"] = service.file_name;
+  (*vars)["client_class_name"] = ClientClassName(service.descriptor);
   (*vars)["rsocket_rpc_version"] = "";
   (*vars)["version"] = "";
   #ifdef rsocket_rpc_version
@@ -386,13 +385,12 @@ static void PrintClient(const ServiceDescriptor* service,
       "private final $MetadataEncoder$ metadataEncoder;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["output_type"] = ClientValueType(method, vars);
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     if (server_streaming) {
       p->Print(
@@ -403,7 +401,7 @@ static void PrintClient(const ServiceDescriptor* service,
           *vars,
           "private final $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>> $lower_method_name$;\n");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "private final $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>> $lower_method_name$;\n");
@@ -415,37 +413,60 @@ static void PrintClient(const ServiceDescriptor* service,
     }
   }
 
+  // Latency histograms
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["output_type"] = ClientValueType(method, vars);
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
+
+    if (method.fire_and_forget) {
+      p->Print(
+          *vars,
+          "private final $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>> $lower_method_name$Latency = $RSocketRpcMetrics$.sharedRecorded($LatencyRecorder$.global(), $service_name$.$service_field_name$, $service_name$.$method_field_name$, \"client\");\n");
+    } else {
+      p->Print(
+          *vars,
+          "private final $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>> $lower_method_name$Latency = $RSocketRpcMetrics$.sharedRecorded($LatencyRecorder$.global(), $service_name$.$service_field_name$, $service_name$.$method_field_name$, \"client\");\n");
+    }
+  }
+
   // Tracing
-  for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-      (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-      (*vars)["lower_method_name"] = LowerMethodName(method);
-      bool client_streaming = method->client_streaming();
-      bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["output_type"] = ClientValueType(method, vars);
+      (*vars)["lower_method_name"] = method.lower_name;
+      bool client_streaming = method.client_streaming;
+      bool server_streaming = method.server_streaming;
 
       if (server_streaming) {
         p->Print(
             *vars,
-            "private final $Function$<$Map$<String, String>, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
+            "private final $Function$<$BinaryTraceContext$, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
       } else if (client_streaming) {
         p->Print(
             *vars,
-            "private final $Function$<$Map$<String, String>, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
+            "private final $Function$<$BinaryTraceContext$, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
       } else {
-        const Descriptor* output_type = method->output_type();
-        if (options.fire_and_forget()) {
+        if (method.fire_and_forget) {
           p->Print(
               *vars,
-              "private final $Function$<$Map$<String, String>, $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>>> $lower_method_name$Trace;\n");
+              "private final $Function$<$BinaryTraceContext$, $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>>> $lower_method_name$Trace;\n");
         } else {
           p->Print(
               *vars,
-              "private final $Function$<$Map$<String, String>, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
+              "private final $Function$<$BinaryTraceContext$, $Function$<? super $Publisher$<$output_type$>, ? extends $Publisher$<$output_type$>>> $lower_method_name$Trace;\n");
         }
       }
     }
 
+  // Back-off on server rejections
+  if (!service.request_response.empty() || !service.request_stream.empty()) {
+    p->Print(
+        *vars,
+        "private final $RetryAfterBackoff$ retryAfterBackoff = new $RetryAfterBackoff$();\n");
+  }
+
   // RSocket only
   p->Print(
       *vars,
@@ -462,9 +483,9 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = new $DefaultMetadataEncoder$($ByteBufAllocator$.DEFAULT);\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -472,13 +493,13 @@ static void PrintClient(const ServiceDescriptor* service,
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace();\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.traceContext();\n");
   }
 
   p->Outdent();
@@ -500,9 +521,9 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = metadataEncoder;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
@@ -510,13 +531,13 @@ static void PrintClient(const ServiceDescriptor* service,
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace();\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.traceContext();\n");
   }
 
   p->Outdent();
@@ -537,25 +558,25 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = new $DefaultMetadataEncoder$($ByteBufAllocator$.DEFAULT);\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$ = $RSocketRpcMetrics$.timed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
+        "this.$lower_method_name$ = $RSocketRpcMetrics$.sharedTimed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace();\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.traceContext();\n");
   }
 
   p->Outdent();
@@ -576,25 +597,25 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = metadataEncoder;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$ = $RSocketRpcMetrics$.timed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
+        "this.$lower_method_name$ = $RSocketRpcMetrics$.sharedTimed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace();\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.traceContext();\n");
   }
 
   p->Outdent();
@@ -616,10 +637,10 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = new $DefaultMetadataEncoder$($ByteBufAllocator$.DEFAULT);\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
@@ -627,14 +648,14 @@ static void PrintClient(const ServiceDescriptor* service,
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace(tracer, $service_name$.$method_field_name$, $Tag$.of(\"rsocket.service\", $service_name$.$service_field_name$), $Tag$.of(\"rsocket.rpc.role\", \"client\"), $Tag$.of(\"rsocket.rpc.version\", \"$version$\"));\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.sharedTraceContext(tracer, $service_name$.$method_field_name$, \"rsocket.service\", $service_name$.$service_field_name$, \"rsocket.rpc.role\", \"client\", \"rsocket.rpc.version\", \"$version$\");\n");
   }
 
   p->Outdent();
@@ -656,10 +677,10 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = metadataEncoder;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
@@ -667,14 +688,14 @@ static void PrintClient(const ServiceDescriptor* service,
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace(tracer, $service_name$.$method_field_name$, $Tag$.of(\"rsocket.service\", $service_name$.$service_field_name$), $Tag$.of(\"rsocket.rpc.role\", \"client\"), $Tag$.of(\"rsocket.rpc.version\", \"$version$\"));\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.sharedTraceContext(tracer, $service_name$.$method_field_name$, \"rsocket.service\", $service_name$.$service_field_name$, \"rsocket.rpc.role\", \"client\", \"rsocket.rpc.version\", \"$version$\");\n");
   }
 
   p->Outdent();
@@ -697,25 +718,25 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = new $DefaultMetadataEncoder$($ByteBufAllocator$.DEFAULT);\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$ = $RSocketRpcMetrics$.timed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
+        "this.$lower_method_name$ = $RSocketRpcMetrics$.sharedTimed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace(tracer, $service_name$.$method_field_name$, $Tag$.of(\"rsocket.service\", $service_name$.$service_field_name$), $Tag$.of(\"rsocket.rpc.role\", \"client\"), $Tag$.of(\"rsocket.rpc.version\", \"$version$\"));\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.sharedTraceContext(tracer, $service_name$.$method_field_name$, \"rsocket.service\", $service_name$.$service_field_name$, \"rsocket.rpc.role\", \"client\", \"rsocket.rpc.version\", \"$version$\");\n");
   }
 
   p->Outdent();
@@ -737,25 +758,25 @@ static void PrintClient(const ServiceDescriptor* service,
       "this.metadataEncoder = metadataEncoder;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$ = $RSocketRpcMetrics$.timed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
+        "this.$lower_method_name$ = $RSocketRpcMetrics$.sharedTimed(registry, \"rsocket.client\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
   }
 
   // Tracing metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
 
     p->Print(
         *vars,
-        "this.$lower_method_name$Trace = $RSocketRpcTracing$.trace(tracer, $service_name$.$method_field_name$, $Tag$.of(\"rsocket.service\", $service_name$.$service_field_name$), $Tag$.of(\"rsocket.rpc.role\", \"client\"), $Tag$.of(\"rsocket.rpc.version\", \"$version$\"));\n");
+        "this.$lower_method_name$Trace = $RSocketRpcTracing$.sharedTraceContext(tracer, $service_name$.$method_field_name$, \"rsocket.service\", $service_name$.$service_field_name$, \"rsocket.rpc.role\", \"client\", \"rsocket.rpc.version\", \"$version$\");\n");
   }
 
   p->Outdent();
@@ -763,15 +784,19 @@ static void PrintClient(const ServiceDescriptor* service,
 
 
   // RPC methods
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    (*vars)["method_field_name"] = MethodFieldName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
+
+    if (method.chunked) {
+      PrintChunkedClientMethods(method, vars, p);
+      continue;
+    }
 
     // Method signature
     if (server_streaming) {
@@ -785,8 +810,7 @@ static void PrintClient(const ServiceDescriptor* service,
           "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
           "public $Mono$<$output_type$> $lower_method_name$");
     } else {
-      const Descriptor* output_type = method->output_type();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
@@ -836,7 +860,7 @@ static void PrintClient(const ServiceDescriptor* service,
           "@$RSocketRpcGeneratedMethod$(returnTypeClass = $output_type$.class)\n"
           "public $Mono$<$output_type$> $lower_method_name$");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "@$Override$\n"
@@ -855,7 +879,7 @@ static void PrintClient(const ServiceDescriptor* service,
       p->Print(
           *vars,
           "($Publisher$<$input_type$> messages, $ByteBuf$ metadata) {\n"
-          "$Map$<String, String> map = new $HashMap$<>();\n"
+          "$BinaryTraceContext$ traceContext = new $BinaryTraceContext$();\n"
           );
       p->Indent();
       p->Print(
@@ -894,7 +918,7 @@ static void PrintClient(const ServiceDescriptor* service,
       p->Print(
           *vars,
           "first = false;\n"
-          "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, new $SimpleSpanContext$(map), $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
+          "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
           "metadata.release();\n"
           "return $ByteBufPayload$.create(data, metadataBuf);\n");
       p->Outdent();
@@ -917,11 +941,11 @@ static void PrintClient(const ServiceDescriptor* service,
       if (server_streaming) {
         p->Print(
             *vars,
-            "})).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Trace.apply(map));\n");
+            "})).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
       } else {
         p->Print(
             *vars,
-            "})).map(deserializer($output_type$.parser())).single().transform($lower_method_name$).transform($lower_method_name$Trace.apply(map));\n");
+            "})).map(deserializer($output_type$.parser())).single().transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
       }
       p->Outdent();
       p->Outdent();
@@ -931,7 +955,7 @@ static void PrintClient(const ServiceDescriptor* service,
       p->Print(
           *vars,
           "($input_type$ message, $ByteBuf$ metadata) {\n"
-          "$Map$<String, String> map = new $HashMap$<>();\n"
+          "$BinaryTraceContext$ traceContext = new $BinaryTraceContext$();\n"
           );
       p->Indent();
 
@@ -948,7 +972,7 @@ static void PrintClient(const ServiceDescriptor* service,
         p->Print(
             *vars,
             "final $ByteBuf$ data = serialize(message);\n"
-            "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, new $SimpleSpanContext$(map), $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
+            "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
             "metadata.release();\n"
             "return rSocket.requestStream($ByteBufPayload$.create(data, metadataBuf));\n");
         p->Outdent();
@@ -956,9 +980,9 @@ static void PrintClient(const ServiceDescriptor* service,
         p->Outdent();
         p->Print(
             *vars,
-            "}).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Trace.apply(map));\n");
+            "}).transform(retryAfterBackoff::apply).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
       } else {
-        if (options.fire_and_forget()) {
+        if (method.fire_and_forget) {
           p->Print(
               *vars,
               "return $Mono$.defer(new $Supplier$<$Mono$<Void>>() {\n");
@@ -971,7 +995,7 @@ static void PrintClient(const ServiceDescriptor* service,
           p->Print(
               *vars,
               "final $ByteBuf$ data = serialize(message);\n"
-              "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, new $SimpleSpanContext$(map), $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
+              "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
               "metadata.release();\n"
               "return rSocket.fireAndForget($ByteBufPayload$.create(data, metadataBuf));\n");
           p->Outdent();
@@ -979,7 +1003,7 @@ static void PrintClient(const ServiceDescriptor* service,
           p->Outdent();
           p->Print(
               *vars,
-              "}).transform($lower_method_name$).transform($lower_method_name$Trace.apply(map));\n");
+              "}).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
         } else {
           p->Print(
               *vars,
@@ -993,7 +1017,7 @@ static void PrintClient(const ServiceDescriptor* service,
           p->Print(
               *vars,
               "final $ByteBuf$ data = serialize(message);\n"
-              "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, new $SimpleSpanContext$(map), $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
+              "final $ByteBuf$ metadataBuf = metadataEncoder.encode(metadata, traceContext, $service_name$.$service_field_name$, $service_name$.$method_field_name$);\n"
               "metadata.release();\n"
               "return rSocket.requestResponse($ByteBufPayload$.create(data, metadataBuf));\n");
           p->Outdent();
@@ -1001,13 +1025,17 @@ static void PrintClient(const ServiceDescriptor* service,
           p->Outdent();
           p->Print(
               *vars,
-              "}).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Trace.apply(map));\n");
+              "}).transform(retryAfterBackoff::apply).map(deserializer($output_type$.parser())).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(traceContext));\n");
         }
       }
 
       p->Outdent();
       p->Print("}\n\n");
     }
+
+    if (method.kind == rsocket_rpc_generator::REQUEST_RESPONSE) {
+      PrintBatchClientMethods(method, vars, p);
+    }
   }
 
   // Serialize method
@@ -1082,15 +1110,128 @@ static void PrintClient(const ServiceDescriptor* service,
   p->Print("}\n");
 }
 
-static void PrintServer(const ServiceDescriptor* service,
-                        std::map<string, string>* vars,
+// Hands requests at least as large as the offload threshold to its scheduler,
+// which parses them and calls the handler. Fire-and-forget requests complete
+// the handler chain here; request-response and request-stream handlers return
+// their responses to the admitted section that called them. Smaller requests
+// fall through to the inline parse below.
+static void PrintOffloadedRequest(rsocket_rpc_generator::InteractionKind kind, Variables* vars, Printer* p) {
+  p->Print(
+      *vars,
+      "if (offload != null && offload.offloads(payload)) {\n");
+  p->Indent();
+  switch (kind) {
+    case rsocket_rpc_generator::FIRE_AND_FORGET:
+      p->Print(
+          *vars,
+          "final $ByteBuf$ metadata = decoded.metadata();\n"
+          "return offload.<$input_type$, $Void$>mono(payload, () -> $input_type$.parseFrom($CodedInputStream$.newInstance(payload.getData())), message -> service.$lower_method_name$(message, metadata)).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
+      break;
+    case rsocket_rpc_generator::REQUEST_STREAM:
+      p->Print(
+          *vars,
+          "return offload.<$input_type$, $output_type$>flux(payload, () -> $input_type$.parseFrom($CodedInputStream$.newInstance(payload.getData())), message -> service.$lower_method_name$(message, metadata)).map(serializer);\n");
+      break;
+    default:
+      p->Print(
+          *vars,
+          "return offload.<$input_type$, $output_type$>mono(payload, () -> $input_type$.parseFrom($CodedInputStream$.newInstance(payload.getData())), message -> service.$lower_method_name$(message, metadata)).map(serializer);\n");
+      break;
+  }
+  p->Outdent();
+  p->Print("}\n");
+}
+
+// Runs the handle method of a request-response or request-stream request once
+// the admission admitted it, so shed requests are neither parsed nor handled.
+// The admission owns the payload until then.
+static void PrintAdmittedRequest(rsocket_rpc_generator::InteractionKind kind, Variables* vars, Printer* p) {
+  bool stream = kind == rsocket_rpc_generator::REQUEST_STREAM;
+  (*vars)["admitted_publisher"] = (*vars)[stream ? "Flux" : "Mono"];
+  (*vars)["lower_admitted_publisher"] = stream ? "flux" : "mono";
+  (*vars)["admitted_kind"] = stream ? "RequestStream" : "RequestResponse";
+  p->Print(
+      *vars,
+      "private $admitted_publisher$<$Payload$> do$method_name$$admitted_kind$($Payload$ payload, $MetadataDecoder$.Metadata decoded) throws $Exception$ {\n");
+  p->Indent();
+  p->Print(
+      *vars,
+      "final $ByteBuf$ metadata = decoded.metadata();\n"
+      "$admitted_publisher$<$Payload$> response = admission == null ? handle$method_name$$admitted_kind$(payload, metadata) : admission.<$Payload$>$lower_admitted_publisher$(payload, () -> handle$method_name$$admitted_kind$(payload, metadata));\n"
+      "return response.transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
+  p->Outdent();
+  p->Print("}\n\n");
+  p->Print(
+      *vars,
+      "private $admitted_publisher$<$Payload$> handle$method_name$$admitted_kind$($Payload$ payload, $ByteBuf$ metadata) throws $Exception$ {\n");
+}
+
+// Parses the request into the method's per-thread builder. A nested call on the
+// same thread, e.g. over a local transport, finds the builder taken and parses
+// into a new one instead.
+static void PrintTakeRequestBuilder(Variables* vars, Printer* p) {
+  p->Print(
+      *vars,
+      "$input_type$.Builder builder = $lower_method_name$Builder.get();\n"
+      "if (builder == null) {\n"
+      "  builder = $input_type$.newBuilder();\n"
+      "} else {\n"
+      "  $lower_method_name$Builder.set(null);\n"
+      "}\n"
+      "try {\n");
+  p->Indent();
+  p->Print(
+      *vars,
+      "builder.mergeFrom($CodedInputStream$.newInstance(payload.getData()));\n");
+}
+
+static void PrintReturnRequestBuilder(Variables* vars, Printer* p) {
+  p->Outdent();
+  p->Print(
+      *vars,
+      "} finally {\n"
+      "  builder.clear();\n"
+      "  $lower_method_name$Builder.set(builder);\n"
+      "}\n");
+}
+
+// Numbers the routes of the given methods, followed by the batch routes of the
+// batched ones, for the dispatch switch of one interaction model. The switch
+// finds the index straight from the request metadata, so dispatching a request
+// decodes no route.
+static void PrintRouteIndex(const char* field_name,
+                            const vector<const MethodModel*>& methods,
+                            const vector<const MethodModel*>& batched,
+                            Variables* vars,
+                            Printer* p) {
+  (*vars)["route_index_field"] = field_name;
+  p->Print(*vars, "private static final $RouteIndex$ $route_index_field$ = new $RouteIndex$(");
+  const char* separator = "";
+  for (size_t i = 0; i < methods.size(); ++i) {
+    (*vars)["separator"] = separator;
+    (*vars)["route_field_name"] = methods[i]->route_field_name;
+    p->Print(*vars, "$separator$$service_name$.$route_field_name$");
+    separator = ", ";
+  }
+  for (size_t i = 0; i < batched.size(); ++i) {
+    (*vars)["separator"] = separator;
+    (*vars)["batch_route_field_name"] = batched[i]->batch_route_field_name;
+    p->Print(*vars, "$separator$$service_name$.$batch_route_field_name$");
+    separator = ", ";
+  }
+  p->Print(");\n\n");
+}
+
+static void PrintServer(const ServiceModel& service,
+                        Variables* vars,
                         Printer* p,
                         ProtoFlavor flavor,
-                        bool disable_version) {
-  (*vars)["service_name"] = service->name();
-  (*vars)["service_field_name"] = ServiceFieldName(service);
-  (*vars)["file_name"] = service->file()->name();
-  (*vars)["server_class_name"] = ServerClassName(service);
+                        bool disable_version,
+                        bool reuse_builders) {
+  (*vars)["service_name"] = service.name;
+  (*vars)["service_field_name"] = ServiceFieldName();
+  (*vars)["file_name"] = service.file_name;
+  (*vars)["server_class_name"] = ServerClassName(service.descriptor);
   (*vars)["rsocket_rpc_version"] = "";
   (*vars)["version"] = "";
   #ifdef rsocket_rpc_version
@@ -1119,12 +1260,11 @@ static void PrintServer(const ServiceDescriptor* service,
       "private final $Tracer$ tracer;\n");
 
   // RPC metrics
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     if (server_streaming) {
       p->Print(
@@ -1135,7 +1275,7 @@ static void PrintServer(const ServiceDescriptor* service,
           *vars,
           "private final $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> $lower_method_name$;\n");
     } else {
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
             "private final $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>> $lower_method_name$;\n");
@@ -1147,33 +1287,78 @@ static void PrintServer(const ServiceDescriptor* service,
     }
   }
 
+  // Latency histograms
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["method_field_name"] = method.field_name;
+
+    if (method.fire_and_forget) {
+      p->Print(
+          *vars,
+          "private final $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>> $lower_method_name$Latency = $RSocketRpcMetrics$.sharedRecorded($LatencyRecorder$.global(), $service_name$.$service_field_name$, $service_name$.$method_field_name$, \"server\");\n");
+    } else {
+      p->Print(
+          *vars,
+          "private final $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> $lower_method_name$Latency = $RSocketRpcMetrics$.sharedRecorded($LatencyRecorder$.global(), $service_name$.$service_field_name$, $service_name$.$method_field_name$, \"server\");\n");
+    }
+  }
+
   // Tracing
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    bool client_streaming = method.client_streaming;
+    bool server_streaming = method.server_streaming;
 
     if (server_streaming) {
       p->Print(
           *vars,
-          "private final $Function$<$SpanContext$, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
+          "private final $Function$<$MetadataDecoder$.Metadata, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
     } else if (client_streaming) {
       p->Print(
           *vars,
-          "private final $Function$<$SpanContext$, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
+          "private final $Function$<$MetadataDecoder$.Metadata, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
     } else {
-      const Descriptor* output_type = method->output_type();
-      if (options.fire_and_forget()) {
+      if (method.fire_and_forget) {
         p->Print(
             *vars,
-            "private final $Function$<$SpanContext$, $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>>> $lower_method_name$Trace;\n");
+            "private final $Function$<$MetadataDecoder$.Metadata, $Function$<? super $Publisher$<Void>, ? extends $Publisher$<Void>>> $lower_method_name$Trace;\n");
       } else {
         p->Print(
             *vars,
-            "private final $Function$<$SpanContext$, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
+            "private final $Function$<$MetadataDecoder$.Metadata, $Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>>> $lower_method_name$Trace;\n");
+      }
+    }
+  }
+
+  // Admission
+  if (!service.request_response.empty() || !service.request_stream.empty()) {
+    p->Print(
+        *vars,
+        "private final $CoDelAdmission$ admission = $CoDelAdmission$.global();\n");
+  }
+
+  // Parse offload
+  if (!service.fire_and_forget.empty() || !service.request_response.empty() ||
+      !service.request_stream.empty()) {
+    p->Print(
+        *vars,
+        "private final $ParseOffload$ offload = $ParseOffload$.global();\n");
+  }
+
+  // Reused request builders
+  if (reuse_builders) {
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      if (method.client_streaming || method.chunked) {
+        continue;
       }
+      (*vars)["input_type"] = method.input_type;
+      (*vars)["lower_method_name"] = method.lower_name;
+      p->Print(
+          *vars,
+          "private static final $ThreadLocal$<$input_type$.Builder> $lower_method_name$Builder = $ThreadLocal$.withInitial($input_type$::newBuilder);\n");
     }
   }
 
@@ -1192,9 +1377,9 @@ static void PrintServer(const ServiceDescriptor* service,
         "if (!registry.isPresent()) {\n"
     );
     p->Indent();
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
 
       p->Print(
          *vars,
@@ -1208,14 +1393,14 @@ static void PrintServer(const ServiceDescriptor* service,
         "} else {\n"
     );
     p->Indent();
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
-      (*vars)["method_field_name"] = MethodFieldName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
+      (*vars)["method_field_name"] = method.field_name;
 
       p->Print(
           *vars,
-          "this.$lower_method_name$ = $RSocketRpcMetrics$.timed(registry.get(), \"rsocket.server\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
+          "this.$lower_method_name$ = $RSocketRpcMetrics$.sharedTimed(registry.get(), \"rsocket.server\", \"service\", $service_name$.$service_field_name$, \"method\", $service_name$.$method_field_name$);\n");
     }
 
     p->Outdent();
@@ -1232,9 +1417,9 @@ static void PrintServer(const ServiceDescriptor* service,
         *vars,
         "this.tracer = null;\n"
     );
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
 
       p->Print(
          *vars,
@@ -1252,14 +1437,14 @@ static void PrintServer(const ServiceDescriptor* service,
         *vars,
         "this.tracer = tracer.get();\n"
     );
-    for (int i = 0; i < service->method_count(); ++i) {
-      const MethodDescriptor* method = service->method(i);
-      (*vars)["lower_method_name"] = LowerMethodName(method);
-      (*vars)["method_field_name"] = MethodFieldName(method);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      (*vars)["lower_method_name"] = method.lower_name;
+      (*vars)["method_field_name"] = method.field_name;
 
       p->Print(
           *vars,
-          "this.$lower_method_name$Trace = $RSocketRpcTracing$.traceAsChild(this.tracer, $service_name$.$method_field_name$, $Tag$.of(\"rsocket.service\", $service_name$.$service_field_name$), $Tag$.of(\"rsocket.rpc.role\", \"server\"), $Tag$.of(\"rsocket.rpc.version\", \"$version$\"));\n");
+          "this.$lower_method_name$Trace = $RSocketRpcTracing$.sharedTraceRequest(this.tracer, $service_name$.$method_field_name$, \"rsocket.service\", $service_name$.$service_field_name$, \"rsocket.rpc.role\", \"server\", \"rsocket.rpc.version\", \"$version$\");\n");
     }
     p->Outdent();
     p->Print("}\n\n");
@@ -1309,37 +1494,13 @@ static void PrintServer(const ServiceDescriptor* service,
     p->Outdent();
     p->Print("}\n\n");
 
-  std::vector<const MethodDescriptor*> fire_and_forget;
-  std::vector<const MethodDescriptor*> request_response;
-  std::vector<const MethodDescriptor*> request_stream;
-  std::vector<const MethodDescriptor*> request_channel;
-
-  for (int i = 0; i < service->method_count(); ++i) {
-    const MethodDescriptor* method = service->method(i);
-    const RSocketMethodOptions options = method->options().GetExtension(io::rsocket::rpc::options);
-    bool client_streaming = method->client_streaming();
-    bool server_streaming = method->server_streaming();
-
-    if (client_streaming) {
-      request_channel.push_back(method);
-    } else if (server_streaming) {
-      request_stream.push_back(method);
-    } else {
-      if (options.fire_and_forget()) {
-        fire_and_forget.push_back(method);
-      } else {
-        request_response.push_back(method);
-      }
-    }
-  }
-
   // Fire and forget
   p->Print(
     *vars,
     "@$Override$\n"
     "public $Mono$<$Void$> fireAndForget($Payload$ payload) {\n");
   p->Indent();
-  if (fire_and_forget.empty()) {
+  if (service.fire_and_forget.empty()) {
     p->Print(
         *vars,
         "return $Mono$.error(new UnsupportedOperationException(\"Fire And Forget is not implemented.\"));\n");
@@ -1352,6 +1513,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Mono$<$Void$> response = this.doDecodeAndHandleFireAndForget(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -1375,6 +1537,7 @@ static void PrintServer(const ServiceDescriptor* service,
 
 
   // Do Decode And Fire and forget delegate
+  PrintRouteIndex("FIRE_AND_FORGET_ROUTES", service.fire_and_forget, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Mono$<Void> doDecodeAndHandleFireAndForget(\n");
@@ -1390,16 +1553,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(FIRE_AND_FORGET_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.fire_and_forget.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -1423,22 +1587,31 @@ static void PrintServer(const ServiceDescriptor* service,
 
 
   // Do Service Fire-And-Forget
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
         "private $Mono$<$Void$> do$method_name$FireAndForget($Payload$ payload, $MetadataDecoder$.Metadata decoded) throws $Exception$ {\n"
     );
     p->Indent();
-    p->Print(
-        *vars,
-        "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
-        "return service.$lower_method_name$($input_type$.parseFrom(is), decoded.metadata()).transform($lower_method_name$).transform($lower_method_name$Trace.apply(decoded.spanContext()));\n");
+    PrintOffloadedRequest(rsocket_rpc_generator::FIRE_AND_FORGET, vars, p);
+    if (reuse_builders) {
+      PrintTakeRequestBuilder(vars, p);
+      p->Print(
+          *vars,
+          "return service.$lower_method_name$(builder, decoded.metadata()).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
+      PrintReturnRequestBuilder(vars, p);
+    } else {
+      p->Print(
+          *vars,
+          "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
+          "return service.$lower_method_name$($input_type$.parseFrom(is), decoded.metadata()).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
+    }
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
@@ -1450,7 +1623,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Mono$<$Payload$> requestResponse($Payload$ payload) {\n");
   p->Indent();
-  if (request_response.empty()) {
+  if (service.request_response.empty()) {
     p->Print(
         *vars,
         "return $Mono$.error(new UnsupportedOperationException(\"Request Response is not implemented.\"));\n");
@@ -1463,6 +1636,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Mono$<$Payload$> response = this.doDecodeAndHandleRequestResponse(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -1485,6 +1659,7 @@ static void PrintServer(const ServiceDescriptor* service,
    "}\n\n");
 
   // Do Decode And Request Response delegate
+  PrintRouteIndex("REQUEST_RESPONSE_ROUTES", service.request_response, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Mono$<$Payload$> doDecodeAndHandleRequestResponse(\n");
@@ -1500,16 +1675,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(REQUEST_RESPONSE_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.request_response.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -1532,22 +1708,28 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Request-Response
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-
-    p->Print(
-        *vars,
-        "private $Mono$<$Payload$> do$method_name$RequestResponse($Payload$ payload, $MetadataDecoder$.Metadata decoded) throws $Exception$ {\n"
-    );
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
+
+    PrintAdmittedRequest(rsocket_rpc_generator::REQUEST_RESPONSE, vars, p);
     p->Indent();
-    p->Print(
-        *vars,
-        "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
-        "return service.$lower_method_name$($input_type$.parseFrom(is), decoded.metadata()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Trace.apply(decoded.spanContext()));\n");
+    PrintOffloadedRequest(rsocket_rpc_generator::REQUEST_RESPONSE, vars, p);
+    if (reuse_builders) {
+      PrintTakeRequestBuilder(vars, p);
+      p->Print(
+          *vars,
+          "return service.$lower_method_name$(builder, metadata).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer);\n");
+      PrintReturnRequestBuilder(vars, p);
+    } else {
+      p->Print(
+          *vars,
+          "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
+          "return service.$lower_method_name$($input_type$.parseFrom(is), metadata).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer);\n");
+    }
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
@@ -1560,7 +1742,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestStream($Payload$ payload) {\n");
   p->Indent();
-  if (request_stream.empty()) {
+  if (service.request_stream.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request Stream is not implemented.\"));\n");
@@ -1573,6 +1755,7 @@ static void PrintServer(const ServiceDescriptor* service,
       *vars,
       "$MetadataDecoder$.Metadata decoded = metadataDecoder.decode(payload.sliceMetadata());\n\n"
       "$Flux$<$Payload$> response = this.doDecodeAndHandleRequestStream(payload, decoded);\n\n"
+      "decoded.recycle();\n"
       "payload.release();\n\n"
       "return response;\n");
     p->Outdent();
@@ -1595,6 +1778,7 @@ static void PrintServer(const ServiceDescriptor* service,
    "}\n\n");
 
   // Do Decode And Request Stream delegate
+  PrintRouteIndex("REQUEST_STREAM_ROUTES", service.request_stream, vector<const MethodModel*>(), vars, p);
   p->Print(
     *vars,
     "$Flux$<$Payload$> doDecodeAndHandleRequestStream(\n");
@@ -1610,16 +1794,17 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Indent();
   p->Print(
       *vars,
-      "switch(decoded.route()) {\n");
+      "switch(REQUEST_STREAM_ROUTES.indexOf(decoded)) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["route_index"] = std::to_string(it - service.request_stream.begin());
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
-        "case $service_name$.$route_field_name$: {\n");
+        "case $route_index$: {\n");
     p->Indent();
     p->Print(
         *vars,
@@ -1642,34 +1827,50 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Service Request-Stream
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
-
-    p->Print(
-        *vars,
-        "private $Flux$<$Payload$> do$method_name$RequestStream($Payload$ payload, $MetadataDecoder$.Metadata decoded) throws $Exception$ {\n"
-    );
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
+
+    PrintAdmittedRequest(rsocket_rpc_generator::REQUEST_STREAM, vars, p);
     p->Indent();
-    p->Print(
-        *vars,
-        "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
-        "return service.$lower_method_name$($input_type$.parseFrom(is), decoded.metadata()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Trace.apply(decoded.spanContext()));\n");
+    if (!method.chunked) {
+      PrintOffloadedRequest(rsocket_rpc_generator::REQUEST_STREAM, vars, p);
+    }
+    if (method.chunked) {
+      (*vars)["chunked_field"] = method.chunked_field;
+      (*vars)["chunked_field_name"] = method.chunked_field_name;
+      p->Print(
+          *vars,
+          "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
+          "return service.$lower_method_name$($input_type$.parseFrom(is), metadata).transform($ThreadPerCore$.<$Chunked$<$output_type$>>pinned()).doOnNext(chunked -> { if (!chunked.header().get$chunked_field_name$().isEmpty()) throw new IllegalArgumentException(\"The $chunked_field$ field of a chunked message is sent in chunks and must be empty in its header\"); }).flatMapMany($Chunks$.encoder(serializer));\n");
+    } else if (reuse_builders) {
+      PrintTakeRequestBuilder(vars, p);
+      p->Print(
+          *vars,
+          "return service.$lower_method_name$(builder, metadata).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer);\n");
+      PrintReturnRequestBuilder(vars, p);
+    } else {
+      p->Print(
+          *vars,
+          "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
+          "return service.$lower_method_name$($input_type$.parseFrom(is), metadata).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer);\n");
+    }
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
   }
 
   // Request-Channel
+  PrintRouteIndex("REQUEST_CHANNEL_ROUTES", service.request_channel, service.request_response, vars, p);
   p->Print(
       *vars,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestChannel($Payload$ payload, $Flux$<$Payload$> payloads) {\n");
   p->Indent();
-  if (request_channel.empty()) {
+  if (service.request_channel.empty() && service.request_response.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request Channel is not implemented.\"));\n");
@@ -1684,20 +1885,40 @@ static void PrintServer(const ServiceDescriptor* service,
 
     p->Print(
         *vars,
-        "switch(decoded.route()) {\n");
+        "switch(REQUEST_CHANNEL_ROUTES.indexOf(decoded)) {\n");
     p->Indent();
-    for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-      const MethodDescriptor* method = *it;
-      (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-      (*vars)["method_name"] = method->name();
-      (*vars)["route_field_name"] = RouteFieldName(method);
+    for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+      const MethodModel& method = **it;
+      (*vars)["route_index"] = std::to_string(it - service.request_channel.begin());
+      (*vars)["input_type"] = method.input_type;
+      (*vars)["method_name"] = method.name;
+      (*vars)["route_field_name"] = method.route_field_name;
       p->Print(
           *vars,
-          "case $service_name$.$route_field_name$: {\n");
+          "case $route_index$: {\n");
       p->Indent();
       p->Print(
           *vars,
-          "return this.do$method_name$RequestChannel(payloads, payload, decoded);\n");
+          "$Flux$<$Payload$> response = this.do$method_name$RequestChannel(payloads, payload, decoded);\n"
+          "decoded.recycle();\n"
+          "return response;\n");
+      p->Outdent();
+      p->Print("}\n");
+    }
+    for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+      const MethodModel& method = **it;
+      (*vars)["route_index"] = std::to_string(service.request_channel.size() + (it - service.request_response.begin()));
+      (*vars)["method_name"] = method.name;
+      (*vars)["batch_route_field_name"] = method.batch_route_field_name;
+      p->Print(
+          *vars,
+          "case $route_index$: {\n");
+      p->Indent();
+      p->Print(
+          *vars,
+          "$Flux$<$Payload$> response = this.do$method_name$Batch(payloads, payload, decoded);\n"
+          "decoded.recycle();\n"
+          "return response;\n");
       p->Outdent();
       p->Print("}\n");
     }
@@ -1707,6 +1928,7 @@ static void PrintServer(const ServiceDescriptor* service,
     p->Indent();
     p->Print(
         *vars,
+        "decoded.recycle();\n"
         "payload.release();\n"
         "return $Flux$.error(new UnsupportedOperationException());\n");
     p->Outdent();
@@ -1737,7 +1959,7 @@ static void PrintServer(const ServiceDescriptor* service,
       "@$Override$\n"
       "public $Flux$<$Payload$> requestChannel($Publisher$<$Payload$> payloads) {\n");
   p->Indent();
-  if (request_channel.empty()) {
+  if (service.request_channel.empty() && service.request_response.empty()) {
     p->Print(
         *vars,
         "return $Flux$.error(new UnsupportedOperationException(\"Request-Channel not implemented.\"));\n");
@@ -1775,18 +1997,44 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n\n");
 
   // Do Request-Channel
-  for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["input_type"] = MessageFullJavaName(method->input_type());
-    (*vars)["output_type"] = MessageFullJavaName(method->output_type());
-    (*vars)["method_name"] = method->name();
-    (*vars)["lower_method_name"] = LowerMethodName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
 
     p->Print(
         *vars,
         "private $Flux$<$Payload$> do$method_name$RequestChannel($Flux$<$Payload$> publisher, $Payload$ payload, $MetadataDecoder$.Metadata decoded) throws $Exception$ {\n"
     );
     p->Indent();
+    if (method.chunked) {
+      // The first payload carries the header, the rest of the channel the data
+      (*vars)["chunked_field"] = method.chunked_field;
+      (*vars)["chunked_field_name"] = method.chunked_field_name;
+      p->Print(
+          *vars,
+          "$CodedInputStream$ is = $CodedInputStream$.newInstance(payload.getData());\n"
+          "$Chunked$<$input_type$> message = $Chunked$.of($input_type$.parseFrom(is), $Chunks$.data(publisher.skip(1)));\n");
+      if (method.chunked_response_field != NULL) {
+        p->Print(
+            *vars,
+            "$Flux$<$Payload$> response = service.$lower_method_name$(message, decoded.metadata()).transform($ThreadPerCore$.<$Chunked$<$output_type$>>pinned()).doOnNext(chunked -> { if (!chunked.header().get$chunked_field_name$().isEmpty()) throw new IllegalArgumentException(\"The $chunked_field$ field of a chunked message is sent in chunks and must be empty in its header\"); }).flatMapMany($Chunks$.encoder(serializer)).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
+      } else {
+        p->Print(
+            *vars,
+            "$Flux$<$Payload$> response = service.$lower_method_name$(message, decoded.metadata()).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded)).$flux$();\n");
+      }
+      p->Print(
+          *vars,
+          "payload.release();\n"
+          "return response;\n");
+      p->Outdent();
+      p->Print("}\n");
+      p->Print("\n");
+      continue;
+    }
     p->Print(
         *vars,
         "$Flux$<$input_type$> messages =\n");
@@ -1795,20 +2043,46 @@ static void PrintServer(const ServiceDescriptor* service,
         *vars,
         "publisher.map(deserializer($input_type$.parser()));\n");
     p->Outdent();
-    if (method->server_streaming()) {
+    if (method.server_streaming) {
       p->Print(
           *vars,
-          "return service.$lower_method_name$(messages, decoded.metadata()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Trace.apply(decoded.spanContext()));\n");
+          "return service.$lower_method_name$(messages, decoded.metadata()).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded));\n");
     } else {
       p->Print(
           *vars,
-          "return service.$lower_method_name$(messages, decoded.metadata()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Trace.apply(decoded.spanContext())).$flux$();\n");
+          "return service.$lower_method_name$(messages, decoded.metadata()).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer).transform($lower_method_name$).transform($lower_method_name$Latency).transform($lower_method_name$Trace.apply(decoded)).$flux$();\n");
     }
     p->Outdent();
     p->Print("}\n");
     p->Print("\n");
   }
 
+  // Do Batch. The requests of a batch share the metadata of the first one,
+  // which is copied as the first request is released once it is parsed. Every
+  // request reads its own slice of the copy, retained until it terminates, as
+  // the requests run concurrently.
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    (*vars)["method_name"] = method.name;
+    (*vars)["lower_method_name"] = method.lower_name;
+
+    p->Print(
+        *vars,
+        "private $Flux$<$Payload$> do$method_name$Batch($Flux$<$Payload$> publisher, $Payload$ payload, $MetadataDecoder$.Metadata decoded) {\n");
+    p->Indent();
+    p->Print(
+        *vars,
+        "final $ByteBuf$ metadata = $Unpooled$.copiedBuffer(decoded.metadata());\n"
+        "$Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> trace = $lower_method_name$Trace.apply(decoded);\n"
+        "$Function$<? super $Publisher$<$Payload$>, ? extends $Publisher$<$Payload$>> admitted = $CoDelAdmission$.admitted(admission);\n"
+        "return $Batches$.serve(publisher.map(deserializer($input_type$.parser())), message -> $Mono$.<$Payload$, $ByteBuf$>using(metadata::retainedSlice, requestMetadata -> service.$lower_method_name$(message, requestMetadata).transform($ThreadPerCore$.<$output_type$>pinned()).map(serializer), $ByteBuf$::release).transform(admitted).transform($lower_method_name$).transform($lower_method_name$Latency)).transform(trace).doFinally(signal -> metadata.release());\n");
+    p->Outdent();
+    p->Print("}\n");
+    p->Print("\n");
+  }
+
   // Self Registration
 
   p->Print(
@@ -1816,34 +2090,42 @@ static void PrintServer(const ServiceDescriptor* service,
     "@$Override$\n"
     "public void selfRegister($MutableRouter$ router) {\n");
   p->Indent();
-  for (vector<const MethodDescriptor*>::iterator it = fire_and_forget.begin(); it != fire_and_forget.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.fire_and_forget.begin(); it != service.fire_and_forget.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withFireAndForgetRoute($service_name$.$route_field_name$, this::do$method_name$FireAndForget);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_response.begin(); it != request_response.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestResponseRoute($service_name$.$route_field_name$, this::do$method_name$RequestResponse);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_stream.begin(); it != request_stream.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_response.begin(); it != service.request_response.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["batch_route_field_name"] = method.batch_route_field_name;
+    p->Print(
+        *vars,
+        "router.withRequestChannelRoute($service_name$.$batch_route_field_name$, this::do$method_name$Batch);\n");
+  }
+  for (vector<const MethodModel*>::const_iterator it = service.request_stream.begin(); it != service.request_stream.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestStreamRoute($service_name$.$route_field_name$, this::do$method_name$RequestStream);\n");
   }
-  for (vector<const MethodDescriptor*>::iterator it = request_channel.begin(); it != request_channel.end(); ++it) {
-    const MethodDescriptor* method = *it;
-    (*vars)["method_name"] = method->name();
-    (*vars)["route_field_name"] = RouteFieldName(method);
+  for (vector<const MethodModel*>::const_iterator it = service.request_channel.begin(); it != service.request_channel.end(); ++it) {
+    const MethodModel& method = **it;
+    (*vars)["method_name"] = method.name;
+    (*vars)["route_field_name"] = method.route_field_name;
     p->Print(
         *vars,
         "router.withRequestChannelRoute($service_name$.$route_field_name$, this::do$method_name$RequestChannel);\n");
@@ -1852,7 +2134,9 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n");
   p->Print("\n");
 
-  // Serializer
+  // Serializer. ByteBufPayload instances come from a Netty Recycler, releasing
+  // the payload releases its buffers and returns the instance to the pool, so
+  // responses cost no payload allocation on top of their buffer.
   p->Print(
       *vars,
       "private static final $Function$<$MessageLite$, $Payload$> serializer =\n");
@@ -1936,21 +2220,455 @@ static void PrintServer(const ServiceDescriptor* service,
   p->Print("}\n");
 }
 
-void GenerateInterface(const ServiceDescriptor* service,
+static const char* InteractionModelName(rsocket_rpc_generator::InteractionKind kind) {
+  switch (kind) {
+    case rsocket_rpc_generator::FIRE_AND_FORGET:
+      return "FIRE_AND_FORGET";
+    case rsocket_rpc_generator::REQUEST_RESPONSE:
+      return "REQUEST_RESPONSE";
+    case rsocket_rpc_generator::REQUEST_STREAM:
+      return "REQUEST_STREAM";
+    case rsocket_rpc_generator::REQUEST_CHANNEL:
+      return "REQUEST_CHANNEL";
+  }
+  return "";
+}
+
+static void PrintRegistry(const std::vector<const ServiceModel*>& services,
+                          Variables* vars,
+                          Printer* p,
+                          bool disable_version,
+                          bool blocking_api) {
+  (*vars)["rsocket_rpc_version"] = "";
+  #ifdef rsocket_rpc_version
+  if (!disable_version) {
+    (*vars)["rsocket_rpc_version"] = " (version " XSTR(rsocket_rpc_version) ")";
+  }
+  #endif
+  p->Print(
+      *vars,
+      "/**\n"
+      " * Routes, message parsers and generated classes of every service declared in\n"
+      " * $file_name$.\n"
+      " */\n"
+      "@$Generated$(\n"
+      "    value = \"by RSocket RPC proto compiler$rsocket_rpc_version$\",\n"
+      "    comments = \"Source: $file_name$\")\n"
+      "public final class $registry_class_name$ implements $ServiceRegistry$ {\n");
+  p->Indent();
+
+  // Route descriptors
+  std::vector<string> routes;
+  for (size_t s = 0; s < services.size(); ++s) {
+    const ServiceModel& service = *services[s];
+    (*vars)["service_name"] = service.name;
+    (*vars)["server_class_name"] = ServerClassName(service.descriptor);
+    (*vars)["client_class_name"] = ClientClassName(service.descriptor);
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      const MethodModel& method = service.methods[i];
+      string route_constant = rsocket_rpc_generator::ToAllUpperCase(service.name) + "_" +
+          rsocket_rpc_generator::ToAllUpperCase(method.name);
+      routes.push_back(route_constant);
+      (*vars)["route_constant"] = route_constant;
+      (*vars)["method_field_name"] = method.field_name;
+      (*vars)["route_field_name"] = method.route_field_name;
+      (*vars)["interaction_model"] = InteractionModelName(method.kind);
+      (*vars)["input_type"] = method.input_type;
+      (*vars)["output_type"] = method.output_type;
+      p->Print(
+          *vars,
+          "public static final $RouteDescriptor$ $route_constant$ =\n"
+          "    new $RouteDescriptor$(\n"
+          "        $service_name$.SERVICE,\n"
+          "        $service_name$.$method_field_name$,\n"
+          "        $service_name$.$route_field_name$,\n"
+          "        $InteractionModel$.$interaction_model$,\n"
+          "        $input_type$.parser(),\n"
+          "        $output_type$.parser(),\n"
+          "        $server_class_name$.class,\n"
+          "        $client_class_name$.class);\n");
+      // The request-channel route selfRegister installs for the batch methods
+      if (method.kind == rsocket_rpc_generator::REQUEST_RESPONSE) {
+        string batch_route_constant = "BATCH_" + route_constant;
+        routes.push_back(batch_route_constant);
+        (*vars)["route_constant"] = batch_route_constant;
+        (*vars)["batch_field_name"] = method.batch_field_name;
+        (*vars)["batch_route_field_name"] = method.batch_route_field_name;
+        (*vars)["interaction_model"] = InteractionModelName(rsocket_rpc_generator::REQUEST_CHANNEL);
+        p->Print(
+            *vars,
+            "public static final $RouteDescriptor$ $route_constant$ =\n"
+            "    new $RouteDescriptor$(\n"
+            "        $service_name$.SERVICE,\n"
+            "        $service_name$.$batch_field_name$,\n"
+            "        $service_name$.$batch_route_field_name$,\n"
+            "        $InteractionModel$.$interaction_model$,\n"
+            "        $input_type$.parser(),\n"
+            "        $output_type$.parser(),\n"
+            "        $server_class_name$.class,\n"
+            "        $client_class_name$.class);\n");
+      }
+    }
+  }
+
+  if (routes.empty()) {
+    p->Print(
+        *vars,
+        "\nprivate static final $List$<$RouteDescriptor$> ROUTES = $Collections$.emptyList();\n\n");
+  } else {
+    p->Print(
+        *vars,
+        "\nprivate static final $List$<$RouteDescriptor$> ROUTES =\n"
+        "    $Collections$.unmodifiableList($Arrays$.asList(\n");
+    for (size_t i = 0; i < routes.size(); ++i) {
+      (*vars)["route_constant"] = routes[i];
+      if (i + 1 < routes.size()) {
+        p->Print(*vars, "        $route_constant$,\n");
+      } else {
+        p->Print(*vars, "        $route_constant$));\n\n");
+      }
+    }
+  }
+
+  p->Print(
+      *vars,
+      "private final $Optional$<$MetadataDecoder$> metadataDecoder;\n"
+      "private final $Optional$<$MeterRegistry$> registry;\n"
+      "private final $Optional$<$Tracer$> tracer;\n"
+      "private final $List$<$SelfRegistrable$> servers = new $ArrayList$<>();\n\n"
+      "public $registry_class_name$() {\n"
+      "  this($Optional$.empty(), $Optional$.empty(), $Optional$.empty());\n"
+      "}\n\n"
+      "public $registry_class_name$($Optional$<$MetadataDecoder$> metadataDecoder, $Optional$<$MeterRegistry$> registry, $Optional$<$Tracer$> tracer) {\n"
+      "  this.metadataDecoder = metadataDecoder;\n"
+      "  this.registry = registry;\n"
+      "  this.tracer = tracer;\n"
+      "}\n");
+
+  // Typed registration of the service implementations
+  for (size_t s = 0; s < services.size(); ++s) {
+    const ServiceModel& service = *services[s];
+    (*vars)["service_name"] = service.name;
+    (*vars)["server_class_name"] = ServerClassName(service.descriptor);
+    p->Print(
+        *vars,
+        "\n"
+        "public $registry_class_name$ with$service_name$($service_name$ service) {\n"
+        "  servers.add(new $server_class_name$(service, metadataDecoder, registry, tracer));\n"
+        "  return this;\n"
+        "}\n");
+    if (blocking_api) {
+      p->Print(
+          *vars,
+          "\n"
+          "public $registry_class_name$ withBlocking$service_name$(Blocking$service_name$ service) {\n"
+          "  servers.add(new Blocking$server_class_name$(service, metadataDecoder, $Optional$.empty(), registry));\n"
+          "  return this;\n"
+          "}\n");
+    }
+  }
+
+  p->Print(
+      *vars,
+      "\n"
+      "@$Override$\n"
+      "public $List$<$RouteDescriptor$> routes() {\n"
+      "  return ROUTES;\n"
+      "}\n\n"
+      "@$Override$\n"
+      "public void selfRegister($MutableRouter$ router) {\n"
+      "  for ($SelfRegistrable$ server : servers) {\n"
+      "    server.selfRegister(router);\n"
+      "  }\n"
+      "}\n");
+
+  p->Outdent();
+  p->Print("}\n");
+}
+
+static void PrintBenchmark(const ServiceModel& service,
+                           Variables* vars,
+                           Printer* p,
+                           bool disable_version) {
+  (*vars)["service_name"] = service.name;
+  (*vars)["file_name"] = service.file_name;
+  (*vars)["client_class_name"] = ClientClassName(service.descriptor);
+  (*vars)["server_class_name"] = ServerClassName(service.descriptor);
+  (*vars)["benchmark_class_name"] = BenchmarkClassName(service.descriptor);
+  (*vars)["rsocket_rpc_version"] = "";
+  #ifdef rsocket_rpc_version
+  if (!disable_version) {
+    (*vars)["rsocket_rpc_version"] = " (version " XSTR(rsocket_rpc_version) ")";
+  }
+  #endif
+  p->Print(
+      *vars,
+      "/**\n"
+      " * JMH benchmark of every method of {@link $service_name$}, calling a no-op implementation\n"
+      " * through the generated client and server over the local transport. Run the {@code main}\n"
+      " * method, or JMH with {@code -prof gc}, to report the allocation rate per call.\n"
+      " */\n"
+      "@$Generated$(\n"
+      "    value = \"by RSocket RPC proto compiler$rsocket_rpc_version$\",\n"
+      "    comments = \"Source: $file_name$\")\n"
+      "@$State$($Scope$.Benchmark)\n"
+      "@$BenchmarkMode$($Mode$.Throughput)\n"
+      "@$OutputTimeUnit$($TimeUnit$.SECONDS)\n"
+      "@$Fork$(1)\n"
+      "@$Warmup$(iterations = 5, time = 1)\n"
+      "@$Measurement$(iterations = 5, time = 1)\n"
+      "public class $benchmark_class_name$ {\n");
+  p->Indent();
+
+  p->Print(
+      *vars,
+      "// Unknown field used to pad messages to the requested size, so that every\n"
+      "// message type can be sized without knowing its schema.\n"
+      "private static final int PADDING_FIELD_NUMBER = 536870911;\n\n"
+      "/** Serialized size of the padding added to every request and response, 0 sends default instances. */\n"
+      "@$Param$({\"0\", \"128\", \"4096\"})\n"
+      "public int payloadSize;\n\n"
+      "private $Closeable$ server;\n"
+      "private $RSocket$ rSocket;\n"
+      "private $client_class_name$ client;\n");
+
+  // Messages sent by each method
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    p->Print(
+        *vars,
+        "private $input_type$ $lower_method_name$Request;\n"
+        "private $output_type$ $lower_method_name$Response;\n");
+  }
+
+  p->Print(
+      *vars,
+      "\n"
+      "@$Setup$($Level$.Trial)\n"
+      "public void setup() throws $IOException$ {\n");
+  p->Indent();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    p->Print(
+        *vars,
+        "$lower_method_name$Request = pad($input_type$.getDefaultInstance(), $input_type$.parser());\n"
+        "$lower_method_name$Response = pad($output_type$.getDefaultInstance(), $output_type$.parser());\n");
+  }
+  p->Print(
+      *vars,
+      "\n"
+      "String name = \"$benchmark_class_name$-\" + $System$.identityHashCode(this);\n"
+      "$RequestHandlingRSocket$ handler =\n"
+      "    new $RequestHandlingRSocket$()\n"
+      "        .withEndpoint(\n"
+      "            new $server_class_name$(\n"
+      "                new NoopService(), $Optional$.empty(), $Optional$.empty(), $Optional$.empty()));\n"
+      "server =\n"
+      "    $RSocketServer$.create()\n"
+      "        .acceptor((setup, sendingSocket) -> $Mono$.just(handler))\n"
+      "        .bind($LocalServerTransport$.create(name))\n"
+      "        .block();\n"
+      "rSocket = $RSocketConnector$.connectWith($LocalClientTransport$.create(name)).block();\n"
+      "client = new $client_class_name$(rSocket);\n");
+  p->Outdent();
+  p->Print(
+      *vars,
+      "}\n\n"
+      "@$TearDown$($Level$.Trial)\n"
+      "public void tearDown() {\n"
+      "  rSocket.dispose();\n"
+      "  server.dispose();\n"
+      "}\n");
+
+  // One benchmark per method
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    p->Print(
+        *vars,
+        "\n"
+        "@$Benchmark$\n");
+    if (method.chunked) {
+      // Chunked messages are benchmarked with their header alone
+      (*vars)["request"] = method.chunked_request_field != NULL
+          ? (*vars)["Chunked"] + ".of(" + method.lower_name + "Request, " + (*vars)["Flux"] + ".empty())"
+          : method.lower_name + "Request";
+      if (method.chunked_response_field != NULL) {
+        p->Print(
+            *vars,
+            "public Object $lower_method_name$() {\n"
+            "  return client.$lower_method_name$($request$).flatMapMany($Chunked$::data).doOnNext($ByteBuf$::release).blockLast();\n"
+            "}\n");
+      } else {
+        p->Print(
+            *vars,
+            "public Object $lower_method_name$() {\n"
+            "  return client.$lower_method_name$($request$).block();\n"
+            "}\n");
+      }
+      continue;
+    }
+    switch (method.kind) {
+      case rsocket_rpc_generator::FIRE_AND_FORGET:
+        p->Print(
+            *vars,
+            "public void $lower_method_name$() {\n"
+            "  client.$lower_method_name$($lower_method_name$Request).block();\n"
+            "}\n");
+        break;
+      case rsocket_rpc_generator::REQUEST_RESPONSE:
+        p->Print(
+            *vars,
+            "public Object $lower_method_name$() {\n"
+            "  return client.$lower_method_name$($lower_method_name$Request).block();\n"
+            "}\n");
+        break;
+      case rsocket_rpc_generator::REQUEST_STREAM:
+        p->Print(
+            *vars,
+            "public Object $lower_method_name$() {\n"
+            "  return client.$lower_method_name$($lower_method_name$Request).blockLast();\n"
+            "}\n");
+        break;
+      case rsocket_rpc_generator::REQUEST_CHANNEL:
+        if (method.server_streaming) {
+          p->Print(
+              *vars,
+              "public Object $lower_method_name$() {\n"
+              "  return client.$lower_method_name$($Flux$.just($lower_method_name$Request)).blockLast();\n"
+              "}\n");
+        } else {
+          p->Print(
+              *vars,
+              "public Object $lower_method_name$() {\n"
+              "  return client.$lower_method_name$($Flux$.just($lower_method_name$Request)).block();\n"
+              "}\n");
+        }
+        break;
+    }
+  }
+
+  p->Print(
+      *vars,
+      "\n"
+      "private <T extends $MessageLite$> T pad(T defaultInstance, $Parser$<T> parser) throws $IOException$ {\n"
+      "  if (payloadSize == 0) {\n"
+      "    return defaultInstance;\n"
+      "  }\n"
+      "  int length = payloadSize - $CodedOutputStream$.computeTagSize(PADDING_FIELD_NUMBER)\n"
+      "      - $CodedOutputStream$.computeUInt32SizeNoTag(payloadSize);\n"
+      "  $ByteString$.Output out = $ByteString$.newOutput(payloadSize);\n"
+      "  $CodedOutputStream$ coded = $CodedOutputStream$.newInstance(out);\n"
+      "  coded.writeByteArray(PADDING_FIELD_NUMBER, new byte[$Math$.max(0, length)]);\n"
+      "  coded.flush();\n"
+      "  return parser.parseFrom(out.toByteString());\n"
+      "}\n\n"
+      "public static void main(String[] args) throws $RunnerException$ {\n"
+      "  new $Runner$(\n"
+      "          new $OptionsBuilder$()\n"
+      "              .include($benchmark_class_name$.class.getName())\n"
+      "              .addProfiler($GCProfiler$.class)\n"
+      "              .build())\n"
+      "      .run();\n"
+      "}\n\n"
+      "private class NoopService implements $service_name$ {\n");
+  p->Indent();
+  for (size_t i = 0; i < service.methods.size(); ++i) {
+    const MethodModel& method = service.methods[i];
+    (*vars)["lower_method_name"] = method.lower_name;
+    (*vars)["input_type"] = method.input_type;
+    (*vars)["output_type"] = method.output_type;
+    p->Print(
+        *vars,
+        "@$Override$\n");
+    if (method.chunked) {
+      (*vars)["response"] = method.chunked_response_field != NULL
+          ? (*vars)["Chunked"] + ".of(" + method.lower_name + "Response, " + (*vars)["Flux"] + ".empty())"
+          : method.lower_name + "Response";
+      p->Print("public ");
+      PrintChunkedSignature(method, vars, p, true);
+      p->Print(" {\n");
+      if (method.chunked_request_field != NULL) {
+        p->Print(*vars, "  return message.data().doOnNext($ByteBuf$::release).then($Mono$.just($response$));\n");
+      } else {
+        p->Print(*vars, "  return $Mono$.just($response$);\n");
+      }
+      p->Print("}\n");
+    } else {
+      switch (method.kind) {
+        case rsocket_rpc_generator::FIRE_AND_FORGET:
+          p->Print(
+              *vars,
+              "public $Mono$<Void> $lower_method_name$($input_type$ message, $ByteBuf$ metadata) {\n"
+              "  return $Mono$.empty();\n"
+              "}\n");
+          break;
+        case rsocket_rpc_generator::REQUEST_RESPONSE:
+          p->Print(
+              *vars,
+              "public $Mono$<$output_type$> $lower_method_name$($input_type$ message, $ByteBuf$ metadata) {\n"
+              "  return $Mono$.just($lower_method_name$Response);\n"
+              "}\n");
+          break;
+        case rsocket_rpc_generator::REQUEST_STREAM:
+          p->Print(
+              *vars,
+              "public $Flux$<$output_type$> $lower_method_name$($input_type$ message, $ByteBuf$ metadata) {\n"
+              "  return $Flux$.just($lower_method_name$Response);\n"
+              "}\n");
+          break;
+        case rsocket_rpc_generator::REQUEST_CHANNEL:
+          if (method.server_streaming) {
+            p->Print(
+                *vars,
+                "public $Flux$<$output_type$> $lower_method_name$($Publisher$<$input_type$> messages, $ByteBuf$ metadata) {\n"
+                "  return $Flux$.from(messages).map(message -> $lower_method_name$Response);\n"
+                "}\n");
+          } else {
+            p->Print(
+                *vars,
+                "public $Mono$<$output_type$> $lower_method_name$($Publisher$<$input_type$> messages, $ByteBuf$ metadata) {\n"
+                "  return $Flux$.from(messages).then($Mono$.just($lower_method_name$Response));\n"
+                "}\n");
+          }
+          break;
+      }
+    }
+    if (i + 1 < service.methods.size()) {
+      p->Print("\n");
+    }
+  }
+  p->Outdent();
+  p->Print("}\n");
+
+  p->Outdent();
+  p->Print("}\n");
+}
+
+bool GenerateInterface(const ServiceModel& service,
                        google::protobuf::io::ZeroCopyOutputStream* out,
                        ProtoFlavor flavor,
-                       bool disable_version) {
+                       bool disable_version,
+                       bool reuse_builders) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Flux"] = "reactor.core.publisher.Flux";
   vars["Mono"] = "reactor.core.publisher.Mono";
   vars["Publisher"] = "org.reactivestreams.Publisher";
   vars["Generated"] = "javax.annotation.Generated";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
+  vars["Chunked"] = "io.rsocket.ipc.chunked.Chunked";
 
   Printer printer(out, '$');
-  string package_name = ServiceJavaPackage(service->file());
+  const string& package_name = service.java_package;
   if (!package_name.empty()) {
     printer.Print(
         "package $package_name$;\n\n",
@@ -1958,20 +2676,19 @@ void GenerateInterface(const ServiceDescriptor* service,
   }
 
   // Package string is used to fully qualify method names.
-  vars["Package"] = service->file()->package();
-  if (!vars["Package"].empty()) {
-    vars["Package"].append(".");
-  }
-  PrintInterface(service, &vars, &printer, flavor, disable_version);
+  vars["Package"] = service.proto_package;
+  PrintInterface(service, &vars, &printer, flavor, disable_version, reuse_builders);
+  printer.Flush();
+  return !printer.failed();
 }
 
-void GenerateClient(const ServiceDescriptor* service,
+bool GenerateClient(const ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Flux"] = "reactor.core.publisher.Flux";
   vars["Mono"] = "reactor.core.publisher.Mono";
   vars["from"] = "from";
@@ -1987,6 +2704,7 @@ void GenerateClient(const ServiceDescriptor* service,
   vars["Payload"] = "io.rsocket.Payload";
   vars["ByteBufPayload"] = "io.rsocket.util.ByteBufPayload";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
   vars["ByteBufAllocator"] = "io.netty.buffer.ByteBufAllocator";
   vars["Unpooled"] = "io.netty.buffer.Unpooled";
   vars["ByteBuffer"] = "java.nio.ByteBuffer";
@@ -1994,22 +2712,25 @@ void GenerateClient(const ServiceDescriptor* service,
   vars["CodedOutputStream"] = "com.google.protobuf.CodedOutputStream";
   vars["RSocketRpcMetadata"] = "io.rsocket.ipc.frames.Metadata";
   vars["RSocketRpcMetrics"] = "io.rsocket.ipc.metrics.Metrics";
+  vars["LatencyRecorder"] = "io.rsocket.ipc.metrics.LatencyRecorder";
   vars["MeterRegistry"] = "io.micrometer.core.instrument.MeterRegistry";
   vars["MessageLite"] = "com.google.protobuf.MessageLite";
   vars["Parser"] = "com.google.protobuf.Parser";
   vars["RSocketRpcGeneratedMethod"] = "io.rsocket.rpc.annotations.internal.GeneratedMethod";
   vars["RSocketRpcTracing"] = "io.rsocket.ipc.tracing.Tracing";
-  vars["Tag"] = "io.rsocket.ipc.tracing.Tag";
   vars["Tracer"] = "io.opentracing.Tracer";
   vars["Map"] = "java.util.Map";
-  vars["HashMap"] = "java.util.HashMap";
   vars["Supplier"] = "java.util.function.Supplier";
   vars["MetadataEncoder"] = "io.rsocket.ipc.MetadataEncoder";
   vars["DefaultMetadataEncoder"] = "io.rsocket.ipc.encoders.DefaultMetadataEncoder";
-  vars["SimpleSpanContext"] = "io.rsocket.ipc.tracing.SimpleSpanContext";
+  vars["BinaryTraceContext"] = "io.rsocket.ipc.tracing.BinaryTraceContext";
+  vars["RetryAfterBackoff"] = "io.rsocket.ipc.admission.RetryAfterBackoff";
+  vars["Chunked"] = "io.rsocket.ipc.chunked.Chunked";
+  vars["Chunks"] = "io.rsocket.ipc.chunked.Chunks";
+  vars["Batches"] = "io.rsocket.ipc.batch.Batches";
 
   Printer printer(out, '$');
-  string package_name = ServiceJavaPackage(service->file());
+  const string& package_name = service.java_package;
   if (!package_name.empty()) {
     printer.Print(
         "package $package_name$;\n\n",
@@ -2017,20 +2738,20 @@ void GenerateClient(const ServiceDescriptor* service,
   }
 
   // Package string is used to fully qualify method names.
-  vars["Package"] = service->file()->package();
-  if (!vars["Package"].empty()) {
-    vars["Package"].append(".");
-  }
+  vars["Package"] = service.proto_package;
   PrintClient(service, &vars, &printer, flavor, disable_version);
+  printer.Flush();
+  return !printer.failed();
 }
 
-void GenerateServer(const ServiceDescriptor* service,
+bool GenerateServer(const ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
-                    bool disable_version) {
+                    bool disable_version,
+                    bool reuse_builders) {
   // All non-generated classes must be referred by fully qualified names to
   // avoid collision with generated classes.
-  std::map<string, string> vars;
+  Variables vars;
   vars["Flux"] = "reactor.core.publisher.Flux";
   vars["Mono"] = "reactor.core.publisher.Mono";
   vars["from"] = "from";
@@ -2049,8 +2770,10 @@ void GenerateServer(const ServiceDescriptor* service,
   vars["AbstractRSocketService"] = "io.rsocket.rpc.AbstractRSocketService";
   vars["RSocketRpcMetadata"] = "io.rsocket.ipc.frames.Metadata";
   vars["RSocketRpcMetrics"] = "io.rsocket.ipc.metrics.Metrics";
+  vars["LatencyRecorder"] = "io.rsocket.ipc.metrics.LatencyRecorder";
   vars["MeterRegistry"] = "io.micrometer.core.instrument.MeterRegistry";
   vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
   vars["ByteBuffer"] = "java.nio.ByteBuffer";
   vars["ByteBufAllocator"] = "io.netty.buffer.ByteBufAllocator";
   vars["CodedInputStream"] = "com.google.protobuf.CodedInputStream";
@@ -2062,8 +2785,6 @@ void GenerateServer(const ServiceDescriptor* service,
   vars["Named"] = "javax.inject.Named";
   vars["RSocketRpcResourceType"] = "io.rsocket.rpc.annotations.internal.ResourceType";
   vars["RSocketRpcTracing"] = "io.rsocket.ipc.tracing.Tracing";
-  vars["Tag"] = "io.rsocket.ipc.tracing.Tag";
-  vars["SpanContext"] = "io.opentracing.SpanContext";
   vars["Tracer"] = "io.opentracing.Tracer";
   vars["Map"] = "java.util.Map";
   vars["IPCFunction"] = "io.rsocket.ipc.util.IPCFunction";
@@ -2075,9 +2796,17 @@ void GenerateServer(const ServiceDescriptor* service,
   vars["MetadataDecoder"] = "io.rsocket.ipc.MetadataDecoder";
   vars["CompositeMetadataDecoder"] = "io.rsocket.ipc.decoders.CompositeMetadataDecoder";
   vars["MutableRouter"] = "io.rsocket.ipc.MutableRouter";
+  vars["CoDelAdmission"] = "io.rsocket.ipc.admission.CoDelAdmission";
+  vars["ParseOffload"] = "io.rsocket.ipc.offload.ParseOffload";
+  vars["ThreadPerCore"] = "io.rsocket.ipc.percore.ThreadPerCore";
+  vars["Unpooled"] = "io.netty.buffer.Unpooled";
+  vars["ThreadLocal"] = "java.lang.ThreadLocal";
+  vars["Chunked"] = "io.rsocket.ipc.chunked.Chunked";
+  vars["Chunks"] = "io.rsocket.ipc.chunked.Chunks";
+  vars["Batches"] = "io.rsocket.ipc.batch.Batches";
 
   Printer printer(out, '$');
-  string package_name = ServiceJavaPackage(service->file());
+  const string& package_name = service.java_package;
   if (!package_name.empty()) {
     printer.Print(
         "package $package_name$;\n\n",
@@ -2085,22 +2814,145 @@ void GenerateServer(const ServiceDescriptor* service,
   }
 
   // Package string is used to fully qualify method names.
-  vars["Package"] = service->file()->package();
-  if (!vars["Package"].empty()) {
-    vars["Package"].append(".");
+  vars["Package"] = service.proto_package;
+  PrintServer(service, &vars, &printer, flavor, disable_version, reuse_builders);
+  printer.Flush();
+  return !printer.failed();
+}
+
+bool GenerateInterface(const ServiceDescriptor* service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version,
+                       bool reuse_builders) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateInterface(model, out, flavor, disable_version, reuse_builders);
+}
+
+bool GenerateClient(const ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateClient(model, out, flavor, disable_version);
+}
+
+bool GenerateServer(const ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version,
+                    bool reuse_builders) {
+  ServiceModel model;
+  rsocket_rpc_generator::BuildServiceModel(service, &model);
+  return GenerateServer(model, out, flavor, disable_version, reuse_builders);
+}
+
+bool GenerateRegistry(const std::vector<const ServiceModel*>& services,
+                      google::protobuf::io::ZeroCopyOutputStream* out,
+                      ProtoFlavor flavor,
+                      bool disable_version,
+                      bool blocking_api) {
+  RSOCKET_RPC_CODEGEN_CHECK(!services.empty()) << "a registry needs at least one service";
+  const ServiceModel& first = *services[0];
+
+  // All non-generated classes must be referred by fully qualified names to
+  // avoid collision with generated classes.
+  Variables vars;
+  vars["Generated"] = "javax.annotation.Generated";
+  vars["Override"] = "java.lang.Override";
+  vars["List"] = "java.util.List";
+  vars["ArrayList"] = "java.util.ArrayList";
+  vars["Arrays"] = "java.util.Arrays";
+  vars["Collections"] = "java.util.Collections";
+  vars["Optional"] = "java.util.Optional";
+  vars["MetadataDecoder"] = "io.rsocket.ipc.MetadataDecoder";
+  vars["MeterRegistry"] = "io.micrometer.core.instrument.MeterRegistry";
+  vars["Tracer"] = "io.opentracing.Tracer";
+  vars["MutableRouter"] = "io.rsocket.ipc.MutableRouter";
+  vars["SelfRegistrable"] = "io.rsocket.ipc.SelfRegistrable";
+  vars["ServiceRegistry"] = "io.rsocket.rpc.registry.ServiceRegistry";
+  vars["RouteDescriptor"] = "io.rsocket.rpc.registry.RouteDescriptor";
+  vars["InteractionModel"] = "io.rsocket.rpc.registry.InteractionModel";
+  vars["file_name"] = first.file_name;
+  vars["registry_class_name"] = RegistryClassName(first.descriptor->file());
+
+  Printer printer(out, '$');
+  const string& package_name = first.java_package;
+  if (!package_name.empty()) {
+    printer.Print(
+        "package $package_name$;\n\n",
+        "package_name", package_name);
   }
-  PrintServer(service, &vars, &printer, flavor, disable_version);
+  PrintRegistry(services, &vars, &printer, disable_version, blocking_api);
+  printer.Flush();
+  return !printer.failed();
 }
 
-string ServiceJavaPackage(const FileDescriptor* file) {
-  string result = google::protobuf::compiler::java::ClassName(file);
-  size_t last_dot_pos = result.find_last_of('.');
-  if (last_dot_pos != string::npos) {
-    result.resize(last_dot_pos);
-  } else {
-    result = "";
+bool GenerateBenchmark(const ServiceModel& service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version) {
+  // All non-generated classes must be referred by fully qualified names to
+  // avoid collision with generated classes.
+  Variables vars;
+  vars["Flux"] = "reactor.core.publisher.Flux";
+  vars["Mono"] = "reactor.core.publisher.Mono";
+  vars["Override"] = "java.lang.Override";
+  vars["Publisher"] = "org.reactivestreams.Publisher";
+  vars["Generated"] = "javax.annotation.Generated";
+  vars["ByteBuf"] = "io.netty.buffer.ByteBuf";
+  vars["RouteIndex"] = "io.rsocket.ipc.routing.RouteIndex";
+  vars["Chunked"] = "io.rsocket.ipc.chunked.Chunked";
+  vars["System"] = "java.lang.System";
+  vars["Math"] = "java.lang.Math";
+  vars["IOException"] = "java.io.IOException";
+  vars["Optional"] = "java.util.Optional";
+  vars["TimeUnit"] = "java.util.concurrent.TimeUnit";
+  vars["ByteString"] = "com.google.protobuf.ByteString";
+  vars["CodedOutputStream"] = "com.google.protobuf.CodedOutputStream";
+  vars["MessageLite"] = "com.google.protobuf.MessageLite";
+  vars["Parser"] = "com.google.protobuf.Parser";
+  vars["Closeable"] = "io.rsocket.Closeable";
+  vars["RSocket"] = "io.rsocket.RSocket";
+  vars["RSocketServer"] = "io.rsocket.core.RSocketServer";
+  vars["RSocketConnector"] = "io.rsocket.core.RSocketConnector";
+  vars["LocalServerTransport"] = "io.rsocket.transport.local.LocalServerTransport";
+  vars["LocalClientTransport"] = "io.rsocket.transport.local.LocalClientTransport";
+  vars["RequestHandlingRSocket"] = "io.rsocket.ipc.RequestHandlingRSocket";
+  vars["Benchmark"] = "org.openjdk.jmh.annotations.Benchmark";
+  vars["BenchmarkMode"] = "org.openjdk.jmh.annotations.BenchmarkMode";
+  vars["Fork"] = "org.openjdk.jmh.annotations.Fork";
+  vars["Level"] = "org.openjdk.jmh.annotations.Level";
+  vars["Measurement"] = "org.openjdk.jmh.annotations.Measurement";
+  vars["Mode"] = "org.openjdk.jmh.annotations.Mode";
+  vars["OutputTimeUnit"] = "org.openjdk.jmh.annotations.OutputTimeUnit";
+  vars["Param"] = "org.openjdk.jmh.annotations.Param";
+  vars["Scope"] = "org.openjdk.jmh.annotations.Scope";
+  vars["Setup"] = "org.openjdk.jmh.annotations.Setup";
+  vars["State"] = "org.openjdk.jmh.annotations.State";
+  vars["TearDown"] = "org.openjdk.jmh.annotations.TearDown";
+  vars["Warmup"] = "org.openjdk.jmh.annotations.Warmup";
+  vars["GCProfiler"] = "org.openjdk.jmh.profile.GCProfiler";
+  vars["Runner"] = "org.openjdk.jmh.runner.Runner";
+  vars["RunnerException"] = "org.openjdk.jmh.runner.RunnerException";
+  vars["OptionsBuilder"] = "org.openjdk.jmh.runner.options.OptionsBuilder";
+
+  Printer printer(out, '$');
+  const string& package_name = service.java_package;
+  if (!package_name.empty()) {
+    printer.Print(
+        "package $package_name$;\n\n",
+        "package_name", package_name);
   }
-  return result;
+  PrintBenchmark(service, &vars, &printer, disable_version);
+  printer.Flush();
+  return !printer.failed();
+}
+
+string ServiceJavaPackage(const FileDescriptor* file) {
+  return rsocket_rpc_generator::JavaPackage(file);
 }
 
 string ClientClassName(const google::protobuf::ServiceDescriptor* service) {
@@ -2111,4 +2963,17 @@ string ServerClassName(const google::protobuf::ServiceDescriptor* service) {
   return service->name() + "Server";
 }
 
+string BenchmarkClassName(const google::protobuf::ServiceDescriptor* service) {
+  return service->name() + "Benchmark";
+}
+
+string RegistryClassName(const google::protobuf::FileDescriptor* file) {
+  string outer_class_name = google::protobuf::compiler::java::ClassName(file);
+  size_t last_dot_pos = outer_class_name.find_last_of('.');
+  if (last_dot_pos != string::npos) {
+    outer_class_name = outer_class_name.substr(last_dot_pos + 1);
+  }
+  return outer_class_name + "RSocketRpcRegistry";
+}
+
 }  // namespace java_rsocket_rpc_generator
@@ -4,10 +4,13 @@
 #include <stdlib.h>  // for abort()
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/descriptor.h>
 
+#include "service_model.h"
+
 class LogHelper {
   std::ostream* os;
 
@@ -48,24 +51,75 @@ string ClientClassName(const google::protobuf::ServiceDescriptor* service);
 // Returns the name of the client class for the given service.
 string ServerClassName(const google::protobuf::ServiceDescriptor* service);
 
+// Returns the name of the JMH benchmark class for the given service.
+string BenchmarkClassName(const google::protobuf::ServiceDescriptor* service);
+
+// Returns the name of the registry class generated for the given file.
+string RegistryClassName(const google::protobuf::FileDescriptor* file);
+
+// The Generate functions return false if the stream failed, in which case
+// the output is incomplete.
+
 // Writes the generated interface into the given ZeroCopyOutputStream
-void GenerateInterface(const google::protobuf::ServiceDescriptor* service,
+bool GenerateInterface(const google::protobuf::ServiceDescriptor* service,
                        google::protobuf::io::ZeroCopyOutputStream* out,
                        ProtoFlavor flavor,
-                       bool disable_version);
+                       bool disable_version,
+                       bool reuse_builders);
 
 // Writes the generated client into the given ZeroCopyOutputStream
-void GenerateClient(const google::protobuf::ServiceDescriptor* service,
+bool GenerateClient(const google::protobuf::ServiceDescriptor* service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version);
 
 // Writes the generated server into the given ZeroCopyOutputStream
-void GenerateServer(const google::protobuf::ServiceDescriptor* service,
+bool GenerateServer(const google::protobuf::ServiceDescriptor* service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version,
+                    bool reuse_builders);
+
+// Writes the generated interface of a prebuilt service model into the given
+// ZeroCopyOutputStream. With reuse_builders every method taking a single
+// request gets an overload accepting the request as a reused builder.
+bool GenerateInterface(const rsocket_rpc_generator::ServiceModel& service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version,
+                       bool reuse_builders);
+
+// Writes the generated client of a prebuilt service model into the given
+// ZeroCopyOutputStream
+bool GenerateClient(const rsocket_rpc_generator::ServiceModel& service,
                     google::protobuf::io::ZeroCopyOutputStream* out,
                     ProtoFlavor flavor,
                     bool disable_version);
 
+// Writes the generated server of a prebuilt service model into the given
+// ZeroCopyOutputStream. With reuse_builders single requests are parsed into
+// per-thread builders instead of new messages.
+bool GenerateServer(const rsocket_rpc_generator::ServiceModel& service,
+                    google::protobuf::io::ZeroCopyOutputStream* out,
+                    ProtoFlavor flavor,
+                    bool disable_version,
+                    bool reuse_builders);
+
+// Writes a JMH benchmark of every method of a prebuilt service model into
+// the given ZeroCopyOutputStream
+bool GenerateBenchmark(const rsocket_rpc_generator::ServiceModel& service,
+                       google::protobuf::io::ZeroCopyOutputStream* out,
+                       ProtoFlavor flavor,
+                       bool disable_version);
+
+// Writes a registry listing the routes of all given services, which must be
+// declared in the same file, into the given ZeroCopyOutputStream
+bool GenerateRegistry(const std::vector<const rsocket_rpc_generator::ServiceModel*>& services,
+                      google::protobuf::io::ZeroCopyOutputStream* out,
+                      ProtoFlavor flavor,
+                      bool disable_version,
+                      bool blocking_api);
+
 }  // namespace java_rsocket_rpc_generator
 
 #endif  // RSOCKET_RPC_COMPILER_JAVA_GENERATOR_H_
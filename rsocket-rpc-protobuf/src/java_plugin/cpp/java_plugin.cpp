@@ -2,10 +2,14 @@
 
 #include "java_generator.h"
 #include "blocking_java_generator.h"
+#include "generation_cache.h"
+#include "native_image_config.h"
 #include <google/protobuf/compiler/code_generator.h>
 #include <google/protobuf/compiler/plugin.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <iostream>
 
 static string JavaPackageToDir(const string& package_name) {
@@ -19,6 +23,83 @@ static string JavaPackageToDir(const string& package_name) {
   return package_dir;
 }
 
+// Removes the cache_dir option from the generator parameters and returns its
+// value. The remaining options are part of the cache key, the cache location
+// is not since it does not affect the generated code.
+static string ExtractCacheDir(std::vector<std::pair<string, string> >* options) {
+  string cache_dir;
+  for (size_t i = 0; i < options->size();) {
+    if ((*options)[i].first == "cache_dir") {
+      cache_dir = (*options)[i].second;
+      options->erase(options->begin() + i);
+    } else {
+      ++i;
+    }
+  }
+  return cache_dir;
+}
+
+// Service models of a file, built on first use and shared by the reactive and
+// blocking generators. Services served entirely from the generation cache are
+// never modeled.
+class ServiceModels {
+ public:
+  explicit ServiceModels(const google::protobuf::FileDescriptor* file)
+      : file_(file), models_(file->service_count()) {}
+
+  const rsocket_rpc_generator::ServiceModel& get(int index) {
+    if (!models_[index]) {
+      models_[index].reset(new rsocket_rpc_generator::ServiceModel());
+      rsocket_rpc_generator::BuildServiceModel(file_->service(index), models_[index].get());
+    }
+    return *models_[index];
+  }
+
+ private:
+  const google::protobuf::FileDescriptor* file_;
+  std::vector<std::unique_ptr<rsocket_rpc_generator::ServiceModel> > models_;
+};
+
+// Opens the given file and fills it either from the generation cache or by
+// running the generator, storing the result for the next run. Returns false
+// with a message in error if the file could not be written.
+template <typename GenerateFunction>
+static bool GenerateFile(google::protobuf::compiler::GeneratorContext* context,
+                         const rsocket_rpc_generator::GenerationCache& cache,
+                         const rsocket_rpc_generator::ContentHash& service_hash,
+                         const string& filename,
+                         GenerateFunction generate,
+                         string* error) {
+  std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> file(context->Open(filename));
+  if (!cache.enabled()) {
+    if (!generate(file.get())) {
+      *error = filename + ": failed to write the generated code.";
+      return false;
+    }
+    return true;
+  }
+
+  string content;
+  if (!cache.Lookup(service_hash, filename, &content)) {
+    {
+      google::protobuf::io::StringOutputStream out(&content);
+      if (!generate(&out)) {
+        *error = filename + ": failed to write the generated code.";
+        return false;
+      }
+    }
+    cache.Store(service_hash, filename, content);
+  }
+  google::protobuf::io::CodedOutputStream coded(file.get());
+  coded.WriteRaw(content.data(), static_cast<int>(content.size()));
+  coded.Trim();
+  if (coded.HadError()) {
+    *error = filename + ": failed to write the generated code.";
+    return false;
+  }
+  return true;
+}
+
 class JavaRSocketRpcGenerator : public google::protobuf::compiler::CodeGenerator {
  public:
   JavaRSocketRpcGenerator() {}
@@ -28,25 +109,48 @@ class JavaRSocketRpcGenerator : public google::protobuf::compiler::CodeGenerator
                         const string& parameter,
                         google::protobuf::compiler::GeneratorContext* context,
                         string* error) const {
-    return reactor(file, parameter, context, error) && blocking(file, parameter, context, error);
+    for (int i = 0; i < file->service_count(); ++i) {
+        if (!rsocket_rpc_generator::ValidateService(file->service(i), error)) {
+            return false;
+        }
+    }
+
+    ServiceModels models(file);
+    return reactor(file, parameter, &models, context, error) &&
+           blocking(file, parameter, &models, context, error) &&
+           native_image(file, parameter, &models, context, error);
   }
 
   virtual bool reactor(const google::protobuf::FileDescriptor* file,
                           const string& parameter,
+                          ServiceModels* models,
                           google::protobuf::compiler::GeneratorContext* context,
                           string* error) const {
     std::vector<std::pair<string, string> > options;
     google::protobuf::compiler::ParseGeneratorParameter(parameter, &options);
+    rsocket_rpc_generator::GenerationCache cache(ExtractCacheDir(&options));
 
     java_rsocket_rpc_generator::ProtoFlavor flavor =
      java_rsocket_rpc_generator::ProtoFlavor::NORMAL;
 
     bool disable_version = false;
+    bool generate_blocking_api = false;
+    bool generate_registry = false;
+    bool generate_benchmarks = false;
+    bool reuse_builders = false;
     for (size_t i = 0; i < options.size(); i++) {
         if (options[i].first == "lite") {
             flavor = java_rsocket_rpc_generator::ProtoFlavor::LITE;
         } else if (options[i].first == "noversion") {
             disable_version = true;
+        } else if (options[i].first == "generate-blocking-api") {
+            generate_blocking_api = true;
+        } else if (options[i].first == "generate-registry") {
+            generate_registry = true;
+        } else if (options[i].first == "generate-benchmarks") {
+            generate_benchmarks = true;
+        } else if (options[i].first == "reuse-builders") {
+            reuse_builders = true;
         }
     }
 
@@ -54,28 +158,70 @@ class JavaRSocketRpcGenerator : public google::protobuf::compiler::CodeGenerator
     string package_filename = JavaPackageToDir(package_name);
     for (int i = 0; i < file->service_count(); ++i) {
         const google::protobuf::ServiceDescriptor* service = file->service(i);
+        rsocket_rpc_generator::ContentHash service_hash =
+            cache.enabled() ? rsocket_rpc_generator::ServiceContentHash(service, options) : rsocket_rpc_generator::ContentHash();
 
         string interface_filename = package_filename + service->name() + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> interface_file(context->Open(interface_filename));
-        java_rsocket_rpc_generator::GenerateInterface(service, interface_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, interface_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return java_rsocket_rpc_generator::GenerateInterface(models->get(i), out, flavor, disable_version, reuse_builders);
+            }, error)) {
+          return false;
+        }
 
         string client_filename = package_filename + java_rsocket_rpc_generator::ClientClassName(service) + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> client_file(context->Open(client_filename));
-        java_rsocket_rpc_generator::GenerateClient(service, client_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, client_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return java_rsocket_rpc_generator::GenerateClient(models->get(i), out, flavor, disable_version);
+            }, error)) {
+          return false;
+        }
 
         string server_filename = package_filename + java_rsocket_rpc_generator::ServerClassName(service) + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> server_file(context->Open(server_filename));
-        java_rsocket_rpc_generator::GenerateServer(service, server_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, server_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return java_rsocket_rpc_generator::GenerateServer(models->get(i), out, flavor, disable_version, reuse_builders);
+            }, error)) {
+          return false;
+        }
+
+        if (generate_benchmarks) {
+            string benchmark_filename = package_filename + java_rsocket_rpc_generator::BenchmarkClassName(service) + ".java";
+            if (!GenerateFile(context, cache, service_hash, benchmark_filename,
+                [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+                  return java_rsocket_rpc_generator::GenerateBenchmark(models->get(i), out, flavor, disable_version);
+                }, error)) {
+              return false;
+            }
+        }
+    }
+
+    if (generate_registry && file->service_count() > 0) {
+        rsocket_rpc_generator::ContentHash file_hash =
+            cache.enabled() ? rsocket_rpc_generator::FileContentHash(file, options) : rsocket_rpc_generator::ContentHash();
+        string registry_filename = package_filename + java_rsocket_rpc_generator::RegistryClassName(file) + ".java";
+        if (!GenerateFile(context, cache, file_hash, registry_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              std::vector<const rsocket_rpc_generator::ServiceModel*> services;
+              for (int i = 0; i < file->service_count(); ++i) {
+                  services.push_back(&models->get(i));
+              }
+              return java_rsocket_rpc_generator::GenerateRegistry(services, out, flavor, disable_version, generate_blocking_api);
+            }, error)) {
+          return false;
+        }
     }
     return true;
   }
 
   virtual bool blocking(const google::protobuf::FileDescriptor* file,
                           const string& parameter,
+                          ServiceModels* models,
                           google::protobuf::compiler::GeneratorContext* context,
                           string* error) const {
     std::vector<std::pair<string, string> > options;
     google::protobuf::compiler::ParseGeneratorParameter(parameter, &options);
+    rsocket_rpc_generator::GenerationCache cache(ExtractCacheDir(&options));
 
     blocking_java_rsocket_rpc_generator::ProtoFlavor flavor =
     blocking_java_rsocket_rpc_generator::ProtoFlavor::NORMAL;
@@ -98,22 +244,95 @@ class JavaRSocketRpcGenerator : public google::protobuf::compiler::CodeGenerator
         return true;
     }
 
+    for (int i = 0; i < file->service_count(); ++i) {
+        const rsocket_rpc_generator::ServiceModel& model = models->get(i);
+        for (size_t j = 0; j < model.methods.size(); ++j) {
+            if (model.methods[j].chunked) {
+                *error = model.methods[j].descriptor->full_name() +
+                         ": chunked methods are not supported by the blocking API.";
+                return false;
+            }
+        }
+    }
+
     string package_name = blocking_java_rsocket_rpc_generator::ServiceJavaPackage(file);
     string package_filename = JavaPackageToDir(package_name);
     for (int i = 0; i < file->service_count(); ++i) {
         const google::protobuf::ServiceDescriptor* service = file->service(i);
+        rsocket_rpc_generator::ContentHash service_hash =
+            cache.enabled() ? rsocket_rpc_generator::ServiceContentHash(service, options) : rsocket_rpc_generator::ContentHash();
 
         string interface_filename = package_filename + "Blocking" + service->name() + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> interface_file(context->Open(interface_filename));
-        blocking_java_rsocket_rpc_generator::GenerateInterface(service, interface_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, interface_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return blocking_java_rsocket_rpc_generator::GenerateInterface(models->get(i), out, flavor, disable_version);
+            }, error)) {
+          return false;
+        }
 
         string client_filename = package_filename + "Blocking" + java_rsocket_rpc_generator::ClientClassName(service) + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> client_file(context->Open(client_filename));
-        blocking_java_rsocket_rpc_generator::GenerateClient(service, client_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, client_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return blocking_java_rsocket_rpc_generator::GenerateClient(models->get(i), out, flavor, disable_version);
+            }, error)) {
+          return false;
+        }
 
         string server_filename = package_filename + "Blocking" + java_rsocket_rpc_generator::ServerClassName(service) + ".java";
-        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> server_file(context->Open(server_filename));
-        blocking_java_rsocket_rpc_generator::GenerateServer(service, server_file.get(), flavor, disable_version);
+        if (!GenerateFile(context, cache, service_hash, server_filename,
+            [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+              return blocking_java_rsocket_rpc_generator::GenerateServer(models->get(i), out, flavor, disable_version);
+            }, error)) {
+          return false;
+        }
+    }
+    return true;
+  }
+
+  virtual bool native_image(const google::protobuf::FileDescriptor* file,
+                          const string& parameter,
+                          ServiceModels* models,
+                          google::protobuf::compiler::GeneratorContext* context,
+                          string* error) const {
+    std::vector<std::pair<string, string> > options;
+    google::protobuf::compiler::ParseGeneratorParameter(parameter, &options);
+    rsocket_rpc_generator::GenerationCache cache(ExtractCacheDir(&options));
+
+    rsocket_rpc_generator::GeneratedClasses generated;
+    bool generate_native_image_config = false;
+    for (size_t i = 0; i < options.size(); i++) {
+        const string& option = options[i].first;
+        if (option == "generate-blocking-api") {
+            generated.blocking_api = true;
+        } else if (option == "generate-registry") {
+            generated.registry = true;
+        } else if (option == "generate-native-image-config") {
+            generate_native_image_config = true;
+        }
+    }
+
+    if (!generate_native_image_config || file->service_count() == 0) {
+        return true;
+    }
+
+    rsocket_rpc_generator::ContentHash file_hash =
+        cache.enabled() ? rsocket_rpc_generator::FileContentHash(file, options) : rsocket_rpc_generator::ContentHash();
+    string config_dir = rsocket_rpc_generator::NativeImageConfigDir(file);
+    if (!GenerateFile(context, cache, file_hash, config_dir + "reflect-config.json",
+        [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+          std::vector<const rsocket_rpc_generator::ServiceModel*> services;
+          for (int i = 0; i < file->service_count(); ++i) {
+              services.push_back(&models->get(i));
+          }
+          return rsocket_rpc_generator::GenerateReflectConfig(services, generated, out);
+        }, error)) {
+      return false;
+    }
+    if (!GenerateFile(context, cache, file_hash, config_dir + "resource-config.json",
+        [&](google::protobuf::io::ZeroCopyOutputStream* out) {
+          return rsocket_rpc_generator::GenerateResourceConfig(file, out);
+        }, error)) {
+      return false;
     }
     return true;
   }
@@ -122,5 +341,13 @@ class JavaRSocketRpcGenerator : public google::protobuf::compiler::CodeGenerator
 
 int main(int argc, char* argv[]) {
   JavaRSocketRpcGenerator generator;
-  return google::protobuf::compiler::PluginMain(argc, argv, &generator);
+  int result = google::protobuf::compiler::PluginMain(argc, argv, &generator);
+
+  int hits = rsocket_rpc_generator::GenerationCache::hits();
+  int misses = rsocket_rpc_generator::GenerationCache::misses();
+  if (hits + misses > 0) {
+    std::cerr << "rsocket-rpc generation cache: " << hits << " hits, "
+              << misses << " misses" << std::endl;
+  }
+  return result;
 }
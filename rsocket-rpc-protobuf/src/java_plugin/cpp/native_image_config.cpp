@@ -0,0 +1,198 @@
+#include "native_image_config.h"
+#include "java_generator.h"
+#include "template_printer.h"
+
+#include <map>
+#include <google/protobuf/compiler/java/java_names.h>
+#include <google/protobuf/descriptor.pb.h>
+
+namespace rsocket_rpc_generator {
+
+using google::protobuf::Descriptor;
+using google::protobuf::EnumDescriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::FileDescriptor;
+
+namespace {
+
+// Reflective access needed by a class: generated servers are instantiated
+// through their @Inject constructor, clients and interfaces are inspected for
+// their annotations and constants, and the protobuf runtime reads the fields
+// of messages and builders.
+enum Access {
+  ANNOTATION, GENERATED_CLASS, PROTOBUF_CLASS
+};
+
+// Classes ordered by binary name, so the output does not depend on the order
+// in which they are discovered.
+typedef std::map<std::string, Access> ClassSet;
+
+// Returns the binary name of the outer class enclosing top level types of
+// the file, or an empty string if they are generated as separate files.
+std::string OuterClassPrefix(const FileDescriptor* file) {
+  if (file->options().java_multiple_files()) {
+    return "";
+  }
+  return google::protobuf::compiler::java::ClassName(file) + "$";
+}
+
+void AddEnum(ClassSet* classes, const EnumDescriptor* enum_type) {
+  (*classes)[BinaryClassName(enum_type)] = PROTOBUF_CLASS;
+}
+
+void AddMessage(ClassSet* classes, const Descriptor* message);
+
+void AddFieldType(ClassSet* classes, const FieldDescriptor* field) {
+  if (field->message_type() != NULL) {
+    // protobuf-java generates no class for the synthetic entry message of a
+    // map field, only the type of its values can be a generated class
+    if (field->message_type()->options().map_entry()) {
+      AddFieldType(classes, field->message_type()->FindFieldByNumber(2));
+    } else {
+      AddMessage(classes, field->message_type());
+    }
+  } else if (field->enum_type() != NULL) {
+    AddEnum(classes, field->enum_type());
+  }
+}
+
+void AddMessage(ClassSet* classes, const Descriptor* message) {
+  std::string name = BinaryClassName(message);
+  if (!classes->insert(std::make_pair(name, PROTOBUF_CLASS)).second) {
+    return;
+  }
+  (*classes)[name + "$Builder"] = PROTOBUF_CLASS;
+  for (int i = 0; i < message->field_count(); ++i) {
+    AddFieldType(classes, message->field(i));
+  }
+}
+
+void AddGeneratedClass(ClassSet* classes, const std::string& package,
+                       const std::string& simple_name) {
+  (*classes)[package.empty() ? simple_name : package + "." + simple_name] = GENERATED_CLASS;
+}
+
+}  // namespace
+
+std::string NativeImageConfigDir(const FileDescriptor* file) {
+  std::string outer_class_name = google::protobuf::compiler::java::ClassName(file);
+  size_t last_dot_pos = outer_class_name.find_last_of('.');
+  if (last_dot_pos != std::string::npos) {
+    outer_class_name = outer_class_name.substr(last_dot_pos + 1);
+  }
+  std::string package = JavaPackage(file);
+  if (package.empty()) {
+    package = "default";
+  }
+  return "META-INF/native-image/" + package + "/" + outer_class_name + "/";
+}
+
+std::string BinaryClassName(const Descriptor* message) {
+  if (message->containing_type() != NULL) {
+    return BinaryClassName(message->containing_type()) + "$" + message->name();
+  }
+  std::string prefix = OuterClassPrefix(message->file());
+  if (prefix.empty()) {
+    return google::protobuf::compiler::java::ClassName(message);
+  }
+  return prefix + message->name();
+}
+
+std::string BinaryClassName(const EnumDescriptor* enum_type) {
+  if (enum_type->containing_type() != NULL) {
+    return BinaryClassName(enum_type->containing_type()) + "$" + enum_type->name();
+  }
+  std::string prefix = OuterClassPrefix(enum_type->file());
+  if (prefix.empty()) {
+    return google::protobuf::compiler::java::ClassName(enum_type);
+  }
+  return prefix + enum_type->name();
+}
+
+bool GenerateReflectConfig(const std::vector<const ServiceModel*>& services,
+                           const GeneratedClasses& generated,
+                           google::protobuf::io::ZeroCopyOutputStream* out) {
+  ClassSet classes;
+  classes["io.rsocket.rpc.annotations.internal.Generated"] = ANNOTATION;
+  classes["io.rsocket.rpc.annotations.internal.GeneratedMethod"] = ANNOTATION;
+  classes["io.rsocket.rpc.annotations.internal.ResourceType"] = ANNOTATION;
+
+  for (size_t s = 0; s < services.size(); ++s) {
+    const ServiceModel& service = *services[s];
+    const std::string& package = service.java_package;
+    std::string client = java_rsocket_rpc_generator::ClientClassName(service.descriptor);
+    std::string server = java_rsocket_rpc_generator::ServerClassName(service.descriptor);
+    AddGeneratedClass(&classes, package, service.name);
+    AddGeneratedClass(&classes, package, client);
+    AddGeneratedClass(&classes, package, server);
+    if (generated.blocking_api) {
+      AddGeneratedClass(&classes, package, "Blocking" + service.name);
+      AddGeneratedClass(&classes, package, "Blocking" + client);
+      AddGeneratedClass(&classes, package, "Blocking" + server);
+    }
+    for (size_t i = 0; i < service.methods.size(); ++i) {
+      AddMessage(&classes, service.methods[i].descriptor->input_type());
+      AddMessage(&classes, service.methods[i].descriptor->output_type());
+    }
+  }
+  if (generated.registry && !services.empty()) {
+    AddGeneratedClass(&classes, services[0]->java_package,
+                      java_rsocket_rpc_generator::RegistryClassName(services[0]->descriptor->file()));
+  }
+
+  Printer printer(out, '$');
+  printer.Print("[\n");
+  printer.Indent();
+  for (ClassSet::const_iterator it = classes.begin(); it != classes.end(); ++it) {
+    printer.Print("{\n");
+    printer.Indent();
+    printer.Print("\"name\": \"$name$\",\n", "name", it->first);
+    switch (it->second) {
+      case ANNOTATION:
+        printer.Print("\"allPublicMethods\": true\n");
+        break;
+      case GENERATED_CLASS:
+        printer.Print(
+            "\"allDeclaredConstructors\": true,\n"
+            "\"allPublicMethods\": true,\n"
+            "\"allPublicFields\": true\n");
+        break;
+      case PROTOBUF_CLASS:
+        printer.Print(
+            "\"allDeclaredConstructors\": true,\n"
+            "\"allPublicMethods\": true,\n"
+            "\"allDeclaredFields\": true\n");
+        break;
+    }
+    printer.Outdent();
+    ClassSet::const_iterator next = it;
+    ++next;
+    if (next == classes.end()) {
+      printer.Print("}\n");
+    } else {
+      printer.Print("},\n");
+    }
+  }
+  printer.Outdent();
+  printer.Print("]\n");
+  printer.Flush();
+  return !printer.failed();
+}
+
+bool GenerateResourceConfig(const FileDescriptor* file,
+                            google::protobuf::io::ZeroCopyOutputStream* out) {
+  Printer printer(out, '$');
+  printer.Print(
+      "{\n"
+      "  \"resources\": [\n"
+      "    {\n"
+      "      \"pattern\": \"\\\\Q$file_name$\\\\E\"\n"
+      "    }\n"
+      "  ]\n"
+      "}\n",
+      "file_name", file->name());
+  printer.Flush();
+  return !printer.failed();
+}
+
+}  // namespace rsocket_rpc_generator
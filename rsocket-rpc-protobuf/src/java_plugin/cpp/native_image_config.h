@@ -0,0 +1,49 @@
+#ifndef RSOCKET_RPC_COMPILER_NATIVE_IMAGE_CONFIG_H_
+#define RSOCKET_RPC_COMPILER_NATIVE_IMAGE_CONFIG_H_
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include "service_model.h"
+
+namespace rsocket_rpc_generator {
+
+// Which of the generated classes exist for a file, they depend on the plugin
+// options.
+struct GeneratedClasses {
+  GeneratedClasses() : blocking_api(false), registry(false) {}
+
+  bool blocking_api;
+  bool registry;
+};
+
+// Returns the directory below which the native-image configuration of the
+// given file is written, e.g.
+// "META-INF/native-image/io.rsocket.rpc.testing.protobuf/Sample/".
+std::string NativeImageConfigDir(const google::protobuf::FileDescriptor* file);
+
+// Returns the binary name of the Java class generated for the given message
+// or enum, as used by Class.forName, e.g. "com.example.Outer$Nested".
+std::string BinaryClassName(const google::protobuf::Descriptor* message);
+std::string BinaryClassName(const google::protobuf::EnumDescriptor* enum_type);
+
+// Both Generate functions return false if the stream failed.
+
+// Writes the GraalVM reflect-config.json listing the generated classes of the
+// given services, the annotations they are discovered by, and every message
+// and enum class reachable from the request and response types.
+bool GenerateReflectConfig(const std::vector<const ServiceModel*>& services,
+                           const GeneratedClasses& generated,
+                           google::protobuf::io::ZeroCopyOutputStream* out);
+
+// Writes the GraalVM resource-config.json including the proto source of the
+// given file, which the protobuf gradle plugin packages next to the classes.
+bool GenerateResourceConfig(const google::protobuf::FileDescriptor* file,
+                            google::protobuf::io::ZeroCopyOutputStream* out);
+
+}  // namespace rsocket_rpc_generator
+
+#endif  // RSOCKET_RPC_COMPILER_NATIVE_IMAGE_CONFIG_H_
@@ -61,6 +61,7 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_PROTOBUF_ATTRIBUT
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::io::rsocket::rpc::RSocketMethodOptions, fire_and_forget_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::io::rsocket::rpc::RSocketMethodOptions, chunked_field_),
 };
 static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, sizeof(::io::rsocket::rpc::RSocketMethodOptions)},
@@ -92,15 +93,15 @@ void AddDescriptorsImpl() {
   InitDefaults();
   static const char descriptor[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
       "\n\025rsocket/options.proto\022\016io.rsocket.rpc\032"
-      " google/protobuf/descriptor.proto\"/\n\024RSo"
+      " google/protobuf/descriptor.proto\"F\n\024RSo"
       "cketMethodOptions\022\027\n\017fire_and_forget\030\001 \001"
-      "(\010:V\n\007options\022\036.google.protobuf.MethodOp"
-      "tions\030\241\010 \001(\0132$.io.rsocket.rpc.RSocketMet"
-      "hodOptionsB\"\n\016io.rsocket.rpcB\016RSocketOpt"
-      "ionsP\001b\006proto3"
+      "(\010\022\025\n\rchunked_field\030\002 \001(\t:V\n\007options\022\036.g"
+      "oogle.protobuf.MethodOptions\030\241\010 \001(\0132$.io"
+      ".rsocket.rpc.RSocketMethodOptionsB\"\n\016io."
+      "rsocket.rpcB\016RSocketOptionsP\001b\006proto3"
   };
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 254);
+      descriptor, 277);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "rsocket/options.proto", &protobuf_RegisterTypes);
   ::protobuf_google_2fprotobuf_2fdescriptor_2eproto::AddDescriptors();
@@ -127,6 +128,7 @@ void RSocketMethodOptions::InitAsDefaultInstance() {
 }
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
 const int RSocketMethodOptions::kFireAndForgetFieldNumber;
+const int RSocketMethodOptions::kChunkedFieldFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
 
 RSocketMethodOptions::RSocketMethodOptions()
@@ -140,11 +142,16 @@ RSocketMethodOptions::RSocketMethodOptions(const RSocketMethodOptions& from)
   : ::google::protobuf::Message(),
       _internal_metadata_(NULL) {
   _internal_metadata_.MergeFrom(from._internal_metadata_);
+  chunked_field_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  if (from.chunked_field().size() > 0) {
+    chunked_field_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.chunked_field_);
+  }
   fire_and_forget_ = from.fire_and_forget_;
   // @@protoc_insertion_point(copy_constructor:io.rsocket.rpc.RSocketMethodOptions)
 }
 
 void RSocketMethodOptions::SharedCtor() {
+  chunked_field_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   fire_and_forget_ = false;
 }
 
@@ -154,6 +161,7 @@ RSocketMethodOptions::~RSocketMethodOptions() {
 }
 
 void RSocketMethodOptions::SharedDtor() {
+  chunked_field_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
 }
 
 void RSocketMethodOptions::SetCachedSize(int size) const {
@@ -176,6 +184,7 @@ void RSocketMethodOptions::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  chunked_field_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   fire_and_forget_ = false;
   _internal_metadata_.Clear();
 }
@@ -204,6 +213,22 @@ bool RSocketMethodOptions::MergePartialFromCodedStream(
         break;
       }
 
+      // string chunked_field = 2;
+      case 2: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
+                input, this->mutable_chunked_field()));
+          DO_(::google::protobuf::internal::WireFormatLite::VerifyUtf8String(
+            this->chunked_field().data(), static_cast<int>(this->chunked_field().length()),
+            ::google::protobuf::internal::WireFormatLite::PARSE,
+            "io.rsocket.rpc.RSocketMethodOptions.chunked_field"));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0) {
@@ -235,6 +260,16 @@ void RSocketMethodOptions::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(1, this->fire_and_forget(), output);
   }
 
+  // string chunked_field = 2;
+  if (this->chunked_field().size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::VerifyUtf8String(
+      this->chunked_field().data(), static_cast<int>(this->chunked_field().length()),
+      ::google::protobuf::internal::WireFormatLite::SERIALIZE,
+      "io.rsocket.rpc.RSocketMethodOptions.chunked_field");
+    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
+      2, this->chunked_field(), output);
+  }
+
   if ((_internal_metadata_.have_unknown_fields() &&  ::google::protobuf::internal::GetProto3PreserveUnknownsDefault())) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()), output);
@@ -254,6 +289,17 @@ void RSocketMethodOptions::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(1, this->fire_and_forget(), target);
   }
 
+  // string chunked_field = 2;
+  if (this->chunked_field().size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::VerifyUtf8String(
+      this->chunked_field().data(), static_cast<int>(this->chunked_field().length()),
+      ::google::protobuf::internal::WireFormatLite::SERIALIZE,
+      "io.rsocket.rpc.RSocketMethodOptions.chunked_field");
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+        2, this->chunked_field(), target);
+  }
+
   if ((_internal_metadata_.have_unknown_fields() &&  ::google::protobuf::internal::GetProto3PreserveUnknownsDefault())) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()), target);
@@ -271,6 +317,13 @@ size_t RSocketMethodOptions::ByteSizeLong() const {
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
         (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()));
   }
+  // string chunked_field = 2;
+  if (this->chunked_field().size() > 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->chunked_field());
+  }
+
   // bool fire_and_forget = 1;
   if (this->fire_and_forget() != 0) {
     total_size += 1 + 1;
@@ -303,6 +356,10 @@ void RSocketMethodOptions::MergeFrom(const RSocketMethodOptions& from) {
   ::google::protobuf::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
+  if (from.chunked_field().size() > 0) {
+
+    chunked_field_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.chunked_field_);
+  }
   if (from.fire_and_forget() != 0) {
     set_fire_and_forget(from.fire_and_forget());
   }
@@ -332,6 +389,8 @@ void RSocketMethodOptions::Swap(RSocketMethodOptions* other) {
 }
 void RSocketMethodOptions::InternalSwap(RSocketMethodOptions* other) {
   using std::swap;
+  chunked_field_.Swap(&other->chunked_field_, &::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+    GetArenaNoVirtual());
   swap(fire_and_forget_, other->fire_and_forget_);
   _internal_metadata_.Swap(&other->_internal_metadata_);
 }
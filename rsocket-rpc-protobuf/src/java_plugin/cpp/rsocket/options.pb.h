@@ -142,6 +142,20 @@ class RSocketMethodOptions : public ::google::protobuf::Message /* @@protoc_inse
 
   // accessors -------------------------------------------------------
 
+  // string chunked_field = 2;
+  void clear_chunked_field();
+  static const int kChunkedFieldFieldNumber = 2;
+  const ::std::string& chunked_field() const;
+  void set_chunked_field(const ::std::string& value);
+  #if LANG_CXX11
+  void set_chunked_field(::std::string&& value);
+  #endif
+  void set_chunked_field(const char* value);
+  void set_chunked_field(const char* value, size_t size);
+  ::std::string* mutable_chunked_field();
+  ::std::string* release_chunked_field();
+  void set_allocated_chunked_field(::std::string* chunked_field);
+
   // bool fire_and_forget = 1;
   void clear_fire_and_forget();
   static const int kFireAndForgetFieldNumber = 1;
@@ -152,6 +166,7 @@ class RSocketMethodOptions : public ::google::protobuf::Message /* @@protoc_inse
  private:
 
   ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::ArenaStringPtr chunked_field_;
   bool fire_and_forget_;
   mutable ::google::protobuf::internal::CachedSize _cached_size_;
   friend struct ::protobuf_rsocket_2foptions_2eproto::TableStruct;
@@ -185,6 +200,59 @@ inline void RSocketMethodOptions::set_fire_and_forget(bool value) {
   // @@protoc_insertion_point(field_set:io.rsocket.rpc.RSocketMethodOptions.fire_and_forget)
 }
 
+// string chunked_field = 2;
+inline void RSocketMethodOptions::clear_chunked_field() {
+  chunked_field_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline const ::std::string& RSocketMethodOptions::chunked_field() const {
+  // @@protoc_insertion_point(field_get:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+  return chunked_field_.GetNoArena();
+}
+inline void RSocketMethodOptions::set_chunked_field(const ::std::string& value) {
+  
+  chunked_field_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+}
+#if LANG_CXX11
+inline void RSocketMethodOptions::set_chunked_field(::std::string&& value) {
+  
+  chunked_field_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+}
+#endif
+inline void RSocketMethodOptions::set_chunked_field(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  
+  chunked_field_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+}
+inline void RSocketMethodOptions::set_chunked_field(const char* value, size_t size) {
+  
+  chunked_field_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+}
+inline ::std::string* RSocketMethodOptions::mutable_chunked_field() {
+  
+  // @@protoc_insertion_point(field_mutable:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+  return chunked_field_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline ::std::string* RSocketMethodOptions::release_chunked_field() {
+  // @@protoc_insertion_point(field_release:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+  
+  return chunked_field_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline void RSocketMethodOptions::set_allocated_chunked_field(::std::string* chunked_field) {
+  if (chunked_field != NULL) {
+    
+  } else {
+    
+  }
+  chunked_field_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), chunked_field);
+  // @@protoc_insertion_point(field_set_allocated:io.rsocket.rpc.RSocketMethodOptions.chunked_field)
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -0,0 +1,321 @@
+#include "service_model.h"
+#include "rsocket/options.pb.h"
+
+#include <ctype.h>
+#include <iterator>
+#include <google/protobuf/compiler/java/java_names.h>
+#include <google/protobuf/descriptor.pb.h>
+
+namespace rsocket_rpc_generator {
+
+using std::string;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::FileDescriptor;
+using google::protobuf::ServiceDescriptor;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::SourceLocation;
+using io::rsocket::rpc::RSocketMethodOptions;
+
+string MixedLower(const string& word) {
+  string w;
+  w += tolower(word[0]);
+  bool after_underscore = false;
+  for (size_t i = 1; i < word.length(); ++i) {
+    if (word[i] == '_') {
+      after_underscore = true;
+    } else {
+      w += after_underscore ? toupper(word[i]) : word[i];
+      after_underscore = false;
+    }
+  }
+  return w;
+}
+
+// Capitalizes the field name the way protoc does for the Java accessors.
+static string CapitalizedFieldName(const string& name) {
+  string w;
+  bool capitalize = true;
+  for (size_t i = 0; i < name.length(); ++i) {
+    if (islower(name[i])) {
+      w += capitalize ? toupper(name[i]) : name[i];
+      capitalize = false;
+    } else if (isupper(name[i])) {
+      w += name[i];
+      capitalize = false;
+    } else if (isdigit(name[i])) {
+      w += name[i];
+      capitalize = true;
+    } else {
+      capitalize = true;
+    }
+  }
+  return w;
+}
+
+string ToAllUpperCase(const string& word) {
+  string w;
+  for (size_t i = 0; i < word.length(); ++i) {
+    w += toupper(word[i]);
+    if ((i < word.length() - 1) && islower(word[i]) && isupper(word[i + 1])) {
+      w += '_';
+    }
+  }
+  return w;
+}
+
+template <typename ITR>
+static void SplitStringToIteratorUsing(const string& full,
+                                       const char* delim,
+                                       ITR& result) {
+  // Optimize the common case where delim is a single character.
+  if (delim[0] != '\0' && delim[1] == '\0') {
+    char c = delim[0];
+    const char* p = full.data();
+    const char* end = p + full.size();
+    while (p != end) {
+      if (*p == c) {
+        ++p;
+      } else {
+        const char* start = p;
+        while (++p != end && *p != c);
+        *result++ = string(start, p - start);
+      }
+    }
+    return;
+  }
+
+  string::size_type begin_index, end_index;
+  begin_index = full.find_first_not_of(delim);
+  while (begin_index != string::npos) {
+    end_index = full.find_first_of(delim, begin_index);
+    if (end_index == string::npos) {
+      *result++ = full.substr(begin_index);
+      return;
+    }
+    *result++ = full.substr(begin_index, (end_index - begin_index));
+    begin_index = full.find_first_not_of(delim, end_index);
+  }
+}
+
+static void SplitStringUsing(const string& full,
+                             const char* delim,
+                             std::vector<string>* result) {
+  std::back_insert_iterator< std::vector<string> > it(*result);
+  SplitStringToIteratorUsing(full, delim, it);
+}
+
+std::vector<string> Split(const string& full, const char* delim) {
+  std::vector<string> result;
+  SplitStringUsing(full, delim, &result);
+  return result;
+}
+
+string EscapeJavadoc(const string& input) {
+  string result;
+  result.reserve(input.size() * 2);
+
+  char prev = '*';
+
+  for (string::size_type i = 0; i < input.size(); i++) {
+    char c = input[i];
+    switch (c) {
+      case '*':
+        // Avoid "/*".
+        if (prev == '/') {
+          result.append("&#42;");
+        } else {
+          result.push_back(c);
+        }
+        break;
+      case '/':
+        // Avoid "*/".
+        if (prev == '*') {
+          result.append("&#47;");
+        } else {
+          result.push_back(c);
+        }
+        break;
+      case '@':
+        // '@' starts javadoc tags including the @deprecated tag, which will
+        // cause a compile-time error if inserted before a declaration that
+        // does not have a corresponding @Deprecated annotation.
+        result.append("&#64;");
+        break;
+      case '<':
+        // Avoid interpretation as HTML.
+        result.append("&lt;");
+        break;
+      case '>':
+        // Avoid interpretation as HTML.
+        result.append("&gt;");
+        break;
+      case '&':
+        // Avoid interpretation as HTML.
+        result.append("&amp;");
+        break;
+      case '\\':
+        // Java interprets Unicode escape sequences anywhere!
+        result.append("&#92;");
+        break;
+      default:
+        result.push_back(c);
+        break;
+    }
+
+    prev = c;
+  }
+
+  return result;
+}
+
+template <typename DescriptorType>
+static string GetCommentsForDescriptor(const DescriptorType* descriptor) {
+  SourceLocation location;
+  if (descriptor->GetSourceLocation(&location)) {
+    return location.leading_comments.empty() ?
+      location.trailing_comments : location.leading_comments;
+  }
+  return string();
+}
+
+std::vector<string> GetDocLines(const string& comments) {
+  if (!comments.empty()) {
+    // Ideally we should parse the comment text as Markdown and
+    // write it back as HTML, but this requires a Markdown parser.  For now
+    // we just use <pre> to get fixed-width text formatting.
+
+    // If the comment itself contains block comment start or end markers,
+    // HTML-escape them so that they don't accidentally close the doc comment.
+    string escapedComments = EscapeJavadoc(comments);
+
+    std::vector<string> lines = Split(escapedComments, "\n");
+    while (!lines.empty() && lines.back().empty()) {
+      lines.pop_back();
+    }
+    return lines;
+  }
+  return std::vector<string>();
+}
+
+template <typename DescriptorType>
+static std::vector<string> GetDocLinesForDescriptor(const DescriptorType* descriptor) {
+  return GetDocLines(GetCommentsForDescriptor(descriptor));
+}
+
+// Returns the singular bytes field with the given name, or NULL.
+static const FieldDescriptor* FindBytesField(const google::protobuf::Descriptor* message,
+                                             const string& name) {
+  if (name.empty()) {
+    return NULL;
+  }
+  const FieldDescriptor* field = message->FindFieldByName(name);
+  if (field == NULL || field->type() != FieldDescriptor::TYPE_BYTES || field->is_repeated()) {
+    return NULL;
+  }
+  return field;
+}
+
+static void BuildMethodModel(const MethodDescriptor* method, MethodModel* model) {
+  const RSocketMethodOptions& options = method->options().GetExtension(io::rsocket::rpc::options);
+  string upper_name = ToAllUpperCase(method->name());
+
+  model->descriptor = method;
+  model->name = method->name();
+  model->lower_name = MixedLower(method->name());
+  model->field_name = "METHOD_" + upper_name;
+  model->route_field_name = "ROUTE_" + upper_name;
+  model->batch_field_name = "BATCH_METHOD_" + upper_name;
+  model->batch_route_field_name = "BATCH_ROUTE_" + upper_name;
+  model->input_type = google::protobuf::compiler::java::ClassName(method->input_type());
+  model->output_type = google::protobuf::compiler::java::ClassName(method->output_type());
+  model->client_streaming = method->client_streaming();
+  model->server_streaming = method->server_streaming();
+  model->fire_and_forget = options.fire_and_forget();
+  model->chunked_request_field = FindBytesField(method->input_type(), options.chunked_field());
+  model->chunked_response_field = FindBytesField(method->output_type(), options.chunked_field());
+  model->chunked = model->chunked_request_field != NULL || model->chunked_response_field != NULL;
+  model->chunked_field = options.chunked_field();
+  model->chunked_field_name = CapitalizedFieldName(options.chunked_field());
+  if (model->client_streaming || model->chunked_request_field != NULL) {
+    model->kind = REQUEST_CHANNEL;
+  } else if (model->server_streaming || model->chunked_response_field != NULL) {
+    model->kind = REQUEST_STREAM;
+  } else if (model->fire_and_forget) {
+    model->kind = FIRE_AND_FORGET;
+  } else {
+    model->kind = REQUEST_RESPONSE;
+  }
+  model->doc_lines = GetDocLinesForDescriptor(method);
+}
+
+void BuildServiceModel(const ServiceDescriptor* service, ServiceModel* model) {
+  model->descriptor = service;
+  model->name = service->name();
+  model->file_name = service->file()->name();
+  model->java_package = JavaPackage(service->file());
+  model->proto_package = service->file()->package();
+  if (!model->proto_package.empty()) {
+    model->proto_package.append(".");
+  }
+  model->doc_lines = GetDocLinesForDescriptor(service);
+
+  model->methods.resize(service->method_count());
+  model->fire_and_forget.clear();
+  model->request_response.clear();
+  model->request_stream.clear();
+  model->request_channel.clear();
+  for (int i = 0; i < service->method_count(); ++i) {
+    MethodModel* method = &model->methods[i];
+    BuildMethodModel(service->method(i), method);
+    switch (method->kind) {
+      case FIRE_AND_FORGET:
+        model->fire_and_forget.push_back(method);
+        break;
+      case REQUEST_RESPONSE:
+        model->request_response.push_back(method);
+        break;
+      case REQUEST_STREAM:
+        model->request_stream.push_back(method);
+        break;
+      case REQUEST_CHANNEL:
+        model->request_channel.push_back(method);
+        break;
+    }
+  }
+}
+
+bool ValidateService(const ServiceDescriptor* service, string* error) {
+  for (int i = 0; i < service->method_count(); ++i) {
+    const MethodDescriptor* method = service->method(i);
+    const RSocketMethodOptions& options = method->options().GetExtension(io::rsocket::rpc::options);
+    const string& field = options.chunked_field();
+    if (field.empty()) {
+      continue;
+    }
+    if (method->client_streaming() || method->server_streaming() || options.fire_and_forget()) {
+      *error = method->full_name() + ": only request-response methods can be chunked.";
+      return false;
+    }
+    if (FindBytesField(method->input_type(), field) == NULL &&
+        FindBytesField(method->output_type(), field) == NULL) {
+      *error = method->full_name() + ": chunked_field \"" + field +
+               "\" is not a singular bytes field of " + method->input_type()->full_name() +
+               " or " + method->output_type()->full_name() + ".";
+      return false;
+    }
+  }
+  return true;
+}
+
+string JavaPackage(const FileDescriptor* file) {
+  string result = google::protobuf::compiler::java::ClassName(file);
+  size_t last_dot_pos = result.find_last_of('.');
+  if (last_dot_pos != string::npos) {
+    result.resize(last_dot_pos);
+  } else {
+    result = "";
+  }
+  return result;
+}
+
+}  // namespace rsocket_rpc_generator
@@ -0,0 +1,121 @@
+#ifndef RSOCKET_RPC_COMPILER_SERVICE_MODEL_H_
+#define RSOCKET_RPC_COMPILER_SERVICE_MODEL_H_
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+
+namespace rsocket_rpc_generator {
+
+// The RSocket interaction model a method is mapped to.
+enum InteractionKind {
+  FIRE_AND_FORGET, REQUEST_RESPONSE, REQUEST_STREAM, REQUEST_CHANNEL
+};
+
+// Everything the generators need to know about a single method, computed once
+// per service instead of once per generated fragment.
+struct MethodModel {
+  const google::protobuf::MethodDescriptor* descriptor;
+
+  // Name as declared in the proto file, e.g. "RequestReply".
+  std::string name;
+  // JavaBean style method name, e.g. "requestReply".
+  std::string lower_name;
+  // Name of the constant holding the method name, e.g. "METHOD_REQUEST_REPLY".
+  std::string field_name;
+  // Name of the constant holding the route, e.g. "ROUTE_REQUEST_REPLY".
+  std::string route_field_name;
+  // Names of the constants holding the method name and the route batches of a
+  // request-response method are sent as, e.g. "BATCH_METHOD_REQUEST_REPLY".
+  std::string batch_field_name;
+  std::string batch_route_field_name;
+  // Fully qualified Java class names of the request and response messages.
+  std::string input_type;
+  std::string output_type;
+
+  bool client_streaming;
+  bool server_streaming;
+  bool fire_and_forget;
+  // Whether the chunked_field option names a bytes field of the request, the
+  // response or both. These fields are streamed as frames after the rest of
+  // the message; the other field is NULL. A chunked request makes the method a
+  // channel, a chunked response alone a stream.
+  bool chunked;
+  const google::protobuf::FieldDescriptor* chunked_request_field;
+  const google::protobuf::FieldDescriptor* chunked_response_field;
+  // Name of the chunked field in the proto and in its Java accessors, e.g.
+  // "data" and "Data".
+  std::string chunked_field;
+  std::string chunked_field_name;
+  InteractionKind kind;
+
+  // Escaped javadoc lines of the method comment.
+  std::vector<std::string> doc_lines;
+};
+
+// Precomputed view of a service shared by the reactive and blocking
+// generators. Methods keep their declaration order; the per-interaction
+// vectors point into methods, so a model can not be copied.
+struct ServiceModel {
+  ServiceModel() : descriptor(NULL) {}
+
+  const google::protobuf::ServiceDescriptor* descriptor;
+
+  std::string name;
+  // Name of the proto file declaring the service.
+  std::string file_name;
+  // Java package of the generated classes.
+  std::string java_package;
+  // Proto package followed by a dot, or empty for the default package. Used
+  // to fully qualify the service name.
+  std::string proto_package;
+
+  std::vector<std::string> doc_lines;
+
+  std::vector<MethodModel> methods;
+  std::vector<const MethodModel*> fire_and_forget;
+  std::vector<const MethodModel*> request_response;
+  std::vector<const MethodModel*> request_stream;
+  std::vector<const MethodModel*> request_channel;
+
+ private:
+  ServiceModel(const ServiceModel&);
+  ServiceModel& operator=(const ServiceModel&);
+};
+
+// Populates the model of the given service.
+void BuildServiceModel(const google::protobuf::ServiceDescriptor* service,
+                       ServiceModel* model);
+
+// Checks the RSocket options of the methods of the given service. Returns
+// false and describes the first misuse in error if there is one.
+bool ValidateService(const google::protobuf::ServiceDescriptor* service,
+                     std::string* error);
+
+// Returns the Java package of the classes generated for the given file.
+std::string JavaPackage(const google::protobuf::FileDescriptor* file);
+
+// Adjust a method name prefix identifier to follow the JavaBean spec:
+//   - decapitalize the first letter
+//   - remove embedded underscores & capitalize the following letter
+std::string MixedLower(const std::string& word);
+
+// Converts to the identifier to the ALL_UPPER_CASE format.
+//   - An underscore is inserted where a lower case letter is followed by an
+//     upper case letter.
+//   - All letters are converted to upper case
+std::string ToAllUpperCase(const std::string& word);
+
+// Splits the string on any of the delimiter characters, skipping empty parts.
+std::vector<std::string> Split(const std::string& full, const char* delim);
+
+// HTML-escapes the characters that would otherwise break a javadoc comment.
+std::string EscapeJavadoc(const std::string& input);
+
+// Returns the escaped javadoc lines of a comment, without trailing blank lines.
+std::vector<std::string> GetDocLines(const std::string& comments);
+
+}  // namespace rsocket_rpc_generator
+
+#endif  // RSOCKET_RPC_COMPILER_SERVICE_MODEL_H_
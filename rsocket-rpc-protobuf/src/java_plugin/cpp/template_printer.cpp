@@ -0,0 +1,190 @@
+#include "template_printer.h"
+#include "java_generator.h"
+
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace rsocket_rpc_generator {
+
+// Output is handed to the stream once this much has been accumulated.
+static const size_t kFlushThreshold = 64 * 1024;
+
+// The plugin is single threaded, so the registries need no synchronization.
+static std::unordered_map<std::string, int>& SlotsByName() {
+  static std::unordered_map<std::string, int> slots;
+  return slots;
+}
+
+static std::vector<std::string>& SlotNames() {
+  static std::vector<std::string> names;
+  return names;
+}
+
+static std::unordered_map<const char*, Template>& CompiledTemplates() {
+  static std::unordered_map<const char*, Template> templates;
+  return templates;
+}
+
+std::string& Variables::operator[](const std::string& name) {
+  size_t slot = Slot(name);
+  if (slot >= values_.size()) {
+    values_.resize(SlotNames().size());
+    defined_.resize(SlotNames().size(), false);
+  }
+  defined_[slot] = true;
+  return values_[slot];
+}
+
+int Variables::Slot(const std::string& name) {
+  std::unordered_map<std::string, int>& slots = SlotsByName();
+  std::unordered_map<std::string, int>::const_iterator it = slots.find(name);
+  if (it != slots.end()) {
+    return it->second;
+  }
+  int slot = static_cast<int>(SlotNames().size());
+  SlotNames().push_back(name);
+  slots[name] = slot;
+  return slot;
+}
+
+const std::string& Variables::Name(int slot) {
+  return SlotNames()[slot];
+}
+
+static void AddText(Template* compiled, const char* text, size_t size, bool ends_line) {
+  if (size == 0) {
+    return;
+  }
+  Template::Segment segment = { text, size, -1, ends_line };
+  compiled->segments.push_back(segment);
+}
+
+static void CompileTemplate(const char* text, size_t size, char delimiter, Template* compiled) {
+  compiled->delimiter = delimiter;
+  size_t pos = 0;
+  for (size_t i = 0; i < size; i++) {
+    if (text[i] == '\n') {
+      AddText(compiled, text + pos, i - pos + 1, true);
+      pos = i + 1;
+    } else if (text[i] == delimiter) {
+      AddText(compiled, text + pos, i - pos, false);
+      const char* end = static_cast<const char*>(memchr(text + i + 1, delimiter, size - i - 1));
+      RSOCKET_RPC_CODEGEN_CHECK(end != NULL) << "Unclosed variable name in: " << text;
+      size_t end_pos = end - text;
+      if (end_pos == i + 1) {
+        // Two delimiters in a row reflect a literal delimiter.
+        AddText(compiled, text + i, 1, false);
+      } else {
+        Template::Segment segment = {
+          NULL, 0, Variables::Slot(std::string(text + i + 1, end_pos - i - 1)), false
+        };
+        compiled->segments.push_back(segment);
+      }
+      i = end_pos;
+      pos = end_pos + 1;
+    }
+  }
+  AddText(compiled, text + pos, size - pos, false);
+}
+
+Printer::Printer(google::protobuf::io::ZeroCopyOutputStream* output, char delimiter)
+    : output_(output), delimiter_(delimiter), at_start_of_line_(true), failed_(false) {
+  buffer_.reserve(kFlushThreshold + 4096);
+}
+
+Printer::~Printer() {
+  Flush();
+}
+
+void Printer::Indent() {
+  indent_ += "  ";
+}
+
+void Printer::Outdent() {
+  RSOCKET_RPC_CODEGEN_CHECK(!indent_.empty()) << "Outdent() without matching Indent().";
+  indent_.resize(indent_.size() - 2);
+}
+
+const Template& Printer::Compile(const char* text, size_t size) {
+  Template& compiled = CompiledTemplates()[text];
+  if (compiled.segments.empty() || compiled.delimiter != delimiter_) {
+    compiled.segments.clear();
+    CompileTemplate(text, size, delimiter_, &compiled);
+  }
+  return compiled;
+}
+
+void Printer::Render(const Template& compiled, const Variables& vars) {
+  for (size_t i = 0; i < compiled.segments.size(); i++) {
+    const Template::Segment& segment = compiled.segments[i];
+    if (segment.slot < 0) {
+      Write(segment.text, segment.size);
+      if (segment.ends_line) {
+        at_start_of_line_ = true;
+      }
+    } else {
+      WriteVariable(segment.slot, vars.Find(segment.slot));
+    }
+  }
+}
+
+void Printer::Render(const Template& compiled, int slot, const std::string& value) {
+  for (size_t i = 0; i < compiled.segments.size(); i++) {
+    const Template::Segment& segment = compiled.segments[i];
+    if (segment.slot < 0) {
+      Write(segment.text, segment.size);
+      if (segment.ends_line) {
+        at_start_of_line_ = true;
+      }
+    } else {
+      WriteVariable(segment.slot, segment.slot == slot ? &value : NULL);
+    }
+  }
+}
+
+void Printer::WriteVariable(int slot, const std::string* value) {
+  RSOCKET_RPC_CODEGEN_CHECK(value != NULL) << "Undefined variable: " << Variables::Name(slot);
+  Write(value->data(), value->size());
+}
+
+void Printer::Write(const char* data, size_t size) {
+  if (size == 0) {
+    return;
+  }
+  if (at_start_of_line_ && data[0] != '\n') {
+    at_start_of_line_ = false;
+    buffer_.append(indent_);
+  }
+  buffer_.append(data, size);
+  if (buffer_.size() >= kFlushThreshold) {
+    Flush();
+  }
+}
+
+void Printer::Flush() {
+  if (failed_) {
+    buffer_.clear();
+    return;
+  }
+  const char* data = buffer_.data();
+  size_t remaining = buffer_.size();
+  while (remaining > 0) {
+    void* chunk;
+    int chunk_size;
+    if (!output_->Next(&chunk, &chunk_size)) {
+      failed_ = true;
+      break;
+    }
+    size_t copied = std::min(remaining, static_cast<size_t>(chunk_size));
+    memcpy(chunk, data, copied);
+    data += copied;
+    remaining -= copied;
+    if (copied < static_cast<size_t>(chunk_size)) {
+      output_->BackUp(static_cast<int>(chunk_size - copied));
+    }
+  }
+  buffer_.clear();
+}
+
+}  // namespace rsocket_rpc_generator
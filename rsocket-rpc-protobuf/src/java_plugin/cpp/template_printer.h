@@ -0,0 +1,111 @@
+#ifndef RSOCKET_RPC_COMPILER_TEMPLATE_PRINTER_H_
+#define RSOCKET_RPC_COMPILER_TEMPLATE_PRINTER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+namespace rsocket_rpc_generator {
+
+// Template variables. Every variable name is assigned a process wide slot the
+// first time it is seen, so compiled templates refer to variables by index
+// and rendering never looks a name up.
+class Variables {
+ public:
+  // Returns the value of the named variable, defining it if needed.
+  std::string& operator[](const std::string& name);
+
+  // Returns the value stored in the given slot, or NULL if it is not defined.
+  const std::string* Find(int slot) const {
+    return static_cast<size_t>(slot) < defined_.size() && defined_[slot] ? &values_[slot] : NULL;
+  }
+
+  // Returns the slot of the named variable, registering it if needed.
+  static int Slot(const std::string& name);
+
+  // Returns the name registered for the given slot.
+  static const std::string& Name(int slot);
+
+ private:
+  std::vector<std::string> values_;
+  std::vector<bool> defined_;
+};
+
+// A template split into literal text and variable references. Literal
+// segments end either before a variable or right after a newline, which is
+// where the printer has to decide whether to indent.
+struct Template {
+  struct Segment {
+    const char* text;
+    size_t size;
+    // Slot of the referenced variable, or -1 for literal text.
+    int slot;
+    bool ends_line;
+  };
+
+  char delimiter;
+  std::vector<Segment> segments;
+};
+
+// Drop-in replacement for google::protobuf::io::Printer as used by the
+// generators. Templates passed as string literals are compiled once per
+// process and cached by address; output is accumulated in a single buffer
+// and copied to the stream in large chunks.
+//
+// Indentation follows the protobuf printer: the indent is written before the
+// first non-empty output of a line unless that output starts with a newline,
+// and two consecutive delimiters print a literal delimiter.
+class Printer {
+ public:
+  Printer(google::protobuf::io::ZeroCopyOutputStream* output, char delimiter);
+  ~Printer();
+
+  template <size_t N>
+  void Print(const Variables& vars, const char (&text)[N]) {
+    Render(Compile(text, N - 1), vars);
+  }
+
+  template <size_t N>
+  void Print(const char (&text)[N]) {
+    Render(Compile(text, N - 1), Variables());
+  }
+
+  template <size_t N>
+  void Print(const char (&text)[N], const char* name, const std::string& value) {
+    Render(Compile(text, N - 1), Variables::Slot(name), value);
+  }
+
+  // Indents the following lines by two more spaces.
+  void Indent();
+
+  // Reverts the last Indent().
+  void Outdent();
+
+  // Copies the buffered output to the stream. The destructor flushes as
+  // well, callers only need this to check failed() before the printer dies.
+  void Flush();
+
+  // True if the stream refused to accept output, in which case whatever was
+  // printed since is dropped, as with protobuf's io::Printer.
+  bool failed() const { return failed_; }
+
+ private:
+  const Template& Compile(const char* text, size_t size);
+  void Render(const Template& compiled, const Variables& vars);
+  void Render(const Template& compiled, int slot, const std::string& value);
+  void WriteVariable(int slot, const std::string* value);
+  void Write(const char* data, size_t size);
+
+  google::protobuf::io::ZeroCopyOutputStream* const output_;
+  const char delimiter_;
+  std::string buffer_;
+  std::string indent_;
+  bool at_start_of_line_;
+  bool failed_;
+};
+
+}  // namespace rsocket_rpc_generator
+
+#endif  // RSOCKET_RPC_COMPILER_TEMPLATE_PRINTER_H_
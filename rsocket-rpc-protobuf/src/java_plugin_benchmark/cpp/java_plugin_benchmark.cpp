@@ -0,0 +1,386 @@
+// Measures the speed of the Java generators on synthetic services.
+//
+// The benchmark builds a descriptor pool in memory, so no .proto files or
+// protoc invocation are involved, and renders every generated class into a
+// stream that only counts bytes. Example:
+//
+//   java_plugin_benchmark --services=1000 --methods=50 --comment-lines=20
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include "blocking_java_generator.h"
+#include "java_generator.h"
+#include "rsocket/options.pb.h"
+#include "service_model.h"
+
+using google::protobuf::DescriptorPool;
+using google::protobuf::FileDescriptor;
+using google::protobuf::FileDescriptorProto;
+
+namespace {
+
+struct BenchmarkOptions {
+  BenchmarkOptions()
+      : services(100), methods(20), package_depth(3), comment_lines(5), iterations(3), lite(false) {}
+
+  int services;
+  int methods;
+  int package_depth;
+  int comment_lines;
+  int iterations;
+  bool lite;
+};
+
+// Discards everything written to it, keeping only the byte count.
+class NullOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  NullOutputStream() : bytes_(0) {}
+
+  bool Next(void** data, int* size) {
+    *data = buffer_;
+    *size = sizeof(buffer_);
+    bytes_ += sizeof(buffer_);
+    return true;
+  }
+
+  void BackUp(int count) {
+    bytes_ -= count;
+  }
+
+  google::protobuf::int64 ByteCount() const {
+    return bytes_;
+  }
+
+ private:
+  char buffer_[8192];
+  google::protobuf::int64 bytes_;
+};
+
+struct Phase {
+  Phase(const string& name) : name(name), nanos(0), bytes(0) {}
+
+  string name;
+  int64_t nanos;
+  int64_t bytes;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+int64_t NanosSince(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+bool ParseIntFlag(const char* arg, const char* name, int min, int max, int* value) {
+  size_t length = strlen(name);
+  if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+    return false;
+  }
+  int parsed = atoi(arg + length + 1);
+  if (parsed < min || parsed > max) {
+    std::cerr << name << " must be between " << min << " and " << max << std::endl;
+    exit(1);
+  }
+  *value = parsed;
+  return true;
+}
+
+void PrintUsage() {
+  std::cerr << "usage: java_plugin_benchmark [--services=1..10000] [--methods=1..1000]\n"
+            << "                             [--package-depth=1..64] [--comment-lines=0..1000]\n"
+            << "                             [--iterations=1..1000] [--lite]" << std::endl;
+}
+
+BenchmarkOptions ParseOptions(int argc, char* argv[]) {
+  BenchmarkOptions options;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (ParseIntFlag(arg, "--services", 1, 10000, &options.services) ||
+        ParseIntFlag(arg, "--methods", 1, 1000, &options.methods) ||
+        ParseIntFlag(arg, "--package-depth", 1, 64, &options.package_depth) ||
+        ParseIntFlag(arg, "--comment-lines", 0, 1000, &options.comment_lines) ||
+        ParseIntFlag(arg, "--iterations", 1, 1000, &options.iterations)) {
+      continue;
+    }
+    if (strcmp(arg, "--lite") == 0) {
+      options.lite = true;
+      continue;
+    }
+    PrintUsage();
+    exit(strcmp(arg, "--help") == 0 ? 0 : 1);
+  }
+  return options;
+}
+
+// A comment long enough to be split into several lines and containing every
+// character EscapeJavadoc has to replace.
+string Comment(const string& subject, int lines) {
+  std::ostringstream comment;
+  for (int i = 0; i < lines; i++) {
+    comment << " Line " << i << " of the documentation of " << subject
+            << ": a/*nested*/ comment, an @tag, <b>html</b> & a \\u0041 escape.\n";
+  }
+  return comment.str();
+}
+
+void AddComment(FileDescriptorProto* file, int service, int method, const string& comment) {
+  google::protobuf::SourceCodeInfo::Location* location =
+      file->mutable_source_code_info()->add_location();
+  location->add_path(FileDescriptorProto::kServiceFieldNumber);
+  location->add_path(service);
+  if (method >= 0) {
+    location->add_path(google::protobuf::ServiceDescriptorProto::kMethodFieldNumber);
+    location->add_path(method);
+  }
+  location->add_span(service);
+  location->add_span(0);
+  location->add_span(1);
+  location->set_leading_comments(comment);
+}
+
+// Builds a file with the requested number of services. Methods cycle through
+// all interaction models so every code path of the generators is exercised.
+FileDescriptorProto SyntheticFile(const BenchmarkOptions& options) {
+  FileDescriptorProto file;
+  file.set_name("benchmark/synthetic.proto");
+  file.set_syntax("proto3");
+  file.add_dependency("rsocket/options.proto");
+
+  string package = "io.rsocket.rpc.benchmark";
+  for (int i = 0; i < options.package_depth; i++) {
+    std::ostringstream segment;
+    segment << ".level" << i;
+    package += segment.str();
+  }
+  file.set_package(package);
+  file.mutable_options()->set_java_package(package + ".protobuf");
+  file.mutable_options()->set_java_multiple_files(true);
+
+  const char* messages[] = { "BenchmarkRequest", "BenchmarkResponse" };
+  for (int i = 0; i < 2; i++) {
+    google::protobuf::DescriptorProto* message = file.add_message_type();
+    message->set_name(messages[i]);
+    google::protobuf::FieldDescriptorProto* field = message->add_field();
+    field->set_name("payload");
+    field->set_number(1);
+    field->set_type(google::protobuf::FieldDescriptorProto::TYPE_BYTES);
+    field->set_label(google::protobuf::FieldDescriptorProto::LABEL_OPTIONAL);
+  }
+
+  for (int s = 0; s < options.services; s++) {
+    google::protobuf::ServiceDescriptorProto* service = file.add_service();
+    std::ostringstream service_name;
+    service_name << "BenchmarkService" << s;
+    service->set_name(service_name.str());
+    if (options.comment_lines > 0) {
+      AddComment(&file, s, -1, Comment(service_name.str(), options.comment_lines));
+    }
+
+    for (int m = 0; m < options.methods; m++) {
+      google::protobuf::MethodDescriptorProto* method = service->add_method();
+      std::ostringstream method_name;
+      method_name << "Benchmark_methodCall" << m;
+      method->set_name(method_name.str());
+      method->set_input_type("." + package + ".BenchmarkRequest");
+      method->set_output_type("." + package + ".BenchmarkResponse");
+      switch (m % 5) {
+        case 1: {
+          io::rsocket::rpc::RSocketMethodOptions rsocket_options;
+          rsocket_options.set_fire_and_forget(true);
+          *method->mutable_options()->MutableExtension(io::rsocket::rpc::options) = rsocket_options;
+          break;
+        }
+        case 2:
+          method->set_server_streaming(true);
+          break;
+        case 3:
+          method->set_client_streaming(true);
+          break;
+        case 4:
+          method->set_client_streaming(true);
+          method->set_server_streaming(true);
+          break;
+      }
+      if (options.comment_lines > 0) {
+        AddComment(&file, s, m, Comment(method_name.str(), options.comment_lines));
+      }
+    }
+  }
+  return file;
+}
+
+const FileDescriptor* BuildFile(DescriptorPool* pool, const FileDescriptor* generated) {
+  FileDescriptorProto proto;
+  generated->CopyTo(&proto);
+  return pool->BuildFile(proto);
+}
+
+string FormatBytes(double bytes) {
+  const char* units[] = { "B", "KiB", "MiB", "GiB" };
+  int unit = 0;
+  while (bytes >= 1024 && unit < 3) {
+    bytes /= 1024;
+    unit++;
+  }
+  std::ostringstream formatted;
+  formatted << std::fixed << std::setprecision(1) << bytes << " " << units[unit];
+  return formatted.str();
+}
+
+// Peak resident set size of the process in bytes, or -1 if unknown.
+int64_t PeakRss() {
+#ifdef _WIN32
+  return -1;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+template <typename Generate>
+void RunPhase(Phase* phase, const std::vector<rsocket_rpc_generator::ServiceModel*>& models,
+              Generate generate) {
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < models.size(); i++) {
+    NullOutputStream out;
+    generate(*models[i], &out);
+    phase->bytes += out.ByteCount();
+  }
+  phase->nanos += NanosSince(start);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  BenchmarkOptions options = ParseOptions(argc, argv);
+  java_rsocket_rpc_generator::ProtoFlavor flavor = options.lite ?
+      java_rsocket_rpc_generator::LITE : java_rsocket_rpc_generator::NORMAL;
+  blocking_java_rsocket_rpc_generator::ProtoFlavor blocking_flavor = options.lite ?
+      blocking_java_rsocket_rpc_generator::LITE : blocking_java_rsocket_rpc_generator::NORMAL;
+
+  std::vector<Phase> phases;
+  phases.push_back(Phase("descriptors"));
+  phases.push_back(Phase("model"));
+  phases.push_back(Phase("interface"));
+  phases.push_back(Phase("client"));
+  phases.push_back(Phase("server"));
+  phases.push_back(Phase("blocking interface"));
+  phases.push_back(Phase("blocking client"));
+  phases.push_back(Phase("blocking server"));
+
+  Clock::time_point start = Clock::now();
+  FileDescriptorProto synthetic = SyntheticFile(options);
+  DescriptorPool pool;
+  BuildFile(&pool, google::protobuf::FileDescriptorProto::descriptor()->file());
+  BuildFile(&pool, io::rsocket::rpc::RSocketMethodOptions::descriptor()->file());
+  const FileDescriptor* file = pool.BuildFile(synthetic);
+  if (file == NULL) {
+    std::cerr << "failed to build the synthetic descriptor pool" << std::endl;
+    return 1;
+  }
+  phases[0].nanos = NanosSince(start);
+
+  for (int iteration = 0; iteration < options.iterations; iteration++) {
+    std::vector<rsocket_rpc_generator::ServiceModel*> models;
+    Clock::time_point model_start = Clock::now();
+    for (int i = 0; i < file->service_count(); i++) {
+      rsocket_rpc_generator::ServiceModel* model = new rsocket_rpc_generator::ServiceModel();
+      rsocket_rpc_generator::BuildServiceModel(file->service(i), model);
+      models.push_back(model);
+    }
+    phases[1].nanos += NanosSince(model_start);
+
+    RunPhase(&phases[2], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      java_rsocket_rpc_generator::GenerateInterface(model, out, flavor, false, false);
+    });
+    RunPhase(&phases[3], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      java_rsocket_rpc_generator::GenerateClient(model, out, flavor, false);
+    });
+    RunPhase(&phases[4], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      java_rsocket_rpc_generator::GenerateServer(model, out, flavor, false, false);
+    });
+    RunPhase(&phases[5], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      blocking_java_rsocket_rpc_generator::GenerateInterface(model, out, blocking_flavor, false);
+    });
+    RunPhase(&phases[6], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      blocking_java_rsocket_rpc_generator::GenerateClient(model, out, blocking_flavor, false);
+    });
+    RunPhase(&phases[7], models, [&](const rsocket_rpc_generator::ServiceModel& model,
+                                     google::protobuf::io::ZeroCopyOutputStream* out) {
+      blocking_java_rsocket_rpc_generator::GenerateServer(model, out, blocking_flavor, false);
+    });
+
+    for (size_t i = 0; i < models.size(); i++) {
+      delete models[i];
+    }
+  }
+
+  int64_t methods = static_cast<int64_t>(options.services) * options.methods;
+  std::cout << "services=" << options.services << " methods/service=" << options.methods
+            << " package-depth=" << options.package_depth
+            << " comment-lines=" << options.comment_lines
+            << " iterations=" << options.iterations
+            << (options.lite ? " flavor=lite" : " flavor=normal") << "\n\n";
+  std::cout << std::left << std::setw(20) << "phase" << std::right
+            << std::setw(12) << "ms/iter" << std::setw(14) << "output/iter"
+            << std::setw(14) << "MiB/s" << std::setw(16) << "methods/s" << "\n";
+
+  int64_t total_nanos = 0;
+  int64_t total_bytes = 0;
+  for (size_t i = 0; i < phases.size(); i++) {
+    const Phase& phase = phases[i];
+    // Descriptors are built once, everything else once per iteration.
+    int runs = i == 0 ? 1 : options.iterations;
+    double seconds = phase.nanos / 1e9 / runs;
+    total_nanos += phase.nanos / runs;
+    total_bytes += phase.bytes / runs;
+    std::cout << std::left << std::setw(20) << phase.name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(2) << seconds * 1e3
+              << std::setw(14) << (phase.bytes > 0 ? FormatBytes(phase.bytes / runs) : "-")
+              << std::setw(14) << std::setprecision(1)
+              << (seconds > 0 ? phase.bytes / runs / seconds / (1024 * 1024) : 0)
+              << std::setw(16) << std::setprecision(0) << (seconds > 0 ? methods / seconds : 0)
+              << "\n";
+  }
+
+  double total_seconds = total_nanos / 1e9;
+  std::cout << std::left << std::setw(20) << "total" << std::right << std::fixed
+            << std::setw(12) << std::setprecision(2) << total_seconds * 1e3
+            << std::setw(14) << FormatBytes(total_bytes)
+            << std::setw(14) << std::setprecision(1)
+            << total_bytes / total_seconds / (1024 * 1024)
+            << std::setw(16) << std::setprecision(0) << methods / total_seconds << "\n\n";
+
+  int64_t peak_rss = PeakRss();
+  std::cout << "peak rss: " << (peak_rss < 0 ? string("unknown") : FormatBytes(peak_rss))
+            << std::endl;
+  return 0;
+}